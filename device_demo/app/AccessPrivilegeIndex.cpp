@@ -0,0 +1,151 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "AccessPrivilegeIndex.h"
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <app/util/privilege-storage.h>
+
+#include <zap-generated/access.h>
+
+using namespace chip;
+using chip::Access::Privilege;
+
+namespace {
+
+// The kMatterAccessPrivilege* values of the generated tables, as AccessControl::Check takes them.
+constexpr Privilege ToPrivilege(int privilege)
+{
+    switch (privilege)
+    {
+    case kMatterAccessPrivilegeProxyView:
+        return Privilege::kProxyView;
+    case kMatterAccessPrivilegeOperate:
+        return Privilege::kOperate;
+    case kMatterAccessPrivilegeManage:
+        return Privilege::kManage;
+    case kMatterAccessPrivilegeAdminister:
+        return Privilege::kAdminister;
+    default:
+        return Privilege::kView;
+    }
+}
+
+constexpr uint64_t PathKey(uint32_t cluster, uint32_t id)
+{
+    return (static_cast<uint64_t>(cluster) << 32) | id;
+}
+
+template <size_t N>
+struct PrivilegeTable
+{
+    uint64_t keys[N];
+    Privilege privileges[N];
+};
+
+// Packs one set of generated parallel arrays into a table sorted by path key.
+template <size_t N>
+constexpr PrivilegeTable<N> MakePrivilegeTable(const uint32_t (&clusters)[N], const uint32_t (&ids)[N], const int (&privileges)[N])
+{
+    PrivilegeTable<N> table{};
+    for (size_t i = 0; i < N; i++)
+    {
+        const uint64_t key = PathKey(clusters[i], ids[i]);
+        size_t j           = i;
+        for (; j > 0 && table.keys[j - 1] > key; j--)
+        {
+            table.keys[j]       = table.keys[j - 1];
+            table.privileges[j] = table.privileges[j - 1];
+        }
+        table.keys[j]       = key;
+        table.privileges[j] = ToPrivilege(privileges[i]);
+    }
+    return table;
+}
+
+template <size_t N>
+constexpr bool HasUniqueKeys(const PrivilegeTable<N> & table)
+{
+    for (size_t i = 1; i < N; i++)
+    {
+        if (table.keys[i - 1] == table.keys[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+Privilege Lookup(const PrivilegeTable<N> & table, uint32_t cluster, uint32_t id, Privilege defaultPrivilege)
+{
+    const uint64_t key     = PathKey(cluster, id);
+    const uint64_t * end   = table.keys + N;
+    const uint64_t * match = std::lower_bound(table.keys, end, key);
+    return (match != end && *match == key) ? table.privileges[match - table.keys] : defaultPrivilege;
+}
+
+constexpr uint32_t kReadAttributeClusters[]    = GENERATED_ACCESS_READ_ATTRIBUTE__CLUSTER;
+constexpr uint32_t kReadAttributeAttributes[]  = GENERATED_ACCESS_READ_ATTRIBUTE__ATTRIBUTE;
+constexpr int kReadAttributePrivileges[]       = GENERATED_ACCESS_READ_ATTRIBUTE__PRIVILEGE;
+constexpr uint32_t kWriteAttributeClusters[]   = GENERATED_ACCESS_WRITE_ATTRIBUTE__CLUSTER;
+constexpr uint32_t kWriteAttributeAttributes[] = GENERATED_ACCESS_WRITE_ATTRIBUTE__ATTRIBUTE;
+constexpr int kWriteAttributePrivileges[]      = GENERATED_ACCESS_WRITE_ATTRIBUTE__PRIVILEGE;
+constexpr uint32_t kInvokeCommandClusters[]    = GENERATED_ACCESS_INVOKE_COMMAND__CLUSTER;
+constexpr uint32_t kInvokeCommandCommands[]    = GENERATED_ACCESS_INVOKE_COMMAND__COMMAND;
+constexpr int kInvokeCommandPrivileges[]       = GENERATED_ACCESS_INVOKE_COMMAND__PRIVILEGE;
+constexpr uint32_t kReadEventClusters[]        = GENERATED_ACCESS_READ_EVENT__CLUSTER;
+constexpr uint32_t kReadEventEvents[]          = GENERATED_ACCESS_READ_EVENT__EVENT;
+constexpr int kReadEventPrivileges[]           = GENERATED_ACCESS_READ_EVENT__PRIVILEGE;
+
+constexpr auto kReadAttributeTable =
+    MakePrivilegeTable(kReadAttributeClusters, kReadAttributeAttributes, kReadAttributePrivileges);
+constexpr auto kWriteAttributeTable =
+    MakePrivilegeTable(kWriteAttributeClusters, kWriteAttributeAttributes, kWriteAttributePrivileges);
+constexpr auto kInvokeCommandTable = MakePrivilegeTable(kInvokeCommandClusters, kInvokeCommandCommands, kInvokeCommandPrivileges);
+constexpr auto kReadEventTable     = MakePrivilegeTable(kReadEventClusters, kReadEventEvents, kReadEventPrivileges);
+
+static_assert(HasUniqueKeys(kReadAttributeTable), "Duplicate read attribute path in access.h");
+static_assert(HasUniqueKeys(kWriteAttributeTable), "Duplicate write attribute path in access.h");
+static_assert(HasUniqueKeys(kInvokeCommandTable), "Duplicate invoke command path in access.h");
+static_assert(HasUniqueKeys(kReadEventTable), "Duplicate read event path in access.h");
+
+} // namespace
+
+Privilege AccessPrivilegeIndex::ForReadAttribute(ClusterId cluster, AttributeId attribute)
+{
+    return Lookup(kReadAttributeTable, cluster, attribute, Privilege::kView);
+}
+
+Privilege AccessPrivilegeIndex::ForWriteAttribute(ClusterId cluster, AttributeId attribute)
+{
+    return Lookup(kWriteAttributeTable, cluster, attribute, Privilege::kOperate);
+}
+
+Privilege AccessPrivilegeIndex::ForInvokeCommand(ClusterId cluster, CommandId command)
+{
+    return Lookup(kInvokeCommandTable, cluster, command, Privilege::kOperate);
+}
+
+Privilege AccessPrivilegeIndex::ForReadEvent(ClusterId cluster, EventId event)
+{
+    return Lookup(kReadEventTable, cluster, event, Privilege::kView);
+}
@@ -0,0 +1,40 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <access/Privilege.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Required-privilege queries over the tables in zap-generated/access.h.
+ *
+ * The generated parallel (cluster, id, privilege) arrays are packed at compile time into sorted
+ * 64-bit path keys, so each query is a binary search instead of a scan of every entry. Results
+ * are ready for AccessControl::Check, with the same defaults as the generated tables: view for
+ * reads, operate for writes and invokes. SceneRecallHandler checks the endpoints of a group
+ * recall with it.
+ */
+class AccessPrivilegeIndex
+{
+public:
+    static chip::Access::Privilege ForReadAttribute(chip::ClusterId cluster, chip::AttributeId attribute);
+    static chip::Access::Privilege ForWriteAttribute(chip::ClusterId cluster, chip::AttributeId attribute);
+    static chip::Access::Privilege ForInvokeCommand(chip::ClusterId cluster, chip::CommandId command);
+    static chip::Access::Privilege ForReadEvent(chip::ClusterId cluster, chip::EventId event);
+};
@@ -19,6 +19,7 @@
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/PlatformManager.h>
 
+#include <app-common/zap-generated/ids/Clusters.h>
 #include <app/clusters/network-commissioning/network-commissioning.h>
 #include <app/server/OnboardingCodesUtil.h>
 #include <app/server/Server.h>
@@ -41,6 +42,8 @@
 
 #include <platform/CommissionableDataProvider.h>
 #include <platform/DiagnosticDataProvider.h>
+#include <platform/KeyValueStoreManager.h>
+#include <platform/KvsPersistentStorageDelegate.h>
 
 #include <DeviceInfoProviderImpl.h>
 
@@ -48,9 +51,30 @@
 
 #include <signal.h>
 
+#include <thread>
+
 #include "AppMain.h"
 #include "CommissionableInit.h"
+#include "DynamicEndpointManager.h"
+#include "EncodedAttributeCache.h"
+#include "FactoryData.h"
+#include "GroupEndpointIndex.h"
+#include "IdentifyEffectEngine.h"
+#include "LazyClusterInit.h"
+#include "LevelControlCommandHandler.h"
 #include "LightDeviceInfoProvider.h"
+#include "LightDriver.h"
+#include "LightSinks.h"
+#include "LightStatePersistence.h"
+#include "LogStructuredStorage.h"
+#include "OnOffGroupHandler.h"
+#include "Options.h"
+#include "ReportCoalescer.h"
+#include "SceneRecallHandler.h"
+#include "StartupProfiler.h"
+#include "UserLabelServer.h"
+#include "WriteBehindStorageDelegate.h"
+#include "WriteSkippingStorageDelegate.h"
 
 using namespace chip;
 using namespace chip::Credentials;
@@ -60,11 +84,110 @@ using namespace chip::Transport;
 using namespace chip::app::Clusters;
 
 namespace {
+// Optional manufacturing-time image, mapped for the lifetime of the process
+FactoryData gFactoryData;
+FactoryDataDacProvider gFactoryDataDacProvider(gFactoryData);
+
 // To hold SPAKE2+ verifier, discriminator, passcode
 DeviceCommissionableDataProvider gCommissionableDataProvider;
 
 LightDeviceInfoProvider gLightDeviceInfoProvider;
 
+// Every subscriber of the light reports these, so they are encoded once per data version.
+EncodedAttributeCache gOnOffReportCache(LightDriver::kEndpoint, OnOff::Id);
+EncodedAttributeCache gLevelControlReportCache(LightDriver::kEndpoint, LevelControl::Id);
+
+// Replaces the GroupDataProvider of CommonCaseDeviceServerInitParams so group invokes resolve
+// their endpoints from memory.
+GroupEndpointIndex gGroupDataProvider;
+
+// Server storage: the backend selected by --kvs-backend, optionally behind a write-behind
+// queue (--kvs-write-behind), behind a layer that drops unchanged rewrites.
+KvsPersistentStorageDelegate gKvsPersistentStorage;
+LogStructuredStorage gLogStructuredStorage;
+WriteBehindStorageDelegate gWriteBehindStorage;
+WriteSkippingStorageDelegate gServerStorage;
+
+CHIP_ERROR InitServerStorage()
+{
+    const LinuxDeviceOptions & options  = LinuxDeviceOptions::GetInstance();
+    PersistentStorageDelegate * backend = nullptr;
+
+    if (options.kvsBackend == LinuxDeviceOptions::KvsBackend::kLog)
+    {
+        ReturnErrorOnFailure(gLogStructuredStorage.Init((options.KVS != nullptr) ? options.KVS : CHIP_DEVICE_KVS_LOG_PATH));
+        backend = &gLogStructuredStorage;
+    }
+    else
+    {
+        ReturnErrorOnFailure(gKvsPersistentStorage.Init(&DeviceLayer::PersistedStorage::KeyValueStoreMgr()));
+        backend = &gKvsPersistentStorage;
+    }
+
+    if (options.kvsWriteBehind)
+    {
+        ReturnErrorOnFailure(gWriteBehindStorage.Init(backend));
+        backend = &gWriteBehindStorage;
+    }
+
+    return gServerStorage.Init(backend);
+}
+
+// The PASE verifier computation does not depend on the rest of the stack bring-up, so it runs
+// on a worker thread. The worker is joined exactly once, right before Server::Init.
+std::thread gCommissionableDataWorker;
+CHIP_ERROR gCommissionableDataError = CHIP_NO_ERROR;
+
+void StartCommissionableDataWorker()
+{
+    gCommissionableDataWorker = std::thread([] {
+        StartupProfiler::ScopedPhase phase("CommissionableData");
+        // Init the commissionable data provider based on command line options
+        // to handle custom verifiers, discriminators, etc.
+        gCommissionableDataError = InitCommissionableDataProvider(gCommissionableDataProvider, gFactoryData);
+    });
+}
+
+CHIP_ERROR JoinCommissionableDataWorker()
+{
+    if (gCommissionableDataWorker.joinable())
+    {
+        gCommissionableDataWorker.join();
+    }
+    return gCommissionableDataError;
+}
+
+System::Clock::Microseconds64 gEventLoopStart;
+
+// Number of slowest plugin/cluster init callbacks listed in the startup report.
+constexpr size_t kInitReportEntries = 10;
+
+// Scheduled before the event loop starts, so it runs as part of its first iteration and closes
+// the startup timeline.
+void OnFirstEventLoopIteration(intptr_t arg)
+{
+    (void) arg;
+    StartupProfiler & profiler = StartupProfiler::GetInstance();
+    profiler.Record("FirstEventLoopIteration", gEventLoopStart, StartupProfiler::Now());
+    profiler.Stop();
+    profiler.LogSummary();
+    profiler.LogInitReport(kInitReportEntries);
+
+    ChipLogProgress(NotSpecified, "Storage writes during startup: %u forwarded, %u skipped (unchanged)",
+                    static_cast<unsigned>(gServerStorage.GetForwardedWriteCount()),
+                    static_cast<unsigned>(gServerStorage.GetAvoidedWriteCount()));
+
+    const char * timelinePath = LinuxDeviceOptions::GetInstance().startupTimeline;
+    if (timelinePath != nullptr)
+    {
+        CHIP_ERROR err = profiler.WriteTimeline(timelinePath);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to write startup timeline: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+}
+
 void EventHandler(const DeviceLayer::ChipDeviceEvent * event, intptr_t arg)
 {
     (void) arg;
@@ -72,10 +195,26 @@ void EventHandler(const DeviceLayer::ChipDeviceEvent * event, intptr_t arg)
     {
         ChipLogProgress(DeviceLayer, "Receive kCHIPoBLEConnectionEstablished");
     }
+    else if (event->Type == DeviceLayer::DeviceEventType::kCommissioningComplete ||
+             event->Type == DeviceLayer::DeviceEventType::kFailSafeTimerExpired ||
+             event->Type == DeviceLayer::DeviceEventType::kOperationalNetworkEnabled)
+    {
+        // The fail-safe has just been committed or rolled back, or the network configuration
+        // changed: make whatever else was written alongside it durable too.
+        CHIP_ERROR err = gWriteBehindStorage.Flush();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DeviceLayer, "Failed to flush storage after event 0x%x: %" CHIP_ERROR_FORMAT,
+                         static_cast<unsigned>(event->Type), err.Format());
+        }
+    }
 }
 
 void Cleanup()
 {
+    JoinCommissionableDataWorker();
+    gWriteBehindStorage.Shutdown();
+    gLogStructuredStorage.Shutdown();
 
     // TODO(16968): Lifecycle management of storage-using components like GroupDataProvider, etc
 }
@@ -87,34 +226,53 @@ int ChipLinuxAppInit(int argc, char * const argv[])
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    RendezvousInformationFlag rendezvousFlags = RendezvousInformationFlag::kOnNetwork;
-    chip::PayloadContents payload;
-
-    err = Platform::MemoryInit();
+    {
+        StartupProfiler::ScopedPhase phase("MemoryInit");
+        err = Platform::MemoryInit();
+    }
     SuccessOrExit(err);
 
-    err = DeviceLayer::PlatformMgr().InitChipStack();
+    err = ParseArguments(argc, argv);
     SuccessOrExit(err);
 
-    // Init the commissionable data provider based on command line options
-    // to handle custom verifiers, discriminators, etc.
-    err = InitCommissionableDataProvider(gCommissionableDataProvider);
+    {
+        // With --kvs-backend log, --KVS names the log and the platform store keeps its default file.
+        const LinuxDeviceOptions & options = LinuxDeviceOptions::GetInstance();
+        const bool fileBackend             = options.kvsBackend == LinuxDeviceOptions::KvsBackend::kFile;
+        const char * kvsPath               = (fileBackend && options.KVS != nullptr) ? options.KVS : CHIP_DEVICE_KVS_PATH;
+
+        err = DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init(kvsPath);
+    }
     SuccessOrExit(err);
-    DeviceLayer::SetCommissionableDataProvider(&gCommissionableDataProvider);
 
-    err = InitConfigurationManager(reinterpret_cast<ConfigurationManagerImpl &>(ConfigurationMgr()));
+    if (LinuxDeviceOptions::GetInstance().factoryData != nullptr)
+    {
+        StartupProfiler::ScopedPhase phase("FactoryData");
+        err = gFactoryData.Open(LinuxDeviceOptions::GetInstance().factoryData);
+    }
     SuccessOrExit(err);
 
-    err = GetPayloadContents(payload, rendezvousFlags);
+    {
+        StartupProfiler::ScopedPhase phase("InitChipStack");
+        err = DeviceLayer::PlatformMgr().InitChipStack();
+    }
     SuccessOrExit(err);
 
-    ConfigurationMgr().LogDeviceConfig();
+    // The verifier cache lives in the KVS, so the worker can only start once the stack is up.
+    StartCommissionableDataWorker();
 
     {
-        ChipLogProgress(NotSpecified, "==== Onboarding payload for Standard Commissioning Flow ====");
-        PrintOnboardingCodes(payload);
+        StartupProfiler::ScopedPhase phase("InitConfigurationManager");
+        err = InitConfigurationManager(reinterpret_cast<ConfigurationManagerImpl &>(ConfigurationMgr()), gFactoryData);
     }
+    SuccessOrExit(err);
 
+    if (gFactoryData.IsOpen())
+    {
+        static FactoryDataDeviceInstanceInfoProvider sFactoryDataInstanceInfoProvider(
+            reinterpret_cast<ConfigurationManagerImpl &>(ConfigurationMgr()), gFactoryData);
+        DeviceLayer::SetDeviceInstanceInfoProvider(&sFactoryDataInstanceInfoProvider);
+    }
 
     DeviceLayer::PlatformMgrImpl().AddEventHandler(EventHandler, 0);
 
@@ -133,33 +291,218 @@ exit:
 void ChipLinuxAppMainLoop()
 {
     static chip::CommonCaseDeviceServerInitParams initParams;
-    VerifyOrDie(initParams.InitializeStaticResourcesBeforeServerInit() == CHIP_NO_ERROR);
-
-    initParams.operationalServicePort        = CHIP_PORT;
-    initParams.userDirectedCommissioningPort = CHIP_UDC_PORT;
+    {
+        StartupProfiler::ScopedPhase phase("ServerStaticResources");
+        VerifyOrDie(InitServerStorage() == CHIP_NO_ERROR);
+        initParams.persistentStorageDelegate = &gServerStorage;
+        VerifyOrDie(initParams.InitializeStaticResourcesBeforeServerInit() == CHIP_NO_ERROR);
+        gGroupDataProvider.SetStorageDelegate(initParams.persistentStorageDelegate);
+        VerifyOrDie(gGroupDataProvider.Init() == CHIP_NO_ERROR);
+        initParams.groupDataProvider = &gGroupDataProvider;
+    }
 
-//     initParams.interfaceId = LinuxDeviceOptions::GetInstance().interfaceId;
+    initParams.operationalServicePort        = static_cast<uint16_t>(LinuxDeviceOptions::GetInstance().securedDevicePort);
+    initParams.userDirectedCommissioningPort = static_cast<uint16_t>(LinuxDeviceOptions::GetInstance().unsecuredCommissionerPort);
 
     // We need to set DeviceInfoProvider before Server::Init to setup the storage of DeviceInfoProvider properly.
     DeviceLayer::SetDeviceInfoProvider(&gLightDeviceInfoProvider);
 
+    // Join point for the startup worker: nothing before this reads the commissionable data.
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    {
+        StartupProfiler::ScopedPhase phase("JoinStartupWorker");
+        err = JoinCommissionableDataWorker();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to init commissionable data: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+    VerifyOrDie(err == CHIP_NO_ERROR);
+    DeviceLayer::SetCommissionableDataProvider(&gCommissionableDataProvider);
+
+    if (LinuxDeviceOptions::GetInstance().lazyClusterInit)
+    {
+        LazyClusterInit::GetInstance().Enable();
+    }
+
     // Init ZCL Data Model and CHIP App Server
-    Server::GetInstance().Init(initParams);
+    {
+        StartupProfiler::ScopedPhase phase("Server::Init");
+        Server::GetInstance().Init(initParams);
+    }
+
+    {
+        ReportCoalescer::Config reportConfig;
+        if (LinuxDeviceOptions::GetInstance().reportTickMs != 0)
+        {
+            reportConfig.tick = System::Clock::Milliseconds32(LinuxDeviceOptions::GetInstance().reportTickMs);
+        }
+        err = ReportCoalescer::GetInstance().Init(reportConfig);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to start report coalescing: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    for (EncodedAttributeCache * cache : { &gOnOffReportCache, &gLevelControlReportCache })
+    {
+        err = cache->Init();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to register encoded attribute cache: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    err = LazyClusterInit::GetInstance().RegisterTriggers();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to register lazy cluster init triggers: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    {
+        LevelTransitionEngine::Config levelConfig;
+        if (LinuxDeviceOptions::GetInstance().levelStepMs != 0)
+        {
+            levelConfig.stepInterval = System::Clock::Milliseconds32(LinuxDeviceOptions::GetInstance().levelStepMs);
+        }
+        if (LinuxDeviceOptions::GetInstance().levelPublishMs != 0)
+        {
+            levelConfig.publishInterval = System::Clock::Milliseconds32(LinuxDeviceOptions::GetInstance().levelPublishMs);
+        }
+        err = LevelControlCommandHandler::GetInstance().Init(levelConfig, gGroupDataProvider);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to register level control handler: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    err = UserLabelServer::GetInstance().Init(gLightDeviceInfoProvider);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to register user label server: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    err = SceneRecallHandler::GetInstance().Init(gGroupDataProvider);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to register scene recall handler: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    err = OnOffGroupHandler::GetInstance().Init(gGroupDataProvider);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to register on-off group handler: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    if (LinuxDeviceOptions::GetInstance().bridgedLights > 0)
+    {
+        StartupProfiler::ScopedPhase phase("BridgedLights");
+        DynamicEndpointManager & endpoints = DynamicEndpointManager::GetInstance();
+        err                                = endpoints.Init();
+        for (uint32_t i = 0; err == CHIP_NO_ERROR && i < LinuxDeviceOptions::GetInstance().bridgedLights; i++)
+        {
+            EndpointId endpoint;
+            err = endpoints.AddLight(endpoint);
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to add bridged lights: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+        ChipLogProgress(NotSpecified, "%u bridged lights added", static_cast<unsigned>(endpoints.GetLightCount()));
+    }
 
     ConfigurationMgr().LogDeviceConfig();
     chip::PayloadContents payload;
     GetPayloadContents(payload, RendezvousInformationFlag::kOnNetwork);
-    PrintOnboardingCodes(payload);
+    {
+        ChipLogProgress(NotSpecified, "==== Onboarding payload for Standard Commissioning Flow ====");
+        PrintOnboardingCodes(payload);
+    }
 
     // Initialize device attestation config
-    SetDeviceAttestationCredentialsProvider(chip::Credentials::Examples::GetExampleDACProvider());
+    {
+        StartupProfiler::ScopedPhase phase("DacProvider");
+        if (gFactoryData.HasAttestationCredentials())
+        {
+            SetDeviceAttestationCredentialsProvider(&gFactoryDataDacProvider);
+        }
+        else
+        {
+            SetDeviceAttestationCredentialsProvider(chip::Credentials::Examples::GetExampleDACProvider());
+        }
+    }
 
-    ApplicationInit();
+    // Before restoring, so the driver also sees the restored state.
+    if (LinuxDeviceOptions::GetInstance().lightDriver != nullptr)
+    {
+        StartupProfiler::ScopedPhase phase("LightDriver");
+        std::unique_ptr<LightSink> sink;
+        CHIP_ERROR driverErr = CreateLightSink(LinuxDeviceOptions::GetInstance().lightDriver, sink);
+        if (driverErr == CHIP_NO_ERROR)
+        {
+            driverErr = LightDriver::GetInstance().Init(std::move(sink));
+        }
+        if (driverErr != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to start light driver: %" CHIP_ERROR_FORMAT, driverErr.Format());
+        }
+    }
+
+    if (LightDriver::GetInstance().IsRunning())
+    {
+        err = IdentifyEffectEngine::GetInstance().Init();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to start identify effects: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    {
+        StartupProfiler::ScopedPhase phase("RestoreLightState");
+        LightStatePersistence & lightState = LightStatePersistence::GetInstance();
+        CHIP_ERROR restoreErr              = lightState.Init(&gServerStorage);
+        if (restoreErr == CHIP_NO_ERROR)
+        {
+            restoreErr = lightState.Restore();
+        }
+        if (restoreErr != CHIP_NO_ERROR)
+        {
+            ChipLogError(NotSpecified, "Failed to restore light state: %" CHIP_ERROR_FORMAT, restoreErr.Format());
+        }
+    }
+
+    {
+        StartupProfiler::ScopedPhase phase("ApplicationInit");
+        ApplicationInit();
+    }
+
+    gEventLoopStart = StartupProfiler::Now();
+    DeviceLayer::PlatformMgr().ScheduleWork(OnFirstEventLoopIteration);
 
     DeviceLayer::PlatformMgr().RunEventLoop();
 
 
+    LightStatePersistence::GetInstance().Flush();
+    LazyClusterInit::GetInstance().Shutdown();
+    OnOffGroupHandler::GetInstance().Shutdown();
+    SceneRecallHandler::GetInstance().Shutdown();
+    UserLabelServer::GetInstance().Shutdown();
+    IdentifyEffectEngine::GetInstance().Shutdown();
+    LevelControlCommandHandler::GetInstance().Shutdown();
+    DynamicEndpointManager::GetInstance().Shutdown();
+    for (EncodedAttributeCache * cache : { &gOnOffReportCache, &gLevelControlReportCache })
+    {
+        ChipLogProgress(NotSpecified, "Encoded attribute cache: %u hits, %u misses", static_cast<unsigned>(cache->GetHitCount()),
+                        static_cast<unsigned>(cache->GetMissCount()));
+        cache->Shutdown();
+    }
+    ReportCoalescer::GetInstance().Shutdown();
+    ChipLogProgress(NotSpecified, "Report coalescing: %u paths reported, %u intermediate values dropped",
+                    static_cast<unsigned>(ReportCoalescer::GetInstance().GetForwardedCount()),
+                    static_cast<unsigned>(ReportCoalescer::GetInstance().GetDroppedCount()));
     Server::GetInstance().Shutdown();
+    LightDriver::GetInstance().Shutdown();
+    gWriteBehindStorage.Shutdown();
 
     DeviceLayer::PlatformMgr().Shutdown();
 
@@ -0,0 +1,226 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "AttributeIndex.h"
+
+#include <algorithm>
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app/util/af.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+
+#include <zap-generated/attribute_index.h>
+#include <zap-generated/endpoint_config.h>
+
+// The SDK's attribute storage: the values of each fixed endpoint, in FIXED_ENDPOINT_ARRAY order.
+extern uint8_t attributeData[];
+
+using namespace chip;
+
+namespace {
+
+struct IndexedCluster
+{
+    ClusterId clusterId;
+    uint8_t indexInEndpointType;
+    uint16_t firstAttribute;
+    uint16_t attributeCount;
+};
+
+struct IndexedEndpointType
+{
+    uint16_t firstCluster;
+    uint16_t clusterCount;
+    uint16_t storageSize;
+};
+
+struct IndexedAttribute
+{
+    AttributeId attributeId;
+    uint16_t storageOffset;
+};
+
+constexpr EndpointId kFixedEndpoints[]         = FIXED_ENDPOINT_ARRAY;
+constexpr uint8_t kFixedEndpointTypes[]        = FIXED_ENDPOINT_TYPES;
+constexpr IndexedCluster kClusters[]           = GENERATED_ATTRIBUTE_INDEX_CLUSTERS;
+constexpr IndexedEndpointType kEndpointTypes[] = GENERATED_ATTRIBUTE_INDEX_ENDPOINT_TYPES;
+constexpr IndexedAttribute kAttributes[]       = GENERATED_ATTRIBUTE_INDEX_ATTRIBUTES;
+
+static_assert(ArraySize(kFixedEndpoints) == ArraySize(kFixedEndpointTypes), "Fixed endpoint tables disagree");
+static_assert(ArraySize(kAttributes) == GENERATED_ATTRIBUTE_COUNT, "attribute_index.h is stale; regenerate it");
+static_assert(ArraySize(kClusters) == GENERATED_ATTRIBUTE_INDEX_CLUSTER_COUNT, "attribute_index.h is inconsistent");
+
+constexpr bool EndpointsSorted()
+{
+    for (size_t i = 1; i < ArraySize(kFixedEndpoints); i++)
+    {
+        if (kFixedEndpoints[i - 1] >= kFixedEndpoints[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Offset of the first value of the fixed endpoint at `fixedIndex` in attributeData.
+constexpr uint16_t StorageBase(size_t fixedIndex)
+{
+    uint32_t base = 0;
+    for (size_t i = 0; i < fixedIndex; i++)
+    {
+        base += kEndpointTypes[kFixedEndpointTypes[i]].storageSize;
+    }
+    return static_cast<uint16_t>(base);
+}
+
+constexpr bool ClustersSorted()
+{
+    for (const IndexedEndpointType & type : kEndpointTypes)
+    {
+        for (uint16_t i = 1; i < type.clusterCount; i++)
+        {
+            if (kClusters[type.firstCluster + i - 1].clusterId >= kClusters[type.firstCluster + i].clusterId)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+constexpr bool AttributesSorted()
+{
+    for (const IndexedCluster & cluster : kClusters)
+    {
+        for (uint16_t i = 1; i < cluster.attributeCount; i++)
+        {
+            if (kAttributes[cluster.firstAttribute + i - 1].attributeId >= kAttributes[cluster.firstAttribute + i].attributeId)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// GENERATED_ATTRIBUTES expanded into a constexpr mirror of its entries, so that the index can be
+// checked against the metadata it hands out. Defaults are parsed but not kept.
+struct GeneratedAttribute
+{
+    struct Default
+    {
+        constexpr Default(uint32_t) {}
+        constexpr Default(const void *) {}
+    };
+
+    AttributeId attributeId;
+    uint32_t attributeType;
+    uint32_t size;
+    uint32_t mask;
+    Default defaultValue;
+};
+
+// Only for ZAP_LONG_DEFAULTS_INDEX / ZAP_MIN_MAX_DEFAULTS_INDEX to take addresses in.
+constexpr uint8_t generatedDefaults[GENERATED_DEFAULTS_COUNT]     = {};
+constexpr uint8_t minMaxDefaults[GENERATED_MIN_MAX_DEFAULT_COUNT] = {};
+
+constexpr GeneratedAttribute kGeneratedAttributes[] = GENERATED_ATTRIBUTES;
+
+// Find() hands out &cluster.attributes[i] for kAttributes[firstAttribute + i]; that only works
+// if both tables list the same attributes in the same order.
+constexpr bool AttributeIdsMatch()
+{
+    for (size_t i = 0; i < ArraySize(kAttributes); i++)
+    {
+        if (kAttributes[i].attributeId != kGeneratedAttributes[i].attributeId)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(ArraySize(kGeneratedAttributes) == ArraySize(kAttributes), "attribute_index.h is stale; regenerate it");
+static_assert(AttributeIdsMatch(), "attribute_index.h does not follow GENERATED_ATTRIBUTES; regenerate it");
+static_assert(EndpointsSorted(), "FIXED_ENDPOINT_ARRAY must be sorted");
+static_assert(StorageBase(ArraySize(kFixedEndpoints)) == ATTRIBUTE_MAX_SIZE, "attribute_index.h storage sizes are stale");
+static_assert(ClustersSorted(), "Indexed clusters must be sorted by id within each endpoint type");
+static_assert(AttributesSorted(), "Generated attributes must be sorted by id within each cluster");
+
+} // namespace
+
+bool AttributeIndex::Find(EndpointId endpoint, ClusterId cluster, AttributeId attribute, Entry & entry)
+{
+    const EndpointId * endpointsEnd = kFixedEndpoints + ArraySize(kFixedEndpoints);
+    const EndpointId * fixed        = std::lower_bound(kFixedEndpoints, endpointsEnd, endpoint);
+    VerifyOrReturnError(fixed != endpointsEnd && *fixed == endpoint, false);
+
+    const IndexedEndpointType & type     = kEndpointTypes[kFixedEndpointTypes[fixed - kFixedEndpoints]];
+    const IndexedCluster * clustersBegin = kClusters + type.firstCluster;
+    const IndexedCluster * clustersEnd   = clustersBegin + type.clusterCount;
+    const IndexedCluster * indexedCluster =
+        std::lower_bound(clustersBegin, clustersEnd, cluster,
+                         [](const IndexedCluster & item, ClusterId id) { return item.clusterId < id; });
+    VerifyOrReturnError(indexedCluster != clustersEnd && indexedCluster->clusterId == cluster, false);
+
+    const IndexedAttribute * attributesBegin = kAttributes + indexedCluster->firstAttribute;
+    const IndexedAttribute * attributesEnd   = attributesBegin + indexedCluster->attributeCount;
+    const IndexedAttribute * indexedAttribute =
+        std::lower_bound(attributesBegin, attributesEnd, attribute,
+                         [](const IndexedAttribute & item, AttributeId id) { return item.attributeId < id; });
+    VerifyOrReturnError(indexedAttribute != attributesEnd && indexedAttribute->attributeId == attribute, false);
+
+    // The metadata itself lives in the SDK's copy of the generated tables; reach it through the
+    // endpoint's type, and make sure that still is the generated one.
+    const EmberAfEndpointType * endpointType = emberAfFindEndpointType(endpoint);
+    VerifyOrReturnError(endpointType != nullptr && indexedCluster->indexInEndpointType < endpointType->clusterCount, false);
+
+    const EmberAfCluster & emberCluster = endpointType->cluster[indexedCluster->indexInEndpointType];
+    VerifyOrReturnError(emberCluster.clusterId == cluster && emberCluster.attributeCount == indexedCluster->attributeCount,
+                        false);
+
+    entry.metadata      = &emberCluster.attributes[indexedAttribute - attributesBegin];
+    entry.storageOffset = indexedAttribute->storageOffset;
+    return true;
+}
+
+uint8_t * AttributeIndex::StorageLocation(EndpointId endpoint, const Entry & entry)
+{
+    VerifyOrReturnValue(entry.storageOffset != kNoStorageOffset, nullptr);
+
+    const EndpointId * endpointsEnd = kFixedEndpoints + ArraySize(kFixedEndpoints);
+    const EndpointId * fixed        = std::lower_bound(kFixedEndpoints, endpointsEnd, endpoint);
+    VerifyOrReturnValue(fixed != endpointsEnd && *fixed == endpoint, nullptr);
+
+    // Fixed endpoints come first in the SDK's endpoint table, in FIXED_ENDPOINT_ARRAY order.
+    const size_t fixedIndex = static_cast<size_t>(fixed - kFixedEndpoints);
+    VerifyOrReturnValue(emberAfEndpointIndexIsEnabled(static_cast<uint16_t>(fixedIndex)), nullptr);
+    return attributeData + StorageBase(fixedIndex) + entry.storageOffset;
+}
+
+const EmberAfAttributeMetadata * AttributeIndex::LocateAttributeMetadata(EndpointId endpoint, ClusterId cluster,
+                                                                         AttributeId attribute)
+{
+    Entry entry;
+    if (Find(endpoint, cluster, attribute, entry))
+    {
+        return entry.metadata;
+    }
+    return emberAfLocateAttributeMetadata(endpoint, cluster, attribute);
+}
@@ -0,0 +1,67 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <app/util/af-types.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Resolves concrete attribute paths on the fixed endpoints to their generated metadata.
+ *
+ * Lookups binary search the sorted tables in zap-generated/attribute_index.h (endpoint, then
+ * cluster, then attribute) instead of walking GENERATED_CLUSTERS and GENERATED_ATTRIBUTES.
+ * Paths on dynamic endpoints are not indexed; LocateAttributeMetadata() falls back to the
+ * linear emberAfLocateAttributeMetadata() for those.
+ */
+class AttributeIndex
+{
+public:
+    static constexpr uint16_t kNoStorageOffset = 0xFFFF;
+
+    struct Entry
+    {
+        const EmberAfAttributeMetadata * metadata = nullptr;
+        // Offset of the value within its endpoint's attribute storage, or kNoStorageOffset for
+        // attributes with external or singleton storage.
+        uint16_t storageOffset = kNoStorageOffset;
+    };
+
+    /**
+     * Look up a server attribute on a fixed endpoint.
+     *
+     * @return true and fill `entry` if the path is indexed, false otherwise.
+     */
+    static bool Find(chip::EndpointId endpoint, chip::ClusterId cluster, chip::AttributeId attribute, Entry & entry);
+
+    /**
+     * Where the SDK's attribute storage keeps the value of `entry`, found by Find() for
+     * `endpoint`; nullptr for external or singleton storage and for a disabled endpoint. This is
+     * the location emAfReadOrWriteAttribute() reads and writes, without its walk over the
+     * endpoints, clusters and attributes. Nothing is persisted or reported through it.
+     */
+    static uint8_t * StorageLocation(chip::EndpointId endpoint, const Entry & entry);
+
+    /**
+     * Indexed replacement for emberAfLocateAttributeMetadata() that also handles dynamic endpoints.
+     */
+    static const EmberAfAttributeMetadata * LocateAttributeMetadata(chip::EndpointId endpoint, chip::ClusterId cluster,
+                                                                    chip::AttributeId attribute);
+};
@@ -0,0 +1,162 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "AttributeUpdateBatch.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <app-common/zap-generated/callback.h>
+#include <app/ConcreteAttributePath.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include "AttributeIndex.h"
+#include "ReportCoalescer.h"
+
+using namespace chip;
+using namespace chip::app;
+
+CHIP_ERROR AttributeUpdateBatch::Set(EndpointId endpoint, ClusterId cluster, AttributeId attribute, EmberAfAttributeType type,
+                                     const void * value, uint16_t size)
+{
+    VerifyOrReturnError(value != nullptr && size > 0 && size <= kMaxValueSize, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Transitions stage a write per publish, so this goes through the index, not a table walk.
+    AttributeIndex::Entry entry;
+    uint8_t * storage = nullptr;
+    if (AttributeIndex::Find(endpoint, cluster, attribute, entry))
+    {
+        storage = AttributeIndex::StorageLocation(endpoint, entry);
+    }
+    else
+    {
+        entry.metadata = emberAfLocateAttributeMetadata(endpoint, cluster, attribute);
+    }
+    VerifyOrReturnError(entry.metadata != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(emberAfAttributeSize(entry.metadata) == size, CHIP_ERROR_INVALID_ARGUMENT);
+
+    auto it = std::find_if(mWrites.begin(), mWrites.end(), [&](const Write & write) {
+        return write.endpoint == endpoint && write.cluster == cluster && write.attribute == attribute;
+    });
+    if (it == mWrites.end())
+    {
+        it = mWrites.insert(mWrites.end(), Write{});
+    }
+
+    it->endpoint  = endpoint;
+    it->cluster   = cluster;
+    it->attribute = attribute;
+    it->type      = type;
+    it->size      = size;
+    it->metadata  = entry.metadata;
+    it->storage   = storage;
+    memcpy(it->value, value, size);
+    return CHIP_NO_ERROR;
+}
+
+size_t AttributeUpdateBatch::Commit()
+{
+    // Group the writes by cluster, keeping the staging order within one.
+    std::stable_sort(mWrites.begin(), mWrites.end(), [](const Write & a, const Write & b) {
+        return (a.endpoint != b.endpoint) ? (a.endpoint < b.endpoint) : (a.cluster < b.cluster);
+    });
+
+    // Values first, so that nothing notified below can observe a half-applied batch.
+    size_t changed = 0;
+    for (Write & write : mWrites)
+    {
+        if (Store(write))
+        {
+            mWrites[changed++] = write;
+        }
+    }
+    mWrites.resize(changed);
+
+    for (size_t i = 0; i < changed; i++)
+    {
+        const Write & write = mWrites[i];
+        if (i == 0 || write.endpoint != mWrites[i - 1].endpoint || write.cluster != mWrites[i - 1].cluster)
+        {
+            DataVersion * version = emberAfDataVersionStorage(ConcreteClusterPath(write.endpoint, write.cluster));
+            if (version != nullptr)
+            {
+                (*version)++;
+            }
+        }
+
+        ReportCoalescer::GetInstance().MarkDirty(ConcreteAttributePath(write.endpoint, write.cluster, write.attribute));
+    }
+
+    for (Write & write : mWrites)
+    {
+        MatterPostAttributeChangeCallback(ConcreteAttributePath(write.endpoint, write.cluster, write.attribute), write.type,
+                                          write.size, write.value);
+    }
+
+    mWrites.clear();
+    return changed;
+}
+
+bool AttributeUpdateBatch::Store(Write & write)
+{
+    // Set() already matched the value against the attribute's metadata.
+    if (write.storage != nullptr)
+    {
+        // Internal storage of a fixed endpoint: compare and write in place.
+        VerifyOrReturnValue(memcmp(write.storage, write.value, write.size) != 0, false);
+        memcpy(write.storage, write.value, write.size);
+    }
+    else if (!StoreThroughSdk(write))
+    {
+        return false;
+    }
+
+    emAfSaveAttributeToStorageIfNeeded(write.value, write.endpoint, write.cluster, write.metadata);
+    return true;
+}
+
+bool AttributeUpdateBatch::StoreThroughSdk(Write & write)
+{
+    EmberAfAttributeSearchRecord record;
+    record.endpoint    = write.endpoint;
+    record.clusterId   = write.cluster;
+    record.attributeId = write.attribute;
+
+    const EmberAfAttributeMetadata * metadata = nullptr;
+    uint8_t current[kMaxValueSize];
+    EmberAfStatus status = emAfReadOrWriteAttribute(&record, &metadata, current, sizeof(current), false);
+    if (status != EMBER_ZCL_STATUS_SUCCESS)
+    {
+        ChipLogError(Zcl, "Batched read of %u/" ChipLogFormatMEI "/" ChipLogFormatMEI " failed: 0x%02x", write.endpoint,
+                     ChipLogValueMEI(write.cluster), ChipLogValueMEI(write.attribute), status);
+        return false;
+    }
+    VerifyOrReturnValue(memcmp(current, write.value, write.size) != 0, false);
+
+    status = emAfReadOrWriteAttribute(&record, &metadata, write.value, 0, true);
+    if (status != EMBER_ZCL_STATUS_SUCCESS)
+    {
+        ChipLogError(Zcl, "Batched write to %u/" ChipLogFormatMEI "/" ChipLogFormatMEI " failed: 0x%02x", write.endpoint,
+                     ChipLogValueMEI(write.cluster), ChipLogValueMEI(write.attribute), status);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <app/util/af-types.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Writes a set of server attributes as one update.
+ *
+ * emberAfWriteServerAttribute() bumps the cluster's data version and marks the path dirty for
+ * every attribute it writes. A batch stores all of its values first (fixed or dynamic endpoints
+ * alike, including persistence), then bumps the data version of each touched cluster once, marks
+ * the changed paths dirty through the ReportCoalescer and calls MatterPostAttributeChangeCallback
+ * for them. Since everything lands in one turn of the event loop, subscribers get a single report
+ * run for the whole batch.
+ *
+ * Paths are resolved through AttributeIndex, and values in the internal storage of the fixed
+ * endpoints are compared and written in place. Values that match what is stored are skipped.
+ * Cluster-specific pre/post write hooks of the ember servers are not called, the same as for the
+ * application's own attribute writes.
+ *
+ * Only used from the CHIP stack thread.
+ */
+class AttributeUpdateBatch
+{
+public:
+    static constexpr uint16_t kMaxValueSize = 8;
+
+    /**
+     * Stages a value for the next Commit(); staging the same path again replaces it.
+     *
+     * Fails with CHIP_ERROR_INVALID_ARGUMENT unless the path has an attribute of that size.
+     */
+    CHIP_ERROR Set(chip::EndpointId endpoint, chip::ClusterId cluster, chip::AttributeId attribute, EmberAfAttributeType type,
+                   const void * value, uint16_t size);
+
+    template <typename T>
+    CHIP_ERROR Set(chip::EndpointId endpoint, chip::ClusterId cluster, chip::AttributeId attribute, EmberAfAttributeType type,
+                   T value)
+    {
+        static_assert(sizeof(T) <= kMaxValueSize, "Attribute value too large for a batch");
+        return Set(endpoint, cluster, attribute, type, &value, static_cast<uint16_t>(sizeof(T)));
+    }
+
+    /**
+     * Applies and clears the staged values.
+     *
+     * @return the number of attributes that changed.
+     */
+    size_t Commit();
+
+    void Clear() { mWrites.clear(); }
+    bool IsEmpty() const { return mWrites.empty(); }
+
+private:
+    struct Write
+    {
+        chip::EndpointId endpoint;
+        chip::ClusterId cluster;
+        chip::AttributeId attribute;
+        EmberAfAttributeType type;
+        uint16_t size;
+        const EmberAfAttributeMetadata * metadata;
+        uint8_t * storage; // AttributeIndex::StorageLocation(), nullptr to go through the SDK
+        uint8_t value[kMaxValueSize];
+    };
+
+    // Stores `write`; returns false if it was a no-op or failed.
+    static bool Store(Write & write);
+    // Store() for attributes outside the SDK's internal storage of the fixed endpoints.
+    static bool StoreThroughSdk(Write & write);
+
+    std::vector<Write> mWrites;
+};
@@ -19,34 +19,106 @@
 #include <crypto/CHIPCryptoPAL.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/DeviceInstanceInfoProvider.h>
 
 #include "CommissionableInit.h"
+#include "Options.h"
 
 using namespace chip::DeviceLayer;
 
-CHIP_ERROR InitCommissionableDataProvider(DeviceCommissionableDataProvider & provider)
+namespace {
+constexpr uint16_t kVendorId             = 65521;
+constexpr uint16_t kProductId            = 32768;
+constexpr uint16_t kHardwareVersion      = 1234;
+constexpr uint32_t kDefaultPasscode      = 20202021;
+constexpr uint16_t kDefaultDiscriminator = 3840;
+} // namespace
+
+CHIP_ERROR InitCommissionableDataProvider(DeviceCommissionableDataProvider & provider, const FactoryData & factoryData)
 {
+    const LinuxDeviceOptions & options = LinuxDeviceOptions::GetInstance();
+
+    if (factoryData.IsOpen())
+    {
+        if (options.payload.setUpPINCode != 0 || options.discriminator.HasValue() || options.spake2pIterations != 0)
+        {
+            ChipLogError(Support, "--passcode, --discriminator and --spake2p-iterations are overridden by --factory-data");
+        }
+        ChipLogProgress(Support, "Using commissionable data from factory data image");
+        return provider.InitFromFactoryData(factoryData.GetSpake2pIterationCount(),
+                                            factoryData.GetSection(FactoryData::Section::kSpake2pSalt),
+                                            factoryData.GetSection(FactoryData::Section::kSpake2pVerifier),
+                                            factoryData.GetSetupPasscode(), factoryData.GetDiscriminator());
+    }
+
     chip::Optional<uint32_t> setupPasscode;
-    chip::Optional<uint16_t> discriminator;
-    uint32_t defaultPasscode = 20202021;
-    uint16_t defaultDiscriminator = 3840;
+    setupPasscode.SetValue((options.payload.setUpPINCode != 0) ? options.payload.setUpPINCode : kDefaultPasscode);
+    const uint16_t discriminator = options.discriminator.HasValue() ? options.discriminator.Value() : kDefaultDiscriminator;
+
     // Default to minimum PBKDF iterations
     uint32_t spake2pIterationCount = chip::Crypto::kSpake2p_Min_PBKDF_Iterations;
-
-    setupPasscode.SetValue(defaultPasscode);
+    if (options.spake2pIterations != 0)
+    {
+        spake2pIterationCount = options.spake2pIterations;
+    }
 
     ChipLogError(Support, "PASE PBKDF iterations set to %u", static_cast<unsigned>(spake2pIterationCount));
 
-    return provider.Init(spake2pIterationCount, setupPasscode, defaultDiscriminator);
+    return provider.Init(spake2pIterationCount, setupPasscode, discriminator);
 }
 
-CHIP_ERROR InitConfigurationManager(ConfigurationManagerImpl & configManager)
+CHIP_ERROR InitConfigurationManager(ConfigurationManagerImpl & configManager, const FactoryData & factoryData)
 {
-    configManager.StoreVendorId(65521);
+    const LinuxDeviceOptions & options = LinuxDeviceOptions::GetInstance();
+
+    if (factoryData.IsOpen())
+    {
+        if (options.payload.vendorID != 0 || options.payload.productID != 0)
+        {
+            ChipLogError(DeviceLayer, "--vendor-id and --product-id are overridden by --factory-data");
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    const uint16_t vendorId  = (options.payload.vendorID != 0) ? options.payload.vendorID : kVendorId;
+    const uint16_t productId = (options.payload.productID != 0) ? options.payload.productID : kProductId;
+
+    DeviceInstanceInfoProvider * instanceInfo = GetDeviceInstanceInfoProvider();
+    VerifyOrReturnError(instanceInfo != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    // Only write values that differ from what is already stored, so an unchanged configuration
+    // does not cost a write (and fsync) on every boot.
+    unsigned skippedWrites = 0;
+    uint16_t current       = 0;
+
+    if (instanceInfo->GetVendorId(current) == CHIP_NO_ERROR && current == vendorId)
+    {
+        skippedWrites++;
+    }
+    else
+    {
+        configManager.StoreVendorId(vendorId);
+    }
+
+    if (instanceInfo->GetProductId(current) == CHIP_NO_ERROR && current == productId)
+    {
+        skippedWrites++;
+    }
+    else
+    {
+        configManager.StoreProductId(productId);
+    }
 
-    configManager.StoreProductId(32768);
+    if (instanceInfo->GetHardwareVersion(current) == CHIP_NO_ERROR && current == kHardwareVersion)
+    {
+        skippedWrites++;
+    }
+    else
+    {
+        configManager.StoreHardwareVersion(kHardwareVersion);
+    }
 
-    configManager.StoreHardwareVersion(1234);
+    ChipLogProgress(DeviceLayer, "Configuration: %u of 3 writes skipped (unchanged)", skippedWrites);
 
     return CHIP_NO_ERROR;
 }
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "DeviceCommissionableDataProvider.h"
+#include "FactoryData.h"
 #include <lib/core/CHIPError.h>
 #include <platform/ConfigurationManager.h>
 #include <platform/PlatformManager.h>
@@ -29,18 +30,25 @@
  *        options. Handles verifier, passcode, discriminator, etc.
  *
  * @param provider - provider to initialize from command line arguments
- * @param options - LinuxDeviceOptions instance configured via command-line parsing
+ * The passcode, discriminator and PBKDF iteration count come from --passcode, --discriminator
+ * and --spake2p-iterations, or from the factory data image when one is open.
+ *
+ * @param factoryData - factory data image; when open, its values are served as-is
  * @return CHIP_NO_ERROR on success or another CHIP_ERROR value on internal validation errors (likely fatal)
  */
-CHIP_ERROR InitCommissionableDataProvider(DeviceCommissionableDataProvider & provider);
+CHIP_ERROR InitCommissionableDataProvider(DeviceCommissionableDataProvider & provider, const FactoryData & factoryData);
 
 /**
  * @brief Initialize a Linux ConfigurationManagerImpl to reflect some command-line configured
- *        values such as VendorID/ProductID
+ *        values such as VendorID/ProductID (--vendor-id, --product-id)
+ *
+ * When a factory data image is open the configuration store is left untouched: those
+ * values are served from the image by FactoryDataDeviceInstanceInfoProvider instead, and the
+ * command-line ids are ignored.
  *
  * @param configManager - Linux-specific configuration manager to update
- * @param options - LinuxDeviceOptions instance configured via command-line parsing
+ * @param factoryData - factory data image, possibly not open
  * @return CHIP_NO_ERROR on success or another CHIP_ERROR value on internal validation errors (likely fatal)
  */
-CHIP_ERROR InitConfigurationManager(chip::DeviceLayer::ConfigurationManagerImpl & configManager);
+CHIP_ERROR InitConfigurationManager(chip::DeviceLayer::ConfigurationManagerImpl & configManager, const FactoryData & factoryData);
 
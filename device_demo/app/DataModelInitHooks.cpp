@@ -0,0 +1,80 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Overrides of the data model init hooks declared in PluginApplicationCallbacks.h,
+ *      recording every plugin and cluster init callback in the startup profile and
+ *      deferring the ones LazyClusterInit selects. The User Label plugin is skipped
+ *      altogether in favour of UserLabelServer.
+ */
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <zap-generated/PluginApplicationCallbacks.h>
+
+#include "LazyClusterInit.h"
+#include "StartupProfiler.h"
+
+using namespace chip;
+
+namespace {
+// Init callbacks run on the Matter thread and never nest within callbacks of the same kind.
+System::Clock::Microseconds64 gPluginInitStart;
+System::Clock::Microseconds64 gClusterInitStart;
+} // namespace
+
+bool MatterPrePluginInitCallback(ClusterId clusterId, const char * pluginName)
+{
+    (void) pluginName;
+    // UserLabelServer serves the cluster instead; AppMain registers it after Server::Init.
+    if (clusterId == app::Clusters::UserLabel::Id)
+    {
+        return false;
+    }
+    if (LazyClusterInit::GetInstance().ShouldDeferPluginInit(clusterId))
+    {
+        return false;
+    }
+    gPluginInitStart = StartupProfiler::Now();
+    return true;
+}
+
+void MatterPostPluginInitCallback(ClusterId clusterId, const char * pluginName)
+{
+    (void) clusterId;
+    StartupProfiler::GetInstance().Record(pluginName, gPluginInitStart, StartupProfiler::Now(),
+                                          StartupProfiler::Category::kPluginInit);
+}
+
+bool MatterPreClusterInitCallback(EndpointId endpoint, ClusterId clusterId, const char * clusterName)
+{
+    (void) clusterName;
+    if (LazyClusterInit::GetInstance().ShouldDeferClusterInit(endpoint, clusterId))
+    {
+        return false;
+    }
+    gClusterInitStart = StartupProfiler::Now();
+    return true;
+}
+
+void MatterPostClusterInitCallback(EndpointId endpoint, ClusterId clusterId, const char * clusterName)
+{
+    (void) clusterId;
+    StartupProfiler::GetInstance().Record(clusterName, gClusterInitStart, StartupProfiler::Now(),
+                                          StartupProfiler::Category::kClusterInit, endpoint);
+}
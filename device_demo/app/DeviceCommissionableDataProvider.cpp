@@ -21,14 +21,30 @@
 #include <string.h>
 
 #include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/core/CHIPTLV.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/Span.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/KeyValueStoreManager.h>
 
 using namespace chip::Crypto;
+using chip::DeviceLayer::PersistedStorage::KeyValueStoreMgr;
 
 namespace {
 
+// The verifier cache is keyed by (passcode, iteration count, salt). The passcode itself is never
+// persisted: only a SHA-256 digest of the passcode and salt is kept to detect a passcode change.
+constexpr char kPaseVerifierCacheKey[] = "light/pase-verifier";
+
+constexpr chip::TLV::Tag kCacheIterationCountTag     = chip::TLV::ContextTag(0);
+constexpr chip::TLV::Tag kCacheSaltTag               = chip::TLV::ContextTag(1);
+constexpr chip::TLV::Tag kCachePasscodeDigestTag     = chip::TLV::ContextTag(2);
+constexpr chip::TLV::Tag kCacheSerializedVerifierTag = chip::TLV::ContextTag(3);
+
+constexpr size_t kPaseVerifierCacheMaxSize = chip::TLV::EstimateStructOverhead(
+    sizeof(uint32_t), kSpake2p_Max_PBKDF_Salt_Length, kSHA256_Hash_Length, kSpake2p_VerifierSerialized_Length);
+
 CHIP_ERROR GeneratePaseSalt(std::vector<uint8_t> & spake2pSaltVector)
 {
     constexpr size_t kSaltLen = kSpake2p_Max_PBKDF_Salt_Length;
@@ -36,6 +52,84 @@ CHIP_ERROR GeneratePaseSalt(std::vector<uint8_t> & spake2pSaltVector)
     return DRBG_get_bytes(spake2pSaltVector.data(), spake2pSaltVector.size());
 }
 
+CHIP_ERROR ComputePasscodeDigest(uint32_t setupPasscode, chip::ByteSpan salt, uint8_t (&digest)[kSHA256_Hash_Length])
+{
+    std::vector<uint8_t> input(sizeof(setupPasscode) + salt.size());
+    chip::Encoding::LittleEndian::Put32(input.data(), setupPasscode);
+    memcpy(input.data() + sizeof(setupPasscode), salt.data(), salt.size());
+    return Hash_SHA256(input.data(), input.size(), digest);
+}
+
+/**
+ * Loads a previously persisted salt and serialized verifier. Fails if nothing is cached, or if the
+ * cached entry was produced from a different passcode or iteration count.
+ */
+CHIP_ERROR LoadCachedPaseVerifier(uint32_t spake2pIterationCount, uint32_t setupPasscode, std::vector<uint8_t> & spake2pSaltVector,
+                                  std::vector<uint8_t> & serializedVerifier)
+{
+    uint8_t buf[kPaseVerifierCacheMaxSize];
+    size_t len = 0;
+    ReturnErrorOnFailure(KeyValueStoreMgr().Get(kPaseVerifierCacheKey, buf, sizeof(buf), &len));
+
+    chip::TLV::ContiguousBufferTLVReader reader;
+    reader.Init(buf, len);
+    ReturnErrorOnFailure(reader.Next(chip::TLV::kTLVType_Structure, chip::TLV::AnonymousTag()));
+
+    chip::TLV::TLVType containerType;
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+    uint32_t iterationCount = 0;
+    chip::ByteSpan salt;
+    chip::ByteSpan passcodeDigest;
+    chip::ByteSpan verifier;
+
+    ReturnErrorOnFailure(reader.Next(kCacheIterationCountTag));
+    ReturnErrorOnFailure(reader.Get(iterationCount));
+    ReturnErrorOnFailure(reader.Next(kCacheSaltTag));
+    ReturnErrorOnFailure(reader.Get(salt));
+    ReturnErrorOnFailure(reader.Next(kCachePasscodeDigestTag));
+    ReturnErrorOnFailure(reader.Get(passcodeDigest));
+    ReturnErrorOnFailure(reader.Next(kCacheSerializedVerifierTag));
+    ReturnErrorOnFailure(reader.Get(verifier));
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
+
+    VerifyOrReturnError(iterationCount == spake2pIterationCount, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(salt.size() >= kSpake2p_Min_PBKDF_Salt_Length && salt.size() <= kSpake2p_Max_PBKDF_Salt_Length,
+                        CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    VerifyOrReturnError(verifier.size() == kSpake2p_VerifierSerialized_Length, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    uint8_t expectedDigest[kSHA256_Hash_Length];
+    ReturnErrorOnFailure(ComputePasscodeDigest(setupPasscode, salt, expectedDigest));
+    VerifyOrReturnError(passcodeDigest.data_equal(chip::ByteSpan(expectedDigest)), CHIP_ERROR_INCORRECT_STATE);
+
+    spake2pSaltVector.assign(salt.begin(), salt.end());
+    serializedVerifier.assign(verifier.begin(), verifier.end());
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StoreCachedPaseVerifier(uint32_t spake2pIterationCount, uint32_t setupPasscode,
+                                   const std::vector<uint8_t> & spake2pSaltVector, const std::vector<uint8_t> & serializedVerifier)
+{
+    chip::ByteSpan salt{ spake2pSaltVector.data(), spake2pSaltVector.size() };
+    uint8_t passcodeDigest[kSHA256_Hash_Length];
+    ReturnErrorOnFailure(ComputePasscodeDigest(setupPasscode, salt, passcodeDigest));
+
+    uint8_t buf[kPaseVerifierCacheMaxSize];
+    chip::TLV::TLVWriter writer;
+    writer.Init(buf);
+
+    chip::TLV::TLVType outerType;
+    ReturnErrorOnFailure(writer.StartContainer(chip::TLV::AnonymousTag(), chip::TLV::kTLVType_Structure, outerType));
+    ReturnErrorOnFailure(writer.Put(kCacheIterationCountTag, spake2pIterationCount));
+    ReturnErrorOnFailure(writer.Put(kCacheSaltTag, salt));
+    ReturnErrorOnFailure(writer.Put(kCachePasscodeDigestTag, chip::ByteSpan(passcodeDigest)));
+    ReturnErrorOnFailure(
+        writer.Put(kCacheSerializedVerifierTag, chip::ByteSpan(serializedVerifier.data(), serializedVerifier.size())));
+    ReturnErrorOnFailure(writer.EndContainer(outerType));
+
+    return KeyValueStoreMgr().Put(kPaseVerifierCacheKey, buf, writer.GetLengthWritten());
+}
+
 } // namespace
 
 CHIP_ERROR DeviceCommissionableDataProvider::Init(uint32_t spake2pIterationCount,
@@ -59,28 +153,41 @@ CHIP_ERROR DeviceCommissionableDataProvider::Init(uint32_t spake2pIterationCount
     CHIP_ERROR err;
     Spake2pVerifier passcodeVerifier;
     std::vector<uint8_t> serializedPasscodeVerifier(kSpake2p_VerifierSerialized_Length);
+    std::vector<uint8_t> spake2pSaltVector;
     bool havePasscode = setupPasscode.HasValue();
 
-    ChipLogProgress(Support, "generating a PASE salt");
-    std::vector<uint8_t> spake2pSaltVector;
-    err = GeneratePaseSalt(spake2pSaltVector);
-    if (err != CHIP_NO_ERROR)
+    if (!havePasscode)
     {
-        ChipLogError(Support, "Failed to generate PASE salt: %" CHIP_ERROR_FORMAT, err.Format());
-        return err;
+        ChipLogError(Support, "no passcode: cannot produce final verifier");
+        return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
-    chip::MutableByteSpan saltSpan{ spake2pSaltVector.data(), spake2pSaltVector.size() };
-
-    size_t spake2pSaltLength = spake2pSaltVector.size();
-    if ((spake2pSaltLength < kSpake2p_Min_PBKDF_Salt_Length) || (spake2pSaltLength > kSpake2p_Max_PBKDF_Salt_Length))
+    // Reuse the salt and verifier from a previous boot when the passcode and iteration count are
+    // unchanged, so that warm boots skip the PBKDF computation entirely.
+    err = LoadCachedPaseVerifier(spake2pIterationCount, setupPasscode.Value(), spake2pSaltVector, serializedPasscodeVerifier);
+    if (err == CHIP_NO_ERROR)
     {
-        ChipLogError(Support, "PASE salt length invalid: %u", static_cast<unsigned>(spake2pSaltLength));
-        return CHIP_ERROR_INVALID_ARGUMENT;
+        ChipLogProgress(Support, "using cached PASE salt and verifier");
     }
-
-    if (havePasscode)
+    else
     {
+        ChipLogProgress(Support, "generating a PASE salt");
+        err = GeneratePaseSalt(spake2pSaltVector);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Support, "Failed to generate PASE salt: %" CHIP_ERROR_FORMAT, err.Format());
+            return err;
+        }
+
+        chip::MutableByteSpan saltSpan{ spake2pSaltVector.data(), spake2pSaltVector.size() };
+
+        size_t spake2pSaltLength = spake2pSaltVector.size();
+        if ((spake2pSaltLength < kSpake2p_Min_PBKDF_Salt_Length) || (spake2pSaltLength > kSpake2p_Max_PBKDF_Salt_Length))
+        {
+            ChipLogError(Support, "PASE salt length invalid: %u", static_cast<unsigned>(spake2pSaltLength));
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+
         err = passcodeVerifier.Generate(spake2pIterationCount, saltSpan, setupPasscode.Value());
         if (err != CHIP_NO_ERROR)
         {
@@ -88,6 +195,7 @@ CHIP_ERROR DeviceCommissionableDataProvider::Init(uint32_t spake2pIterationCount
             return err;
         }
 
+        serializedPasscodeVerifier.resize(kSpake2p_VerifierSerialized_Length);
         chip::MutableByteSpan verifierSpan{ serializedPasscodeVerifier.data(), serializedPasscodeVerifier.size() };
         err = passcodeVerifier.Serialize(verifierSpan);
         if (err != CHIP_NO_ERROR)
@@ -95,11 +203,13 @@ CHIP_ERROR DeviceCommissionableDataProvider::Init(uint32_t spake2pIterationCount
             ChipLogError(Support, "Failed to serialize PASE verifier from passcode: %" CHIP_ERROR_FORMAT, err.Format());
             return err;
         }
-    }
-    else
-    {
-        ChipLogError(Support, "no passcode: cannot produce final verifier");
-        return CHIP_ERROR_INVALID_ARGUMENT;
+
+        // A failure to persist only costs the PBKDF again on the next boot.
+        err = StoreCachedPaseVerifier(spake2pIterationCount, setupPasscode.Value(), spake2pSaltVector, serializedPasscodeVerifier);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Support, "Failed to persist PASE verifier: %" CHIP_ERROR_FORMAT, err.Format());
+        }
     }
 
     mDiscriminator          = discriminator;
@@ -110,7 +220,39 @@ CHIP_ERROR DeviceCommissionableDataProvider::Init(uint32_t spake2pIterationCount
     {
         mSetupPasscode.SetValue(setupPasscode.Value());
     }
-    mIsInitialized = true;
+    mPaseSaltSpan               = chip::ByteSpan(mPaseSalt.data(), mPaseSalt.size());
+    mSerializedPaseVerifierSpan = chip::ByteSpan(mSerializedPaseVerifier.data(), mSerializedPaseVerifier.size());
+    mIsInitialized              = true;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DeviceCommissionableDataProvider::InitFromFactoryData(uint32_t spake2pIterationCount, chip::ByteSpan spake2pSalt,
+                                                                 chip::ByteSpan serializedSpake2pVerifier,
+                                                                 chip::Optional<uint32_t> setupPasscode, uint16_t discriminator)
+{
+    VerifyOrReturnError(mIsInitialized == false, CHIP_ERROR_INCORRECT_STATE);
+
+    VerifyOrReturnError(discriminator <= chip::kMaxDiscriminatorValue, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(spake2pIterationCount >= kSpake2p_Min_PBKDF_Iterations &&
+                            spake2pIterationCount <= kSpake2p_Max_PBKDF_Iterations,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(spake2pSalt.size() >= kSpake2p_Min_PBKDF_Salt_Length &&
+                            spake2pSalt.size() <= kSpake2p_Max_PBKDF_Salt_Length,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(serializedSpake2pVerifier.size() == kSpake2p_VerifierSerialized_Length, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (!setupPasscode.HasValue())
+    {
+        ChipLogError(Support, "Factory data has no setup passcode: onboarding codes will be incorrect");
+    }
+
+    mDiscriminator              = discriminator;
+    mPaseIterationCount         = spake2pIterationCount;
+    mSetupPasscode              = setupPasscode;
+    mPaseSaltSpan               = spake2pSalt;
+    mSerializedPaseVerifierSpan = serializedSpake2pVerifier;
+    mIsInitialized              = true;
 
     return CHIP_NO_ERROR;
 }
@@ -134,8 +276,8 @@ CHIP_ERROR DeviceCommissionableDataProvider::GetSpake2pSalt(chip::MutableByteSpa
     VerifyOrReturnError(mIsInitialized == true, CHIP_ERROR_WELL_UNINITIALIZED);
 
     VerifyOrReturnError(saltBuf.size() >= kSpake2p_Max_PBKDF_Salt_Length, CHIP_ERROR_BUFFER_TOO_SMALL);
-    memcpy(saltBuf.data(), mPaseSalt.data(), mPaseSalt.size());
-    saltBuf.reduce_size(mPaseSalt.size());
+    memcpy(saltBuf.data(), mPaseSaltSpan.data(), mPaseSaltSpan.size());
+    saltBuf.reduce_size(mPaseSaltSpan.size());
 
     return CHIP_NO_ERROR;
 }
@@ -145,12 +287,12 @@ CHIP_ERROR DeviceCommissionableDataProvider::GetSpake2pVerifier(chip::MutableByt
     VerifyOrReturnError(mIsInitialized == true, CHIP_ERROR_WELL_UNINITIALIZED);
 
     // By now, serialized verifier from Init should be correct size
-    VerifyOrReturnError(mSerializedPaseVerifier.size() == kSpake2p_VerifierSerialized_Length, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(mSerializedPaseVerifierSpan.size() == kSpake2p_VerifierSerialized_Length, CHIP_ERROR_INTERNAL);
 
-    outVerifierLen = mSerializedPaseVerifier.size();
+    outVerifierLen = mSerializedPaseVerifierSpan.size();
     VerifyOrReturnError(verifierBuf.size() >= outVerifierLen, CHIP_ERROR_BUFFER_TOO_SMALL);
-    memcpy(verifierBuf.data(), mSerializedPaseVerifier.data(), mSerializedPaseVerifier.size());
-    verifierBuf.reduce_size(mSerializedPaseVerifier.size());
+    memcpy(verifierBuf.data(), mSerializedPaseVerifierSpan.data(), mSerializedPaseVerifierSpan.size());
+    verifierBuf.reduce_size(mSerializedPaseVerifierSpan.size());
 
     return CHIP_NO_ERROR;
 }
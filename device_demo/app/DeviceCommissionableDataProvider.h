@@ -5,6 +5,7 @@
 
 #include <lib/core/CHIPError.h>
 #include <lib/core/Optional.h>
+#include <lib/support/Span.h>
 #include <platform/CommissionableDataProvider.h>
 
 class DeviceCommissionableDataProvider : public chip::DeviceLayer::CommissionableDataProvider
@@ -25,6 +26,10 @@ public:
      * configurations where the passcode is maintained separately than the
      * verifier for security purposes.
      *
+     * The generated salt and verifier are persisted in the key-value store. On later
+     * boots they are reused as long as the passcode and iteration count still match,
+     * so the PBKDF computation only runs when those inputs change.
+     *
      * @param serializedSpake2pVerifier - Optional serialized verifier that will
      *                                    override computation from setupPasscode if provided
      * @param spake2pSalt               - Optional salt to use. A random one will be generated
@@ -42,6 +47,20 @@ public:
                     chip::Optional<uint32_t> setupPasscode,
                     uint16_t discriminator);
 
+    /**
+     * @brief Initialize the provider from values provisioned at manufacturing time.
+     *
+     * No verifier is computed and nothing is persisted: `spake2pSalt` and
+     * `serializedSpake2pVerifier` are borrowed, not copied, and must outlive the
+     * provider (typically they point into the mapped factory data image).
+     *
+     * @return CHIP_NO_ERROR on success, CHIP_ERROR_INVALID_ARGUMENT if any value is out of
+     *         spec bounds, or CHIP_ERROR_INCORRECT_STATE if already initialized.
+     */
+    CHIP_ERROR InitFromFactoryData(uint32_t spake2pIterationCount, chip::ByteSpan spake2pSalt,
+                                   chip::ByteSpan serializedSpake2pVerifier, chip::Optional<uint32_t> setupPasscode,
+                                   uint16_t discriminator);
+
     CHIP_ERROR GetSetupDiscriminator(uint16_t & setupDiscriminator) override;
     CHIP_ERROR SetSetupDiscriminator(uint16_t setupDiscriminator) override
     {
@@ -62,6 +81,9 @@ private:
     bool mIsInitialized = false;
     std::vector<uint8_t> mSerializedPaseVerifier;
     std::vector<uint8_t> mPaseSalt;
+    // Views of the active salt and verifier: either the vectors above or factory data.
+    chip::ByteSpan mPaseSaltSpan;
+    chip::ByteSpan mSerializedPaseVerifierSpan;
     uint32_t mPaseIterationCount = 0;
     chip::Optional<uint32_t> mSetupPasscode;
     uint16_t mDiscriminator = 0;
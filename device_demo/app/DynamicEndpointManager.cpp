@@ -0,0 +1,305 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "DynamicEndpointManager.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/util/af.h>
+#include <app/util/attribute-storage.h>
+#include <crypto/RandUtils.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/CHIPDeviceConfig.h>
+
+using namespace chip;
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr ClusterId kLightClusters[] = {
+    Identify::Id, Groups::Id, Scenes::Id, OnOff::Id, LevelControl::Id, Descriptor::Id,
+};
+
+constexpr uint16_t kDimmableLightDeviceType = 0x0101;
+constexpr uint8_t kDeviceTypeVersion        = 1;
+
+const EmberAfDeviceType kLightDeviceTypes[] = { { kDimmableLightDeviceType, kDeviceTypeVersion } };
+
+bool IsLightCluster(const EmberAfCluster & cluster)
+{
+    VerifyOrReturnError((cluster.mask & CLUSTER_MASK_SERVER) != 0, false);
+    return std::find(std::begin(kLightClusters), std::end(kLightClusters), cluster.clusterId) != std::end(kLightClusters);
+}
+
+// Where emAfLoadAttributeDefaults would take the default value from: min/max defaults are inline up
+// to 2 bytes, other defaults up to 4 bytes unless they are strings.
+const uint8_t * DefaultValueOf(const EmberAfAttributeMetadata & metadata)
+{
+    if (metadata.mask & ATTRIBUTE_MASK_MIN_MAX)
+    {
+        const EmberAfDefaultAttributeValue & value = metadata.defaultValue.ptrToMinMaxValue->defaultValue;
+        return (metadata.size <= 2) ? reinterpret_cast<const uint8_t *>(&value.defaultValue) : value.ptrToDefaultValue;
+    }
+    const bool isInline = (metadata.size <= 4) && !emberAfIsStringAttributeType(metadata.attributeType);
+    return isInline ? reinterpret_cast<const uint8_t *>(&metadata.defaultValue.defaultValue)
+                    : metadata.defaultValue.ptrToDefaultValue;
+}
+
+} // namespace
+
+DynamicEndpointManager & DynamicEndpointManager::GetInstance()
+{
+    static DynamicEndpointManager sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR DynamicEndpointManager::Init()
+{
+    VerifyOrReturnError(mEndpoints.empty(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0, CHIP_ERROR_NOT_IMPLEMENTED);
+
+    const EmberAfEndpointType * endpointType = emberAfFindEndpointType(kTemplateEndpoint);
+    VerifyOrReturnError(endpointType != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    size_t attributeCount = 0;
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        if (IsLightCluster(endpointType->cluster[i]))
+        {
+            attributeCount += endpointType->cluster[i].attributeCount;
+        }
+    }
+
+    // Reserved up front: the cluster copies point into mAttributes.
+    mAttributes.reserve(attributeCount);
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & source = endpointType->cluster[i];
+        if (!IsLightCluster(source))
+        {
+            continue;
+        }
+
+        EmberAfCluster cluster = source;
+        cluster.attributes     = mAttributes.data() + mAttributes.size();
+        cluster.clusterSize    = 0;
+        for (uint16_t j = 0; j < source.attributeCount; j++)
+        {
+            EmberAfAttributeMetadata attribute = source.attributes[j];
+            attribute.mask = static_cast<EmberAfAttributeMask>((attribute.mask | ATTRIBUTE_MASK_EXTERNAL_STORAGE) &
+                                                               ~(ATTRIBUTE_MASK_SINGLETON | ATTRIBUTE_MASK_NONVOLATILE));
+            mAttributes.push_back(attribute);
+        }
+        mClusters.push_back(cluster);
+    }
+
+    mEndpointType.cluster      = mClusters.data();
+    mEndpointType.clusterCount = static_cast<uint8_t>(mClusters.size());
+    mEndpointType.endpointSize = 0;
+
+    const size_t capacity = CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT;
+    size_t valuesSize     = 0;
+    mColumns.resize(mAttributes.size());
+    for (size_t i = 0; i < mAttributes.size(); i++)
+    {
+        // Lists have no fixed size; their clusters serve them through attribute access overrides.
+        const bool isList  = (mAttributes[i].attributeType == ZCL_ARRAY_ATTRIBUTE_TYPE);
+        mColumns[i].size   = isList ? 0 : mAttributes[i].size;
+        mColumns[i].offset = valuesSize;
+        valuesSize += mColumns[i].size * capacity;
+    }
+    mValues.reset(new uint8_t[valuesSize]());
+    mDataVersions.reset(new DataVersion[capacity * mClusters.size()]());
+    mEndpoints.assign(capacity, kInvalidEndpointId);
+
+    mNextEndpointId = static_cast<EndpointId>(emberAfEndpointFromIndex(static_cast<uint16_t>(emberAfFixedEndpointCount() - 1)) + 1);
+
+    ChipLogProgress(Zcl, "Dynamic endpoints: %u light slots, %u clusters, %u bytes of attribute storage",
+                    static_cast<unsigned>(capacity), static_cast<unsigned>(mClusters.size()), static_cast<unsigned>(valuesSize));
+    return CHIP_NO_ERROR;
+}
+
+void DynamicEndpointManager::Shutdown()
+{
+    for (size_t slot = 0; slot < mEndpoints.size(); slot++)
+    {
+        if (mEndpoints[slot] != kInvalidEndpointId)
+        {
+            RemoveLight(mEndpoints[slot]);
+        }
+    }
+
+    mEndpoints.clear();
+    mDataVersions.reset();
+    mValues.reset();
+    mColumns.clear();
+    mClusters.clear();
+    mAttributes.clear();
+    mEndpointType = {};
+}
+
+CHIP_ERROR DynamicEndpointManager::AddLight(EndpointId & endpoint)
+{
+    VerifyOrReturnError(!mEndpoints.empty(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mNextEndpointId != kInvalidEndpointId, CHIP_ERROR_NO_MEMORY);
+
+    const auto freeSlot = std::find(mEndpoints.begin(), mEndpoints.end(), kInvalidEndpointId);
+    VerifyOrReturnError(freeSlot != mEndpoints.end(), CHIP_ERROR_NO_MEMORY);
+    const size_t slot = static_cast<size_t>(freeSlot - mEndpoints.begin());
+
+    LoadDefaults(slot);
+    DataVersion * dataVersions = &mDataVersions[slot * mClusters.size()];
+    for (size_t i = 0; i < mClusters.size(); i++)
+    {
+        dataVersions[i] = Crypto::GetRandU32();
+    }
+
+    // Claimed before registering: the cluster init callbacks already read attributes.
+    mEndpoints[slot] = mNextEndpointId;
+    EmberAfStatus status = emberAfSetDynamicEndpoint(static_cast<uint16_t>(slot), mNextEndpointId, &mEndpointType,
+                                                     Span<DataVersion>(dataVersions, mClusters.size()),
+                                                     Span<const EmberAfDeviceType>(kLightDeviceTypes));
+    if (status != EMBER_ZCL_STATUS_SUCCESS)
+    {
+        mEndpoints[slot] = kInvalidEndpointId;
+        ChipLogError(Zcl, "Failed to add dynamic endpoint %u: 0x%02x", mNextEndpointId, status);
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    endpoint = mNextEndpointId++;
+    mLightCount++;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DynamicEndpointManager::RemoveLight(EndpointId endpoint)
+{
+    const int slot = GetSlot(endpoint);
+    VerifyOrReturnError(slot >= 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    emberAfClearDynamicEndpoint(static_cast<uint16_t>(slot));
+    mEndpoints[static_cast<size_t>(slot)] = kInvalidEndpointId;
+    mLightCount--;
+    return CHIP_NO_ERROR;
+}
+
+int DynamicEndpointManager::GetSlot(EndpointId endpoint) const
+{
+    VerifyOrReturnError(endpoint != kInvalidEndpointId, -1);
+    const auto it = std::find(mEndpoints.begin(), mEndpoints.end(), endpoint);
+    return (it != mEndpoints.end()) ? static_cast<int>(it - mEndpoints.begin()) : -1;
+}
+
+const uint8_t * DynamicEndpointManager::GetColumn(ClusterId cluster, AttributeId attribute, uint16_t & stride) const
+{
+    for (const EmberAfCluster & candidate : mClusters)
+    {
+        if (candidate.clusterId != cluster)
+        {
+            continue;
+        }
+        for (uint16_t i = 0; i < candidate.attributeCount; i++)
+        {
+            if (candidate.attributes[i].attributeId == attribute)
+            {
+                const Column & column = mColumns[static_cast<size_t>(&candidate.attributes[i] - mAttributes.data())];
+                VerifyOrReturnError(column.size != 0, nullptr);
+                stride = column.size;
+                return &mValues[column.offset];
+            }
+        }
+    }
+    return nullptr;
+}
+
+int DynamicEndpointManager::ColumnOf(const EmberAfAttributeMetadata * metadata) const
+{
+    // Ember hands back pointers into the template, so the column is just the index.
+    const EmberAfAttributeMetadata * begin = mAttributes.data();
+    VerifyOrReturnError(!mAttributes.empty() && metadata >= begin && metadata < begin + mAttributes.size(), -1);
+    const size_t column = static_cast<size_t>(metadata - begin);
+    VerifyOrReturnError(mColumns[column].size != 0, -1);
+    return static_cast<int>(column);
+}
+
+void DynamicEndpointManager::LoadDefaults(size_t slot)
+{
+    for (size_t i = 0; i < mAttributes.size(); i++)
+    {
+        const uint16_t size = mColumns[i].size;
+        if (size == 0)
+        {
+            continue;
+        }
+
+        uint8_t * cell               = Cell(i, slot);
+        const uint8_t * defaultValue = DefaultValueOf(mAttributes[i]);
+        if (defaultValue != nullptr)
+        {
+            memcpy(cell, defaultValue, size);
+        }
+        else
+        {
+            memset(cell, 0, size);
+        }
+    }
+}
+
+EmberAfStatus DynamicEndpointManager::ReadAttribute(EndpointId endpoint, const EmberAfAttributeMetadata * metadata,
+                                                    uint8_t * buffer, uint16_t maxReadLength)
+{
+    const int slot   = GetSlot(endpoint);
+    const int column = ColumnOf(metadata);
+    VerifyOrReturnError(slot >= 0 && column >= 0, EMBER_ZCL_STATUS_FAILURE);
+
+    const uint16_t size = mColumns[static_cast<size_t>(column)].size;
+    VerifyOrReturnError(maxReadLength >= size, EMBER_ZCL_STATUS_RESOURCE_EXHAUSTED);
+    memcpy(buffer, Cell(static_cast<size_t>(column), static_cast<size_t>(slot)), size);
+    return EMBER_ZCL_STATUS_SUCCESS;
+}
+
+EmberAfStatus DynamicEndpointManager::WriteAttribute(EndpointId endpoint, const EmberAfAttributeMetadata * metadata,
+                                                     const uint8_t * buffer)
+{
+    const int slot   = GetSlot(endpoint);
+    const int column = ColumnOf(metadata);
+    VerifyOrReturnError(slot >= 0 && column >= 0, EMBER_ZCL_STATUS_FAILURE);
+
+    // Ember validated the value against the metadata; strings carry their length prefix.
+    memcpy(Cell(static_cast<size_t>(column), static_cast<size_t>(slot)), buffer, mColumns[static_cast<size_t>(column)].size);
+    return EMBER_ZCL_STATUS_SUCCESS;
+}
+
+EmberAfStatus emberAfExternalAttributeReadCallback(EndpointId endpoint, ClusterId clusterId,
+                                                   const EmberAfAttributeMetadata * attributeMetadata, uint8_t * buffer,
+                                                   uint16_t maxReadLength)
+{
+    (void) clusterId;
+    return DynamicEndpointManager::GetInstance().ReadAttribute(endpoint, attributeMetadata, buffer, maxReadLength);
+}
+
+EmberAfStatus emberAfExternalAttributeWriteCallback(EndpointId endpoint, ClusterId clusterId,
+                                                    const EmberAfAttributeMetadata * attributeMetadata, uint8_t * buffer)
+{
+    (void) clusterId;
+    return DynamicEndpointManager::GetInstance().WriteAttribute(endpoint, attributeMetadata, buffer);
+}
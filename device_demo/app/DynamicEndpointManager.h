@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include <app/util/af-types.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Adds and removes bridged light endpoints at runtime (--bridged-lights).
+ *
+ * Every light gets the Identify, Groups, Scenes, OnOff, LevelControl and Descriptor server
+ * clusters of endpoint 1, with the same attributes and defaults. The template is copied once
+ * at Init with every attribute switched to external storage, and all lights share it.
+ *
+ * Attribute values live in one buffer laid out as a structure of arrays: one column per
+ * template attribute, holding that attribute for every slot back to back. A scan of e.g. OnOff
+ * across all lights reads a single contiguous run of bytes (see GetColumn()).
+ *
+ * Up to CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT lights. Only used from the CHIP stack thread.
+ */
+class DynamicEndpointManager
+{
+public:
+    static constexpr chip::EndpointId kTemplateEndpoint = 1;
+
+    static DynamicEndpointManager & GetInstance();
+
+    /**
+     * Builds the endpoint template from kTemplateEndpoint. Call after Server::Init.
+     */
+    CHIP_ERROR Init();
+    void Shutdown();
+
+    /**
+     * Registers a new light with default attribute values and returns its endpoint id. Endpoint
+     * ids are not reused while the process runs.
+     */
+    CHIP_ERROR AddLight(chip::EndpointId & endpoint);
+    CHIP_ERROR RemoveLight(chip::EndpointId endpoint);
+
+    size_t GetCapacity() const { return mEndpoints.size(); }
+    size_t GetLightCount() const { return mLightCount; }
+
+    /**
+     * The slot of a light, i.e. its row in every column, or -1 if `endpoint` is not one.
+     */
+    int GetSlot(chip::EndpointId endpoint) const;
+    chip::EndpointId GetEndpoint(size_t slot) const { return mEndpoints[slot]; }
+
+    /**
+     * The column holding `attribute` for every slot: the value of slot i starts at
+     * column + i * stride. Free slots hold stale values. Returns nullptr if the attribute is not
+     * stored here.
+     */
+    const uint8_t * GetColumn(chip::ClusterId cluster, chip::AttributeId attribute, uint16_t & stride) const;
+
+    // Storage for the attributes of the lights, called from the ember external attribute callbacks.
+    EmberAfStatus ReadAttribute(chip::EndpointId endpoint, const EmberAfAttributeMetadata * metadata, uint8_t * buffer,
+                                uint16_t maxReadLength);
+    EmberAfStatus WriteAttribute(chip::EndpointId endpoint, const EmberAfAttributeMetadata * metadata, const uint8_t * buffer);
+
+private:
+    struct Column
+    {
+        size_t offset = 0; // into mValues
+        uint16_t size = 0; // bytes per slot; 0 for attributes served elsewhere (lists)
+    };
+
+    uint8_t * Cell(size_t column, size_t slot) { return &mValues[mColumns[column].offset + mColumns[column].size * slot]; }
+    int ColumnOf(const EmberAfAttributeMetadata * metadata) const;
+    void LoadDefaults(size_t slot);
+
+    // The shared endpoint template; mClusters points into mAttributes.
+    std::vector<EmberAfAttributeMetadata> mAttributes;
+    std::vector<EmberAfCluster> mClusters;
+    EmberAfEndpointType mEndpointType = {};
+
+    // One column per entry of mAttributes.
+    std::vector<Column> mColumns;
+    std::unique_ptr<uint8_t[]> mValues;
+
+    // mClusters.size() data versions per slot.
+    std::unique_ptr<chip::DataVersion[]> mDataVersions;
+
+    // Endpoint id of each slot, kInvalidEndpointId when free.
+    std::vector<chip::EndpointId> mEndpoints;
+    size_t mLightCount                = 0;
+    chip::EndpointId mNextEndpointId = chip::kInvalidEndpointId;
+};
@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "EncodedAttributeCache.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+template <typename T>
+T LoadValue(const uint8_t * buffer)
+{
+    T value;
+    memcpy(&value, buffer, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+CHIP_ERROR EncodedAttributeCache::PreEncoded::Encode(TLV::TLVWriter & writer, TLV::Tag tag) const
+{
+    TLV::TLVReader reader;
+    reader.Init(mData, mLength);
+    ReturnErrorOnFailure(reader.Next());
+    return writer.CopyElement(tag, reader);
+}
+
+EncodedAttributeCache::EncodedAttributeCache(EndpointId endpoint, ClusterId cluster) :
+    AttributeAccessInterface(MakeOptional(endpoint), cluster), mEndpoint(endpoint), mCluster(cluster)
+{}
+
+CHIP_ERROR EncodedAttributeCache::Init()
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+
+    const EmberAfEndpointType * endpointType = emberAfFindEndpointType(mEndpoint);
+    VerifyOrReturnError(endpointType != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    mEntries.clear();
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        if (cluster.clusterId != mCluster || (cluster.mask & CLUSTER_MASK_SERVER) == 0)
+        {
+            continue;
+        }
+        for (uint16_t j = 0; j < cluster.attributeCount; j++)
+        {
+            if (IsCacheable(cluster.attributes[j]))
+            {
+                Entry entry;
+                entry.metadata = &cluster.attributes[j];
+                mEntries.push_back(entry);
+            }
+        }
+    }
+    VerifyOrReturnError(!mEntries.empty(), CHIP_ERROR_NOT_FOUND);
+    std::sort(mEntries.begin(), mEntries.end(),
+              [](const Entry & a, const Entry & b) { return a.metadata->attributeId < b.metadata->attributeId; });
+
+    VerifyOrReturnError(registerAttributeAccessOverride(this), CHIP_ERROR_INCORRECT_STATE);
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void EncodedAttributeCache::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    unregisterAttributeAccessOverride(this);
+    mEntries.clear();
+    mRegistered = false;
+}
+
+CHIP_ERROR EncodedAttributeCache::Read(const ConcreteReadAttributePath & path, AttributeValueEncoder & encoder)
+{
+    // Returning without encoding hands the read to ember.
+    Entry * entry = Find(path.mAttributeId);
+    VerifyOrReturnError(entry != nullptr, CHIP_NO_ERROR);
+    const DataVersion * version = emberAfDataVersionStorage(ConcreteClusterPath(mEndpoint, mCluster));
+    VerifyOrReturnError(version != nullptr, CHIP_NO_ERROR);
+
+    if (entry->valid && entry->version == *version)
+    {
+        mHits++;
+    }
+    else
+    {
+        VerifyOrReturnError(Refresh(*entry, *version) == CHIP_NO_ERROR, CHIP_NO_ERROR);
+        mMisses++;
+    }
+    return encoder.Encode(PreEncoded(entry->tlv, entry->length));
+}
+
+bool EncodedAttributeCache::IsCacheable(const EmberAfAttributeMetadata & metadata)
+{
+    VerifyOrReturnValue((metadata.mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) == 0, false);
+
+    switch (metadata.attributeType)
+    {
+    case ZCL_BOOLEAN_ATTRIBUTE_TYPE:
+        return metadata.size == 1;
+    case ZCL_INT8U_ATTRIBUTE_TYPE:
+    case ZCL_INT16U_ATTRIBUTE_TYPE:
+    case ZCL_INT32U_ATTRIBUTE_TYPE:
+    case ZCL_INT64U_ATTRIBUTE_TYPE:
+    case ZCL_ENUM8_ATTRIBUTE_TYPE:
+    case ZCL_ENUM16_ATTRIBUTE_TYPE:
+    case ZCL_BITMAP8_ATTRIBUTE_TYPE:
+    case ZCL_BITMAP16_ATTRIBUTE_TYPE:
+    case ZCL_BITMAP32_ATTRIBUTE_TYPE:
+    case ZCL_BITMAP64_ATTRIBUTE_TYPE:
+        return metadata.size == 1 || metadata.size == 2 || metadata.size == 4 || metadata.size == 8;
+    default:
+        return false;
+    }
+}
+
+EncodedAttributeCache::Entry * EncodedAttributeCache::Find(AttributeId attribute)
+{
+    auto it = std::lower_bound(mEntries.begin(), mEntries.end(), attribute,
+                               [](const Entry & entry, AttributeId id) { return entry.metadata->attributeId < id; });
+    return (it != mEntries.end() && it->metadata->attributeId == attribute) ? &*it : nullptr;
+}
+
+CHIP_ERROR EncodedAttributeCache::Refresh(Entry & entry, DataVersion version)
+{
+    const EmberAfAttributeMetadata & metadata = *entry.metadata;
+    entry.valid                               = false;
+
+    uint8_t buffer[sizeof(uint64_t)];
+    VerifyOrReturnError(emberAfReadAttribute(mEndpoint, mCluster, metadata.attributeId, buffer, sizeof(buffer)) ==
+                            EMBER_ZCL_STATUS_SUCCESS,
+                        CHIP_ERROR_READ_FAILED);
+
+    // Nullable scalars store null as all ones, booleans as 0xFF.
+    bool isNull = (metadata.mask & ATTRIBUTE_MASK_NULLABLE) != 0;
+    for (uint16_t i = 0; isNull && i < metadata.size; i++)
+    {
+        isNull = (buffer[i] == 0xFF);
+    }
+
+    TLV::TLVWriter writer;
+    writer.Init(entry.tlv, sizeof(entry.tlv));
+    if (isNull)
+    {
+        ReturnErrorOnFailure(writer.PutNull(TLV::AnonymousTag()));
+    }
+    else if (metadata.attributeType == ZCL_BOOLEAN_ATTRIBUTE_TYPE)
+    {
+        ReturnErrorOnFailure(writer.PutBoolean(TLV::AnonymousTag(), buffer[0] != 0));
+    }
+    else
+    {
+        switch (metadata.size)
+        {
+        case 1:
+            ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), buffer[0]));
+            break;
+        case 2:
+            ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), LoadValue<uint16_t>(buffer)));
+            break;
+        case 4:
+            ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), LoadValue<uint32_t>(buffer)));
+            break;
+        default:
+            ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), LoadValue<uint64_t>(buffer)));
+            break;
+        }
+    }
+    ReturnErrorOnFailure(writer.Finalize());
+
+    entry.length  = static_cast<uint8_t>(writer.GetLengthWritten());
+    entry.version = version;
+    entry.valid   = true;
+    return CHIP_NO_ERROR;
+}
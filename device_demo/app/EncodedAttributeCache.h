@@ -0,0 +1,100 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <app/AttributeAccessInterface.h>
+#include <app/util/af-types.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Serves the scalar attributes of one server cluster on one endpoint from encoded TLV cached
+ * per (path, data version).
+ *
+ * With several subscriptions on the same attributes, every report would otherwise look the
+ * attribute up, read it out of ember storage and convert it to TLV again for each subscriber.
+ * Here the first read after a change does that once and keeps the encoded element; later reads
+ * at the same cluster data version copy those bytes into the report. Any write to the cluster
+ * bumps its data version, which is what invalidates the cache.
+ *
+ * Only booleans and unsigned integers, enums and bitmaps stored in ember are cached. Reads of
+ * anything else fall through to the ember read path. Writes are not intercepted.
+ */
+class EncodedAttributeCache : public chip::app::AttributeAccessInterface
+{
+public:
+    // Fits the largest cached element: a 64-bit integer with its control byte.
+    static constexpr size_t kMaxEncodedSize = 16;
+
+    EncodedAttributeCache(chip::EndpointId endpoint, chip::ClusterId cluster);
+
+    /**
+     * Picks the cacheable attributes of the cluster and registers the cache. Call after
+     * Server::Init.
+     */
+    CHIP_ERROR Init();
+    void Shutdown();
+
+    CHIP_ERROR Read(const chip::app::ConcreteReadAttributePath & path, chip::app::AttributeValueEncoder & encoder) override;
+
+    size_t GetHitCount() const { return mHits; }
+    size_t GetMissCount() const { return mMisses; }
+
+private:
+    struct Entry
+    {
+        const EmberAfAttributeMetadata * metadata = nullptr;
+        bool valid                                = false;
+        chip::DataVersion version                 = 0;
+        uint8_t length                            = 0;
+        uint8_t tlv[kMaxEncodedSize];
+    };
+
+    // Encodes as a copy of a cached element, under whatever tag the report asks for.
+    class PreEncoded
+    {
+    public:
+        static constexpr bool kIsFabricScoped = false;
+
+        PreEncoded(const uint8_t * data, size_t length) : mData(data), mLength(length) {}
+        CHIP_ERROR Encode(chip::TLV::TLVWriter & writer, chip::TLV::Tag tag) const;
+
+    private:
+        const uint8_t * mData;
+        size_t mLength;
+    };
+
+    static bool IsCacheable(const EmberAfAttributeMetadata & metadata);
+
+    Entry * Find(chip::AttributeId attribute);
+    CHIP_ERROR Refresh(Entry & entry, chip::DataVersion version);
+
+    const chip::EndpointId mEndpoint;
+    const chip::ClusterId mCluster;
+    std::vector<Entry> mEntries; // sorted by attribute id
+    bool mRegistered = false;
+    size_t mHits     = 0;
+    size_t mMisses   = 0;
+};
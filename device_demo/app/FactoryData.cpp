@@ -0,0 +1,215 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "FactoryData.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPSafeCasts.h>
+#include <lib/support/BufferReader.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <setup_payload/SetupPayload.h>
+
+using namespace chip;
+using namespace chip::Crypto;
+
+CHIP_ERROR FactoryData::Open(const char * path)
+{
+    VerifyOrReturnError(!IsOpen(), CHIP_ERROR_INCORRECT_STATE);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        close(fd);
+        return err;
+    }
+    if (st.st_size <= 0)
+    {
+        close(fd);
+        return CHIP_ERROR_INVALID_FILE_IDENTIFIER;
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void * mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    VerifyOrReturnError(mapping != MAP_FAILED, CHIP_ERROR_POSIX(errno));
+
+    mImage       = static_cast<const uint8_t *>(mapping);
+    mImageLength = length;
+
+    CHIP_ERROR err = Parse(ByteSpan(mImage, mImageLength));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Invalid factory data image %s: %" CHIP_ERROR_FORMAT, path, err.Format());
+        Close();
+        return err;
+    }
+
+    ChipLogProgress(DeviceLayer, "Mapped factory data image %s (%u bytes)", path, static_cast<unsigned>(mImageLength));
+    return CHIP_NO_ERROR;
+}
+
+void FactoryData::Close()
+{
+    if (mImage != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(mImage), mImageLength);
+    }
+    mImage       = nullptr;
+    mImageLength = 0;
+    for (ByteSpan & section : mSections)
+    {
+        section = ByteSpan();
+    }
+}
+
+CHIP_ERROR FactoryData::Parse(ByteSpan image)
+{
+    Encoding::LittleEndian::Reader reader(image.data(), image.size());
+
+    uint32_t magic        = 0;
+    uint16_t version      = 0;
+    uint16_t headerLength = 0;
+    uint32_t imageLength  = 0;
+
+    reader.Read32(&magic).Read16(&version).Read16(&headerLength).Read32(&imageLength);
+    reader.Read16(&mVendorId).Read16(&mProductId).Read16(&mHardwareVersion).Read16(&mDiscriminator);
+    reader.Read32(&mSpake2pIterationCount).Read32(&mSetupPasscode);
+    ReturnErrorOnFailure(reader.StatusCode());
+
+    VerifyOrReturnError(magic == kMagic, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(version == kVersion, CHIP_ERROR_VERSION_MISMATCH);
+    VerifyOrReturnError(headerLength >= kFixedHeaderLength + kSectionCount * 2 * sizeof(uint32_t), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(imageLength <= image.size() && headerLength <= imageLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (ByteSpan & section : mSections)
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        ReturnErrorOnFailure(reader.Read32(&offset).Read32(&length).StatusCode());
+        VerifyOrReturnError(offset >= headerLength && offset <= imageLength && length <= imageLength - offset,
+                            CHIP_ERROR_INVALID_ARGUMENT);
+        section = image.SubSpan(offset, length);
+    }
+
+    VerifyOrReturnError(mDiscriminator <= kMaxDiscriminatorValue, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mSpake2pIterationCount >= kSpake2p_Min_PBKDF_Iterations &&
+                            mSpake2pIterationCount <= kSpake2p_Max_PBKDF_Iterations,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t saltLength = GetSection(Section::kSpake2pSalt).size();
+    VerifyOrReturnError(saltLength >= kSpake2p_Min_PBKDF_Salt_Length && saltLength <= kSpake2p_Max_PBKDF_Salt_Length,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(GetSection(Section::kSpake2pVerifier).size() == kSpake2p_VerifierSerialized_Length,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    return CHIP_NO_ERROR;
+}
+
+Optional<uint32_t> FactoryData::GetSetupPasscode() const
+{
+    return (mSetupPasscode != 0) ? MakeOptional(mSetupPasscode) : NullOptional;
+}
+
+bool FactoryData::HasAttestationCredentials() const
+{
+    return !GetSection(Section::kCertificationDeclaration).empty() && !GetSection(Section::kDacCert).empty() &&
+        !GetSection(Section::kPaiCert).empty() && GetSection(Section::kDacPublicKey).size() == kP256_PublicKey_Length &&
+        GetSection(Section::kDacPrivateKey).size() == kP256_PrivateKey_Length;
+}
+
+CHIP_ERROR FactoryDataDeviceInstanceInfoProvider::GetVendorId(uint16_t & vendorId)
+{
+    VerifyOrReturnError(mFactoryData.IsOpen(), DeviceInstanceInfoProviderImpl::GetVendorId(vendorId));
+    vendorId = mFactoryData.GetVendorId();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryDataDeviceInstanceInfoProvider::GetProductId(uint16_t & productId)
+{
+    VerifyOrReturnError(mFactoryData.IsOpen(), DeviceInstanceInfoProviderImpl::GetProductId(productId));
+    productId = mFactoryData.GetProductId();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryDataDeviceInstanceInfoProvider::GetHardwareVersion(uint16_t & hardwareVersion)
+{
+    VerifyOrReturnError(mFactoryData.IsOpen(), DeviceInstanceInfoProviderImpl::GetHardwareVersion(hardwareVersion));
+    hardwareVersion = mFactoryData.GetHardwareVersion();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryDataDacProvider::GetCertificationDeclaration(MutableByteSpan & outBuffer)
+{
+    return CopySpanToMutableSpan(mFactoryData.GetSection(FactoryData::Section::kCertificationDeclaration), outBuffer);
+}
+
+CHIP_ERROR FactoryDataDacProvider::GetFirmwareInformation(MutableByteSpan & outBuffer)
+{
+    // The factory data image has no firmware information section; it is optional, so report none.
+    outBuffer.reduce_size(0);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryDataDacProvider::GetDeviceAttestationCert(MutableByteSpan & outBuffer)
+{
+    return CopySpanToMutableSpan(mFactoryData.GetSection(FactoryData::Section::kDacCert), outBuffer);
+}
+
+CHIP_ERROR FactoryDataDacProvider::GetProductAttestationIntermediateCert(MutableByteSpan & outBuffer)
+{
+    return CopySpanToMutableSpan(mFactoryData.GetSection(FactoryData::Section::kPaiCert), outBuffer);
+}
+
+CHIP_ERROR FactoryDataDacProvider::SignWithDeviceAttestationKey(const ByteSpan & messageToSign,
+                                                                MutableByteSpan & outSignatureBuffer)
+{
+    VerifyOrReturnError(mFactoryData.HasAttestationCredentials(), CHIP_ERROR_INCORRECT_STATE);
+
+    P256ECDSASignature signature;
+    VerifyOrReturnError(IsSpanUsable(outSignatureBuffer), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(IsSpanUsable(messageToSign), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(outSignatureBuffer.size() >= signature.Capacity(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    ByteSpan publicKey  = mFactoryData.GetSection(FactoryData::Section::kDacPublicKey);
+    ByteSpan privateKey = mFactoryData.GetSection(FactoryData::Section::kDacPrivateKey);
+
+    // The keypair API wants the serialized public || private form; this is the only copy of the key
+    // material and it lives on the stack for the duration of the signature.
+    P256SerializedKeypair serializedKeypair;
+    ReturnErrorOnFailure(serializedKeypair.SetLength(publicKey.size() + privateKey.size()));
+    memcpy(serializedKeypair.Bytes(), publicKey.data(), publicKey.size());
+    memcpy(serializedKeypair.Bytes() + publicKey.size(), privateKey.data(), privateKey.size());
+
+    P256Keypair keypair;
+    ReturnErrorOnFailure(keypair.Deserialize(serializedKeypair));
+    ReturnErrorOnFailure(keypair.ECDSA_sign_msg(messageToSign.data(), messageToSign.size(), signature));
+
+    return CopySpanToMutableSpan(ByteSpan{ signature.ConstBytes(), signature.Length() }, outSignatureBuffer);
+}
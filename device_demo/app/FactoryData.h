@@ -0,0 +1,154 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <credentials/DeviceAttestationCredsProvider.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+#include <lib/support/Span.h>
+#include <platform/Linux/DeviceInstanceInfoProviderImpl.h>
+
+/**
+ * Read-only, versioned factory data image.
+ *
+ * The image is written once at manufacturing time and memory-mapped at startup. All accessors
+ * return values or spans pointing straight into the mapping: nothing is copied and nothing is
+ * ever written back.
+ *
+ * Layout, all integers little-endian:
+ *
+ *   offset  size  field
+ *   0       4     magic "LFD\0" (kMagic)
+ *   4       2     format version (kVersion)
+ *   6       2     header length, including the section table
+ *   8       4     image length
+ *   12      2     vendor id
+ *   14      2     product id
+ *   16      2     hardware version
+ *   18      2     discriminator
+ *   20      4     SPAKE2+ PBKDF iteration count
+ *   24      4     setup passcode, 0 if not provisioned
+ *   28      8*N   section table: { u32 offset, u32 length } per Section, in enum order
+ *
+ * Sections may be empty (length 0) except for the SPAKE2+ salt and verifier.
+ */
+class FactoryData
+{
+public:
+    static constexpr uint32_t kMagic   = 0x0044464c; // "LFD\0"
+    static constexpr uint16_t kVersion = 1;
+
+    enum class Section : uint8_t
+    {
+        kSpake2pSalt = 0,
+        kSpake2pVerifier,
+        kCertificationDeclaration,
+        kDacCert,
+        kPaiCert,
+        kDacPublicKey,
+        kDacPrivateKey,
+
+        kCount
+    };
+
+    FactoryData() = default;
+    ~FactoryData() { Close(); }
+
+    FactoryData(const FactoryData &) = delete;
+    FactoryData & operator=(const FactoryData &) = delete;
+
+    /**
+     * Maps and validates the image at `path`. On failure nothing stays mapped.
+     */
+    CHIP_ERROR Open(const char * path);
+    void Close();
+    bool IsOpen() const { return mImage != nullptr; }
+
+    uint16_t GetVendorId() const { return mVendorId; }
+    uint16_t GetProductId() const { return mProductId; }
+    uint16_t GetHardwareVersion() const { return mHardwareVersion; }
+    uint16_t GetDiscriminator() const { return mDiscriminator; }
+    uint32_t GetSpake2pIterationCount() const { return mSpake2pIterationCount; }
+    chip::Optional<uint32_t> GetSetupPasscode() const;
+    chip::ByteSpan GetSection(Section section) const { return mSections[static_cast<uint8_t>(section)]; }
+
+    /**
+     * True if the image carries everything needed to serve device attestation.
+     */
+    bool HasAttestationCredentials() const;
+
+private:
+    static constexpr size_t kFixedHeaderLength = 28;
+    static constexpr size_t kSectionCount      = static_cast<size_t>(Section::kCount);
+
+    CHIP_ERROR Parse(chip::ByteSpan image);
+
+    const uint8_t * mImage = nullptr;
+    size_t mImageLength    = 0;
+
+    uint16_t mVendorId              = 0;
+    uint16_t mProductId             = 0;
+    uint16_t mHardwareVersion       = 0;
+    uint16_t mDiscriminator         = 0;
+    uint32_t mSpake2pIterationCount = 0;
+    uint32_t mSetupPasscode         = 0;
+    chip::ByteSpan mSections[kSectionCount];
+};
+
+/**
+ * Serves vendor id, product id and hardware version from the factory data image, falling back
+ * to the platform implementation for everything else.
+ */
+class FactoryDataDeviceInstanceInfoProvider : public chip::DeviceLayer::DeviceInstanceInfoProviderImpl
+{
+public:
+    FactoryDataDeviceInstanceInfoProvider(chip::DeviceLayer::ConfigurationManagerImpl & configManager,
+                                          const FactoryData & factoryData) :
+        chip::DeviceLayer::DeviceInstanceInfoProviderImpl(configManager),
+        mFactoryData(factoryData)
+    {}
+
+    CHIP_ERROR GetVendorId(uint16_t & vendorId) override;
+    CHIP_ERROR GetProductId(uint16_t & productId) override;
+    CHIP_ERROR GetHardwareVersion(uint16_t & hardwareVersion) override;
+
+private:
+    const FactoryData & mFactoryData;
+};
+
+/**
+ * Serves the certification declaration, DAC, PAI and DAC signatures from the factory data image.
+ */
+class FactoryDataDacProvider : public chip::Credentials::DeviceAttestationCredentialsProvider
+{
+public:
+    explicit FactoryDataDacProvider(const FactoryData & factoryData) : mFactoryData(factoryData) {}
+
+    CHIP_ERROR GetCertificationDeclaration(chip::MutableByteSpan & outBuffer) override;
+    CHIP_ERROR GetFirmwareInformation(chip::MutableByteSpan & outBuffer) override;
+    CHIP_ERROR GetDeviceAttestationCert(chip::MutableByteSpan & outBuffer) override;
+    CHIP_ERROR GetProductAttestationIntermediateCert(chip::MutableByteSpan & outBuffer) override;
+    CHIP_ERROR SignWithDeviceAttestationKey(const chip::ByteSpan & messageToSign,
+                                            chip::MutableByteSpan & outSignatureBuffer) override;
+
+private:
+    const FactoryData & mFactoryData;
+};
@@ -0,0 +1,163 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "GroupEndpointIndex.h"
+
+#include <algorithm>
+
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+bool GroupEndpointIndex::MembershipIterator::Next(GroupEndpoint & item)
+{
+    VerifyOrReturnValue(mNext < mMemberships->size(), false);
+    item = (*mMemberships)[mNext++];
+    return true;
+}
+
+void GroupEndpointIndex::MembershipIterator::Release()
+{
+    mIndex.mIterators.ReleaseObject(this);
+}
+
+void GroupEndpointIndex::Finish()
+{
+    mFabrics.clear();
+    GroupDataProviderImpl::Finish();
+}
+
+CHIP_ERROR GroupEndpointIndex::SetGroupInfoAt(FabricIndex fabric, size_t index, const GroupInfo & info)
+{
+    // Replacing the group at `index` drops the endpoints of the previous one.
+    return Reindex(fabric, GroupDataProviderImpl::SetGroupInfoAt(fabric, index, info));
+}
+
+CHIP_ERROR GroupEndpointIndex::RemoveGroupInfoAt(FabricIndex fabric, size_t index)
+{
+    return Reindex(fabric, GroupDataProviderImpl::RemoveGroupInfoAt(fabric, index));
+}
+
+CHIP_ERROR GroupEndpointIndex::RemoveGroupInfo(FabricIndex fabric, GroupId group)
+{
+    return Reindex(fabric, GroupDataProviderImpl::RemoveGroupInfo(fabric, group));
+}
+
+CHIP_ERROR GroupEndpointIndex::AddEndpoint(FabricIndex fabric, GroupId group, EndpointId endpoint)
+{
+    return Reindex(fabric, GroupDataProviderImpl::AddEndpoint(fabric, group, endpoint));
+}
+
+CHIP_ERROR GroupEndpointIndex::RemoveEndpoint(FabricIndex fabric, GroupId group, EndpointId endpoint)
+{
+    return Reindex(fabric, GroupDataProviderImpl::RemoveEndpoint(fabric, group, endpoint));
+}
+
+CHIP_ERROR GroupEndpointIndex::RemoveEndpoint(FabricIndex fabric, EndpointId endpoint)
+{
+    return Reindex(fabric, GroupDataProviderImpl::RemoveEndpoint(fabric, endpoint));
+}
+
+CHIP_ERROR GroupEndpointIndex::RemoveFabric(FabricIndex fabric)
+{
+    mFabrics.erase(fabric);
+    return GroupDataProviderImpl::RemoveFabric(fabric);
+}
+
+bool GroupEndpointIndex::HasEndpoint(FabricIndex fabric, GroupId group, EndpointId endpoint)
+{
+    const EndpointBitmap * bitmap = Lookup(fabric, group);
+    VerifyOrReturnValue(bitmap != nullptr, GroupDataProviderImpl::HasEndpoint(fabric, group, endpoint));
+
+    const size_t word = endpoint / kBitsPerWord;
+    return word < bitmap->size() && ((*bitmap)[word] & (uint64_t(1) << (endpoint % kBitsPerWord))) != 0;
+}
+
+GroupEndpointIndex::EndpointIterator * GroupEndpointIndex::IterateEndpoints(FabricIndex fabric)
+{
+    FabricIndexEntry * entry = GetFabric(fabric);
+    VerifyOrReturnValue(entry != nullptr, GroupDataProviderImpl::IterateEndpoints(fabric));
+    return mIterators.CreateObject(*this, entry->memberships);
+}
+
+GroupEndpointIndex::FabricIndexEntry * GroupEndpointIndex::GetFabric(FabricIndex fabric)
+{
+    auto it = mFabrics.find(fabric);
+    if (it == mFabrics.end())
+    {
+        VerifyOrReturnValue(Rebuild(fabric) == CHIP_NO_ERROR, nullptr);
+        it = mFabrics.find(fabric);
+    }
+    return &it->second;
+}
+
+const GroupEndpointIndex::EndpointBitmap * GroupEndpointIndex::Lookup(FabricIndex fabric, GroupId group)
+{
+    FabricIndexEntry * entry = GetFabric(fabric);
+    VerifyOrReturnValue(entry != nullptr, nullptr);
+
+    auto it = entry->groups.find(group);
+    return (it != entry->groups.end()) ? &it->second : &mNoEndpoints;
+}
+
+CHIP_ERROR GroupEndpointIndex::Rebuild(FabricIndex fabric)
+{
+    mFabrics.erase(fabric);
+
+    EndpointIterator * iterator = GroupDataProviderImpl::IterateEndpoints(fabric);
+    VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    FabricIndexEntry entry;
+    auto memberships = std::make_shared<Memberships>();
+    GroupEndpoint mapping;
+    while (iterator->Next(mapping))
+    {
+        memberships->push_back(mapping);
+
+        EndpointBitmap & bitmap = entry.groups[mapping.group_id];
+        const size_t word       = mapping.endpoint_id / kBitsPerWord;
+        if (bitmap.size() <= word)
+        {
+            bitmap.resize(word + 1, 0);
+        }
+        bitmap[word] |= uint64_t(1) << (mapping.endpoint_id % kBitsPerWord);
+    }
+    iterator->Release();
+
+    std::stable_sort(memberships->begin(), memberships->end(),
+                     [](const GroupEndpoint & a, const GroupEndpoint & b) { return a.group_id < b.group_id; });
+    ChipLogDetail(Zcl, "Group index for fabric %u: %u groups, %u memberships", fabric,
+                  static_cast<unsigned>(entry.groups.size()), static_cast<unsigned>(memberships->size()));
+
+    entry.memberships = std::move(memberships);
+    mFabrics.emplace(fabric, std::move(entry));
+    mRebuilds++;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR GroupEndpointIndex::Reindex(FabricIndex fabric, CHIP_ERROR err)
+{
+    // Rebuild after failures too: the stored provider may have written part of the change.
+    CHIP_ERROR rebuildErr = Rebuild(fabric);
+    if (rebuildErr != CHIP_NO_ERROR)
+    {
+        // Lookups for this fabric fall back to storage until the next successful rebuild.
+        ChipLogError(Zcl, "Failed to index groups of fabric %u: %" CHIP_ERROR_FORMAT, fabric, rebuildErr.Format());
+    }
+    return err;
+}
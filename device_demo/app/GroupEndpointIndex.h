@@ -0,0 +1,168 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <credentials/GroupDataProviderImpl.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Pool.h>
+
+/**
+ * GroupDataProviderImpl with an in-memory group-to-endpoint index.
+ *
+ * The stored provider answers "which endpoints are in group G" by walking every group of the
+ * fabric in persistent storage, and the interaction model does that for every group-addressed
+ * invoke. This layer keeps, per fabric, a bitmap of member endpoints for each group (bit e set
+ * for endpoint e) and a flat list of memberships. The index of a fabric is built on first use
+ * and rebuilt from storage whenever its memberships change, i.e. when the Groups cluster runs
+ * AddGroup, RemoveGroup or RemoveAllGroups, or Group Key Management replaces or removes a group.
+ *
+ * ForEachEndpoint() fans a group out with two hash lookups and a pass over the set bits of its
+ * bitmap, however many groups and endpoints there are. GroupInvokeFanout runs the app's group
+ * commands (OnOff, LevelControl, Scenes RecallScene) through it.
+ *
+ * IterateEndpoints() is served from the membership list instead of storage. The 1.0 interaction
+ * model still walks that list for every group invoke to find the member endpoints it hands the
+ * command to, so that walk stays linear in the fabric's memberships; it no longer touches storage,
+ * and the handlers above absorb all but its first call.
+ *
+ * Only used from the CHIP stack thread.
+ */
+class GroupEndpointIndex : public chip::Credentials::GroupDataProviderImpl
+{
+public:
+    using GroupEndpoint    = chip::Credentials::GroupDataProvider::GroupEndpoint;
+    using EndpointIterator = chip::Credentials::GroupDataProvider::EndpointIterator;
+
+    using GroupDataProviderImpl::GroupDataProviderImpl;
+
+    void Finish() override;
+
+    CHIP_ERROR SetGroupInfoAt(chip::FabricIndex fabric, size_t index, const GroupInfo & info) override;
+    CHIP_ERROR RemoveGroupInfoAt(chip::FabricIndex fabric, size_t index) override;
+    CHIP_ERROR RemoveGroupInfo(chip::FabricIndex fabric, chip::GroupId group) override;
+    CHIP_ERROR AddEndpoint(chip::FabricIndex fabric, chip::GroupId group, chip::EndpointId endpoint) override;
+    CHIP_ERROR RemoveEndpoint(chip::FabricIndex fabric, chip::GroupId group, chip::EndpointId endpoint) override;
+    CHIP_ERROR RemoveEndpoint(chip::FabricIndex fabric, chip::EndpointId endpoint) override;
+    CHIP_ERROR RemoveFabric(chip::FabricIndex fabric) override;
+
+    bool HasEndpoint(chip::FabricIndex fabric, chip::GroupId group, chip::EndpointId endpoint) override;
+    EndpointIterator * IterateEndpoints(chip::FabricIndex fabric) override;
+
+    /**
+     * Calls `function(endpoint)` for every member endpoint of `group`, in ascending order.
+     * `function` must not change group memberships.
+     *
+     * @return the number of endpoints visited.
+     */
+    template <typename Function>
+    size_t ForEachEndpoint(chip::FabricIndex fabric, chip::GroupId group, Function && function)
+    {
+        const EndpointBitmap * bitmap = Lookup(fabric, group);
+        VerifyOrReturnValue(bitmap != nullptr, ForEachStoredEndpoint(fabric, group, function));
+
+        size_t count = 0;
+        for (size_t word = 0; word < bitmap->size(); word++)
+        {
+            for (uint64_t bits = (*bitmap)[word]; bits != 0; bits &= bits - 1)
+            {
+                function(static_cast<chip::EndpointId>(word * kBitsPerWord + static_cast<size_t>(__builtin_ctzll(bits))));
+                count++;
+            }
+        }
+        return count;
+    }
+
+    size_t GetRebuildCount() const { return mRebuilds; }
+
+private:
+    static constexpr size_t kBitsPerWord = 64;
+
+    // Grows to the highest member endpoint id of the group; with the ids of this app (the fixed
+    // endpoints, then the bridged lights) that is a handful of words.
+    using EndpointBitmap = std::vector<uint64_t>;
+    using Memberships    = std::vector<GroupEndpoint>;
+
+    struct FabricIndexEntry
+    {
+        std::unordered_map<chip::GroupId, EndpointBitmap> groups;
+        // Sorted by group. Shared with live iterators, so a rebuild never invalidates one.
+        std::shared_ptr<const Memberships> memberships;
+    };
+
+    class MembershipIterator : public EndpointIterator
+    {
+    public:
+        MembershipIterator(GroupEndpointIndex & index, std::shared_ptr<const Memberships> memberships) :
+            mIndex(index), mMemberships(std::move(memberships))
+        {}
+
+        size_t Count() override { return mMemberships->size(); }
+        bool Next(GroupEndpoint & item) override;
+        void Release() override;
+
+    private:
+        GroupEndpointIndex & mIndex;
+        std::shared_ptr<const Memberships> mMemberships;
+        size_t mNext = 0;
+    };
+
+    // The index of `fabric`, built from storage if needed; nullptr if it cannot be built.
+    FabricIndexEntry * GetFabric(chip::FabricIndex fabric);
+    // The member bitmap of `group`, an empty one for unknown groups, nullptr if not indexed.
+    const EndpointBitmap * Lookup(chip::FabricIndex fabric, chip::GroupId group);
+    CHIP_ERROR Rebuild(chip::FabricIndex fabric);
+    CHIP_ERROR Reindex(chip::FabricIndex fabric, CHIP_ERROR err);
+
+    // Slow path for when the index could not be built.
+    template <typename Function>
+    size_t ForEachStoredEndpoint(chip::FabricIndex fabric, chip::GroupId group, Function & function)
+    {
+        EndpointIterator * iterator = GroupDataProviderImpl::IterateEndpoints(fabric);
+        VerifyOrReturnValue(iterator != nullptr, 0);
+
+        size_t count = 0;
+        GroupEndpoint mapping;
+        while (iterator->Next(mapping))
+        {
+            if (mapping.group_id == group)
+            {
+                function(mapping.endpoint_id);
+                count++;
+            }
+        }
+        iterator->Release();
+        return count;
+    }
+
+    std::unordered_map<chip::FabricIndex, FabricIndexEntry> mFabrics;
+    chip::ObjectPool<MembershipIterator, CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS> mIterators;
+    const EndpointBitmap mNoEndpoints;
+    size_t mRebuilds = 0;
+};
@@ -0,0 +1,60 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "GroupInvokeFanout.h"
+
+#include <access/AccessControl.h>
+#include <app/util/attribute-storage.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include "AccessPrivilegeIndex.h"
+
+using namespace chip;
+using namespace chip::app;
+
+bool GroupInvokeFanout::Begin(const CommandHandler & commandHandler, GroupId group, CommandId command)
+{
+    // The interaction model calls in once per member endpoint; the first call does all of them.
+    VerifyOrReturnValue(mInvoke != &commandHandler || mGroup != group || mCommand != command, false);
+    if (mInvoke == nullptr)
+    {
+        // Runs once the interaction model is done with the whole invoke.
+        DeviceLayer::PlatformMgr().ScheduleWork(Clear, reinterpret_cast<intptr_t>(this));
+    }
+    mInvoke  = &commandHandler;
+    mGroup   = group;
+    mCommand = command;
+    return true;
+}
+
+bool GroupInvokeFanout::CanInvoke(const Access::SubjectDescriptor & subject, EndpointId endpoint, ClusterId cluster,
+                                  CommandId command)
+{
+    // What the interaction model checks before handing an endpoint of a group invoke over.
+    VerifyOrReturnValue(emberAfContainsServer(endpoint, cluster), false);
+
+    const Access::RequestPath requestPath{ .cluster = cluster, .endpoint = endpoint };
+    const Access::Privilege privilege = AccessPrivilegeIndex::ForInvokeCommand(cluster, command);
+    return Access::GetAccessControl().Check(subject, requestPath, privilege) == CHIP_NO_ERROR;
+}
+
+void GroupInvokeFanout::Clear(intptr_t context)
+{
+    GroupInvokeFanout * fanout = reinterpret_cast<GroupInvokeFanout *>(context);
+    fanout->mInvoke            = nullptr;
+}
@@ -0,0 +1,80 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <access/SubjectDescriptor.h>
+#include <app/CommandHandler.h>
+#include <app/ConcreteCommandPath.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/NodeId.h>
+#include <lib/support/CodeUtils.h>
+
+#include "GroupEndpointIndex.h"
+
+/**
+ * Runs a group-addressed invoke on every member endpoint from the first call the handler gets.
+ *
+ * The 1.0 interaction model delivers a group invoke to a command handler once per member
+ * endpoint, which it finds by walking the fabric's memberships (GroupEndpointIndex serves that
+ * walk from memory). Run() applies the command to the whole group on the first of those calls
+ * through GroupEndpointIndex::ForEachEndpoint, and the calls for the remaining endpoints of the
+ * same invoke are absorbed, so the handler does the group in one pass.
+ *
+ * Each handler owns its own instance. Only used from the CHIP stack thread.
+ */
+class GroupInvokeFanout
+{
+public:
+    void Init(GroupEndpointIndex & groups) { mGroups = &groups; }
+
+    /**
+     * For a group-addressed invoke of `path`. On the first call of an invoke, calls
+     * `function(endpoint)` for every member endpoint of the target group that has the server
+     * cluster and on which the subject may invoke the command, and returns true. Returns false
+     * for the calls that follow for the same invoke.
+     */
+    template <typename Function>
+    bool Run(const chip::app::CommandHandler & commandHandler, const chip::app::ConcreteCommandPath & path, Function && function)
+    {
+        const chip::Access::SubjectDescriptor subject = commandHandler.GetSubjectDescriptor();
+        const chip::GroupId group                     = chip::GroupIdFromNodeId(subject.subject);
+        VerifyOrReturnValue(Begin(commandHandler, group, path.mCommandId), false);
+
+        mGroups->ForEachEndpoint(subject.fabricIndex, group, [&](chip::EndpointId endpoint) {
+            if (CanInvoke(subject, endpoint, path.mClusterId, path.mCommandId))
+            {
+                function(endpoint);
+            }
+        });
+        return true;
+    }
+
+private:
+    bool Begin(const chip::app::CommandHandler & commandHandler, chip::GroupId group, chip::CommandId command);
+    static bool CanInvoke(const chip::Access::SubjectDescriptor & subject, chip::EndpointId endpoint, chip::ClusterId cluster,
+                          chip::CommandId command);
+    static void Clear(intptr_t context);
+
+    GroupEndpointIndex * mGroups = nullptr;
+
+    // The group invoke already fanned out in this turn of the event loop.
+    const chip::app::CommandHandler * mInvoke = nullptr;
+    chip::GroupId mGroup                      = 0;
+    chip::CommandId mCommand                  = 0;
+};
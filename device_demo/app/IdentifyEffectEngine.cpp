@@ -0,0 +1,160 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "IdentifyEffectEngine.h"
+
+#include <array>
+
+#include <app-common/zap-generated/attributes/Accessors.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+using chip::System::Clock::Milliseconds16;
+
+namespace {
+
+constexpr uint8_t kOn     = LightOutput::kMaxLevel;
+constexpr uint8_t kOff    = 0;
+constexpr uint8_t kMinLit = 1;
+
+// Fades up and back down once, quadratic in the sample index so the ramp looks even to the eye.
+template <size_t N>
+constexpr std::array<uint8_t, N> MakeBreathe()
+{
+    constexpr uint32_t kHalf = N / 2;
+    std::array<uint8_t, N> samples{};
+    for (size_t i = 0; i < N; i++)
+    {
+        const uint32_t x = static_cast<uint32_t>((i <= kHalf) ? i : N - i);
+        samples[i]       = static_cast<uint8_t>(kOn * x * x / (kHalf * kHalf));
+    }
+    return samples;
+}
+
+constexpr uint8_t kBlinkSamples[] = { kOn, kOff };
+constexpr auto kBreatheSamples    = MakeBreathe<20>();
+constexpr uint8_t kOkaySamples[]  = { kOn, kOff, kOn, kOff };
+// Full brightness for 0.5 s, then the lowest level for 7.5 s.
+constexpr uint8_t kChannelChangeSamples[] = { kOn,     kMinLit, kMinLit, kMinLit, kMinLit, kMinLit, kMinLit, kMinLit,
+                                              kMinLit, kMinLit, kMinLit, kMinLit, kMinLit, kMinLit, kMinLit, kMinLit };
+
+// 0.5 s on, 0.5 s off until IdentifyTime runs out.
+constexpr LightWaveform kIdentifyWaveform = { kBlinkSamples, ArraySize(kBlinkSamples), Milliseconds16(500), 0 };
+
+struct Effect
+{
+    EmberAfIdentifyEffectIdentifier identifier;
+    LightWaveform waveform;
+};
+
+// Durations follow the examples of the Identify cluster specification.
+constexpr Effect kEffects[] = {
+    { EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_BLINK, { kBlinkSamples, ArraySize(kBlinkSamples), Milliseconds16(500), 1 } },
+    { EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_BREATHE, { kBreatheSamples.data(), kBreatheSamples.size(), Milliseconds16(50), 15 } },
+    { EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_OKAY, { kOkaySamples, ArraySize(kOkaySamples), Milliseconds16(250), 1 } },
+    { EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_CHANNEL_CHANGE,
+      { kChannelChangeSamples, ArraySize(kChannelChangeSamples), Milliseconds16(500), 1 } },
+};
+
+} // namespace
+
+IdentifyEffectEngine & IdentifyEffectEngine::GetInstance()
+{
+    static IdentifyEffectEngine sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR IdentifyEffectEngine::Init()
+{
+    VerifyOrReturnError(!mIdentify.HasValue(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(LightDriver::GetInstance().IsRunning(), CHIP_ERROR_INCORRECT_STATE);
+
+    // The identify server only sets IdentifyType at cluster init, before this instance existed.
+    constexpr EmberAfIdentifyIdentifyType kType = EMBER_ZCL_IDENTIFY_IDENTIFY_TYPE_VISIBLE_LIGHT;
+    VerifyOrReturnError(app::Clusters::Identify::Attributes::IdentifyType::Set(LightDriver::kEndpoint, kType) ==
+                            EMBER_ZCL_STATUS_SUCCESS,
+                        CHIP_ERROR_INTERNAL);
+
+    mIdentify.Emplace(LightDriver::kEndpoint, OnIdentifyStart, OnIdentifyStop, kType, OnTriggerEffect);
+    return CHIP_NO_ERROR;
+}
+
+void IdentifyEffectEngine::Shutdown()
+{
+    VerifyOrReturn(mIdentify.HasValue());
+
+    mIdentify.ClearValue();
+    LightDriver::GetInstance().StopWaveform(/* finishPass = */ false);
+}
+
+const LightWaveform * IdentifyEffectEngine::GetEffectWaveform(EmberAfIdentifyEffectIdentifier effect)
+{
+    for (const Effect & entry : kEffects)
+    {
+        if (entry.identifier == effect)
+        {
+            return &entry.waveform;
+        }
+    }
+    return nullptr;
+}
+
+void IdentifyEffectEngine::OnIdentifyStart(Identify * identify)
+{
+    (void) identify;
+    Play(kIdentifyWaveform);
+}
+
+void IdentifyEffectEngine::OnIdentifyStop(Identify * identify)
+{
+    (void) identify;
+    LightDriver::GetInstance().StopWaveform(/* finishPass = */ false);
+}
+
+void IdentifyEffectEngine::OnTriggerEffect(Identify * identify)
+{
+    switch (identify->mCurrentEffectIdentifier)
+    {
+    case EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_FINISH_EFFECT:
+        LightDriver::GetInstance().StopWaveform(/* finishPass = */ true);
+        return;
+    case EMBER_ZCL_IDENTIFY_EFFECT_IDENTIFIER_STOP_EFFECT:
+        LightDriver::GetInstance().StopWaveform(/* finishPass = */ false);
+        return;
+    default:
+        break;
+    }
+
+    const LightWaveform * waveform = GetEffectWaveform(identify->mCurrentEffectIdentifier);
+    if (waveform == nullptr)
+    {
+        ChipLogError(Zcl, "Identify: no pattern for effect 0x%02x", static_cast<unsigned>(identify->mCurrentEffectIdentifier));
+        return;
+    }
+    Play(*waveform);
+}
+
+void IdentifyEffectEngine::Play(const LightWaveform & waveform)
+{
+    CHIP_ERROR err = LightDriver::GetInstance().PlayWaveform(waveform);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Identify: failed to play pattern: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
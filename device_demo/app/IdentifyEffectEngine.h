@@ -0,0 +1,63 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/clusters/identify-server/identify-server.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+
+#include "LightDriver.h"
+
+/**
+ * Shows the Identify cluster of the light endpoint on the light: a steady blink while
+ * IdentifyTime counts down, and the blink, breathe, okay and channel change effects of
+ * TriggerEffect, with finish and stop ending the one playing.
+ *
+ * Every pattern is a precomputed LightWaveform table that the LightDriver thread plays back by
+ * itself, so a blink costs neither a system timer nor an attribute write per toggle; the CHIP
+ * stack thread only takes part when an effect starts or stops. Counting IdentifyTime down stays
+ * with the identify server.
+ *
+ * Only the default effect variant exists, so the variant of TriggerEffect is not used.
+ */
+class IdentifyEffectEngine
+{
+public:
+    static IdentifyEffectEngine & GetInstance();
+
+    /**
+     * Registers with the identify server. Call once LightDriver is running.
+     */
+    CHIP_ERROR Init();
+    void Shutdown();
+
+    /**
+     * The pattern for `effect`, or nullptr for finish, stop and unknown effects.
+     */
+    static const LightWaveform * GetEffectWaveform(EmberAfIdentifyEffectIdentifier effect);
+
+private:
+    static void OnIdentifyStart(Identify * identify);
+    static void OnIdentifyStop(Identify * identify);
+    static void OnTriggerEffect(Identify * identify);
+
+    static void Play(const LightWaveform & waveform);
+
+    chip::Optional<Identify> mIdentify;
+};
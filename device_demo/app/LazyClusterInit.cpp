@@ -0,0 +1,215 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LazyClusterInit.h"
+
+#include <app-common/zap-generated/callback.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/AttributeAccessInterface.h>
+#include <app/CommandHandlerInterface.h>
+#include <app/InteractionModelEngine.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <zap-generated/PluginApplicationCallbacks.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+
+namespace {
+
+// Clusters that a wired Linux light rarely touches; their init is deferred in lazy mode.
+constexpr ClusterId kDeferrableClusters[] = {
+    DiagnosticLogs::Id,           SoftwareDiagnostics::Id, ThreadNetworkDiagnostics::Id, WiFiNetworkDiagnostics::Id,
+    EthernetNetworkDiagnostics::Id, Switch::Id,            OtaSoftwareUpdateRequestor::Id,
+};
+
+} // namespace
+
+/**
+ * Matches every endpoint of one deferred cluster, runs its init on first use, and hands the
+ * request on.
+ */
+class LazyClusterInit::Trigger : public AttributeAccessInterface, public CommandHandlerInterface
+{
+public:
+    explicit Trigger(ClusterId clusterId) :
+        AttributeAccessInterface(NullOptional, clusterId), CommandHandlerInterface(NullOptional, clusterId)
+    {}
+
+    CHIP_ERROR Read(const ConcreteReadAttributePath & aPath, AttributeValueEncoder & aEncoder) override
+    {
+        LazyClusterInit::GetInstance().InitializeNow(aPath.mClusterId);
+
+        // Returning without encoding falls back to attribute storage.
+        AttributeAccessInterface * target = GetAttributeAccessOverride(aPath.mEndpointId, aPath.mClusterId);
+        VerifyOrReturnError(target != nullptr, CHIP_NO_ERROR);
+        return target->Read(aPath, aEncoder);
+    }
+
+    CHIP_ERROR Write(const ConcreteDataAttributePath & aPath, AttributeValueDecoder & aDecoder) override
+    {
+        LazyClusterInit::GetInstance().InitializeNow(aPath.mClusterId);
+
+        // Returning without decoding falls back to attribute storage.
+        AttributeAccessInterface * target = GetAttributeAccessOverride(aPath.mEndpointId, aPath.mClusterId);
+        VerifyOrReturnError(target != nullptr, CHIP_NO_ERROR);
+        return target->Write(aPath, aDecoder);
+    }
+
+    void InvokeCommand(HandlerContext & handlerContext) override
+    {
+        // Leaving the command unhandled lets the engine dispatch it to the now initialized cluster.
+        LazyClusterInit::GetInstance().InitializeNow(handlerContext.mRequestPath.mClusterId);
+    }
+};
+
+LazyClusterInit & LazyClusterInit::GetInstance()
+{
+    static LazyClusterInit sInstance;
+    return sInstance;
+}
+
+LazyClusterInit::DeferredCluster * LazyClusterInit::FindDeferrable(ClusterId clusterId)
+{
+    VerifyOrReturnError(mEnabled, nullptr);
+
+    for (DeferredCluster & cluster : mClusters)
+    {
+        if (cluster.clusterId == clusterId)
+        {
+            return &cluster;
+        }
+    }
+
+    for (ClusterId deferrable : kDeferrableClusters)
+    {
+        if (deferrable == clusterId)
+        {
+            mClusters.emplace_back();
+            mClusters.back().clusterId = clusterId;
+            return &mClusters.back();
+        }
+    }
+    return nullptr;
+}
+
+bool LazyClusterInit::ShouldDeferPluginInit(ClusterId clusterId)
+{
+    DeferredCluster * cluster = FindDeferrable(clusterId);
+    VerifyOrReturnError(cluster != nullptr && CanDefer(*cluster), false);
+
+    cluster->pending        = true;
+    cluster->pluginDeferred = true;
+    return true;
+}
+
+bool LazyClusterInit::ShouldDeferClusterInit(EndpointId endpoint, ClusterId clusterId)
+{
+    DeferredCluster * cluster = FindDeferrable(clusterId);
+    VerifyOrReturnError(cluster != nullptr && CanDefer(*cluster), false);
+
+    cluster->pending = true;
+    cluster->endpoints.push_back(endpoint);
+    return true;
+}
+
+bool LazyClusterInit::CanDefer(const DeferredCluster & cluster) const
+{
+    // Before the triggers exist everything can be deferred. Afterwards (e.g. a dynamic endpoint
+    // being added) only clusters that already have a trigger can, and initialized ones never.
+    return mTriggersRegistered ? cluster.pending : !cluster.initialized;
+}
+
+CHIP_ERROR LazyClusterInit::RegisterTriggers()
+{
+    unsigned deferred = 0;
+    for (DeferredCluster & cluster : mClusters)
+    {
+        if (!cluster.pending || cluster.trigger != nullptr)
+        {
+            continue;
+        }
+
+        cluster.trigger.reset(new Trigger(cluster.clusterId));
+        VerifyOrReturnError(registerAttributeAccessOverride(cluster.trigger.get()), CHIP_ERROR_INCORRECT_STATE);
+        ReturnErrorOnFailure(InteractionModelEngine::GetInstance()->RegisterCommandHandler(cluster.trigger.get()));
+        deferred++;
+    }
+
+    mTriggersRegistered = true;
+    ChipLogProgress(AppServer, "Lazy cluster init: %u clusters deferred until first use", deferred);
+    return CHIP_NO_ERROR;
+}
+
+void LazyClusterInit::RemoveTrigger(DeferredCluster & cluster)
+{
+    VerifyOrReturn(cluster.trigger != nullptr);
+    unregisterAttributeAccessOverride(cluster.trigger.get());
+    InteractionModelEngine::GetInstance()->UnregisterCommandHandler(cluster.trigger.get());
+}
+
+void LazyClusterInit::InitializeNow(ClusterId clusterId)
+{
+    DeferredCluster * cluster = FindDeferrable(clusterId);
+    VerifyOrReturn(cluster != nullptr && cluster->pending);
+
+    ChipLogProgress(AppServer, "Lazy cluster init: initializing cluster " ChipLogFormatMEI " on first use",
+                    ChipLogValueMEI(clusterId));
+
+    // The init callbacks may register their own override/handler for this cluster, which would
+    // collide with the trigger; the trigger object itself stays alive until Shutdown().
+    RemoveTrigger(*cluster);
+    cluster->pending     = false;
+    cluster->initialized = true;
+
+    // Same order as at startup: plugin init, then cluster init on each endpoint.
+    if (cluster->pluginDeferred)
+    {
+        for (const MatterPluginInitEntry & pluginInit : kMatterPluginInitCallbacks)
+        {
+            if (pluginInit.clusterId == clusterId)
+            {
+                pluginInit.init();
+            }
+        }
+    }
+
+    std::vector<EndpointId> endpoints;
+    endpoints.swap(cluster->endpoints);
+    for (EndpointId endpoint : endpoints)
+    {
+        emberAfClusterInitCallback(endpoint, clusterId);
+    }
+}
+
+void LazyClusterInit::Shutdown()
+{
+    for (DeferredCluster & cluster : mClusters)
+    {
+        if (cluster.pending)
+        {
+            RemoveTrigger(cluster);
+        }
+    }
+    mClusters.clear();
+    mEnabled            = false;
+    mTriggersRegistered = false;
+}
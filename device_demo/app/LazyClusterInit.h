@@ -0,0 +1,92 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * Defers the plugin and cluster init callbacks of rarely used clusters until the first
+ * interaction with them (--lazy-cluster-init).
+ *
+ * While enabled, the data model init hooks (DataModelInitHooks.cpp) ask ShouldDeferPluginInit()
+ * and ShouldDeferClusterInit() before every init callback, and skipped callbacks are remembered
+ * per cluster. Once the server is up, RegisterTriggers() installs, for each deferred cluster, an
+ * attribute access override and a command handler matching every endpoint. The first read,
+ * write or invoke on that cluster runs its deferred init callbacks, removes the trigger, and
+ * passes the request on to whatever the init callbacks registered (or to attribute storage /
+ * the generated command dispatch if they registered nothing).
+ *
+ * A deferred cluster does not emit events or attribute reports that its init would have set
+ * up until it is first used.
+ *
+ * Only used from the Matter thread.
+ */
+class LazyClusterInit
+{
+public:
+    static LazyClusterInit & GetInstance();
+
+    /**
+     * Start deferring. Must be called before Server::Init.
+     */
+    void Enable() { mEnabled = true; }
+
+    bool ShouldDeferPluginInit(chip::ClusterId clusterId);
+    bool ShouldDeferClusterInit(chip::EndpointId endpoint, chip::ClusterId clusterId);
+
+    /**
+     * Install the first-use triggers for every cluster whose init was deferred. Call after Server::Init.
+     */
+    CHIP_ERROR RegisterTriggers();
+
+    /**
+     * Run the deferred init callbacks of `clusterId` now, if any are pending.
+     */
+    void InitializeNow(chip::ClusterId clusterId);
+
+    /**
+     * Remove any triggers still installed. Call before Server::Shutdown.
+     */
+    void Shutdown();
+
+private:
+    class Trigger;
+
+    struct DeferredCluster
+    {
+        chip::ClusterId clusterId;
+        bool pending        = false; // some init callback is deferred
+        bool pluginDeferred = false;
+        bool initialized    = false; // deferred callbacks have run
+        std::vector<chip::EndpointId> endpoints; // deferred cluster init callbacks
+        std::unique_ptr<Trigger> trigger;
+    };
+
+    DeferredCluster * FindDeferrable(chip::ClusterId clusterId);
+    bool CanDefer(const DeferredCluster & cluster) const;
+    void RemoveTrigger(DeferredCluster & cluster);
+
+    bool mEnabled            = false;
+    bool mTriggersRegistered = false;
+    std::vector<DeferredCluster> mClusters;
+};
@@ -0,0 +1,405 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LevelControlCommandHandler.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app-common/zap-generated/attributes/Accessors.h>
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app/InteractionModelEngine.h>
+#include <app/clusters/on-off-server/on-off-server.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include "LightDriver.h"
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+using namespace chip::System::Clock;
+using chip::Protocols::InteractionModel::Status;
+
+namespace {
+
+constexpr uint16_t kUseDefaultTransitionTime = 0xFFFF; // in a command's TransitionTime field
+constexpr uint8_t kUseDefaultMoveRate        = 0xFF;   // in a Move command's Rate field
+constexpr uint8_t kOptionExecuteIfOff        = 0x01;   // Options attribute bit
+
+// The Options attribute, with the command's OptionsMask bits taken from OptionsOverride, decides
+// whether a command without OnOff runs while the light is off.
+bool ShouldExecute(EndpointId endpoint, uint8_t optionMask, uint8_t optionOverride)
+{
+    bool on = true;
+    if (OnOff::Attributes::OnOff::Get(endpoint, &on) != EMBER_ZCL_STATUS_SUCCESS || on)
+    {
+        return true;
+    }
+
+    uint8_t options = 0;
+    LevelControl::Attributes::Options::Get(endpoint, &options);
+    const uint8_t effective = static_cast<uint8_t>((options & ~optionMask) | (optionOverride & optionMask));
+    return (effective & kOptionExecuteIfOff) != 0;
+}
+
+void GetLevelBounds(EndpointId endpoint, uint8_t & minLevel, uint8_t & maxLevel)
+{
+    minLevel = 1;
+    maxLevel = LightOutput::kMaxLevel;
+    LevelControl::Attributes::MinLevel::Get(endpoint, &minLevel);
+    LevelControl::Attributes::MaxLevel::Get(endpoint, &maxLevel);
+}
+
+Milliseconds32 FromTenthsOfSeconds(uint32_t tenths)
+{
+    return Milliseconds32(tenths * 100);
+}
+
+} // namespace
+
+LevelControlCommandHandler & LevelControlCommandHandler::GetInstance()
+{
+    static LevelControlCommandHandler sInstance;
+    return sInstance;
+}
+
+LevelControlCommandHandler::LevelControlCommandHandler() : CommandHandlerInterface(NullOptional, LevelControl::Id)
+{
+    std::fill(std::begin(mTurnOffWhenDone), std::end(mTurnOffWhenDone), kInvalidEndpointId);
+}
+
+CHIP_ERROR LevelControlCommandHandler::Init(const LevelTransitionEngine::Config & config, GroupEndpointIndex & groups)
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+
+    mEngine.Init(this, config);
+    mGroupInvoke.Init(groups);
+    ReturnErrorOnFailure(InteractionModelEngine::GetInstance()->RegisterCommandHandler(this));
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void LevelControlCommandHandler::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    InteractionModelEngine::GetInstance()->UnregisterCommandHandler(this);
+    mEngine.Shutdown();
+    mRegistered = false;
+}
+
+void LevelControlCommandHandler::InvokeCommand(HandlerContext & handlerContext)
+{
+    using namespace LevelControl::Commands;
+
+    const bool groupInvoke = handlerContext.mCommandHandler.GetSubjectDescriptor().authMode == Access::AuthMode::kGroup;
+
+    // Group invokes get no response.
+    auto respond = [groupInvoke](HandlerContext & ctx, Status status) {
+        VerifyOrReturn(!groupInvoke);
+        ctx.mCommandHandler.AddStatus(ctx.mRequestPath, status);
+    };
+    // Runs `handle` on the request's endpoint, or on every member endpoint of a group invoke.
+    auto run = [this, groupInvoke, &respond](HandlerContext & ctx, auto && handle) {
+        if (groupInvoke)
+        {
+            mGroupInvoke.Run(ctx.mCommandHandler, ctx.mRequestPath, handle);
+            return;
+        }
+        respond(ctx, handle(ctx.mRequestPath.mEndpointId));
+    };
+
+    // Anything not handled here goes on to the level control server.
+    switch (handlerContext.mRequestPath.mCommandId)
+    {
+    case MoveToLevel::Id:
+        HandleCommand<MoveToLevel::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) {
+                return ShouldExecute(endpoint, request.optionMask, request.optionOverride)
+                    ? HandleMoveToLevel(endpoint, request.level, request.transitionTime, false)
+                    : Status::Success;
+            });
+        });
+        break;
+    case Move::Id:
+        HandleCommand<Move::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) {
+                return ShouldExecute(endpoint, request.optionMask, request.optionOverride)
+                    ? HandleMove(endpoint, request.moveMode == LevelControl::MoveMode::kUp, request.rate, false)
+                    : Status::Success;
+            });
+        });
+        break;
+    case Step::Id:
+        HandleCommand<Step::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) {
+                return ShouldExecute(endpoint, request.optionMask, request.optionOverride)
+                    ? HandleStep(endpoint, request.stepMode == LevelControl::StepMode::kUp, request.stepSize,
+                                 request.transitionTime, false)
+                    : Status::Success;
+            });
+        });
+        break;
+    case Stop::Id:
+        // Only the engine's transitions; the level control server stops its own (those the OnOff
+        // cluster starts). Not fanned out, so that each member endpoint of a group goes its way.
+        VerifyOrReturn(mEngine.IsActive(handlerContext.mRequestPath.mEndpointId));
+        HandleCommand<Stop::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            const EndpointId endpoint = ctx.mRequestPath.mEndpointId;
+            respond(ctx,
+                    ShouldExecute(endpoint, request.optionMask, request.optionOverride) ? HandleStop(endpoint)
+                                                                                        : Status::Success);
+        });
+        break;
+    case MoveToLevelWithOnOff::Id:
+        HandleCommand<MoveToLevelWithOnOff::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) { return HandleMoveToLevel(endpoint, request.level, request.transitionTime, true); });
+        });
+        break;
+    case MoveWithOnOff::Id:
+        HandleCommand<MoveWithOnOff::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) {
+                return HandleMove(endpoint, request.moveMode == LevelControl::MoveMode::kUp, request.rate, true);
+            });
+        });
+        break;
+    case StepWithOnOff::Id:
+        HandleCommand<StepWithOnOff::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto & request) {
+            run(ctx, [&](EndpointId endpoint) {
+                return HandleStep(endpoint, request.stepMode == LevelControl::StepMode::kUp, request.stepSize,
+                                  request.transitionTime, true);
+            });
+        });
+        break;
+    case StopWithOnOff::Id:
+        // As for Stop.
+        VerifyOrReturn(mEngine.IsActive(handlerContext.mRequestPath.mEndpointId));
+        HandleCommand<StopWithOnOff::DecodableType>(handlerContext, [&](HandlerContext & ctx, const auto &) {
+            respond(ctx, HandleStop(ctx.mRequestPath.mEndpointId));
+        });
+        break;
+    default:
+        break;
+    }
+}
+
+bool LevelControlCommandHandler::CancelTransition(EndpointId endpoint)
+{
+    SetTurnOffWhenDone(endpoint, false);
+    return mEngine.Cancel(endpoint);
+}
+
+void LevelControlCommandHandler::OnAttributeChanged(const ConcreteAttributePath & path)
+{
+    VerifyOrReturn(!mWriting);
+
+    const bool onOff = path.mClusterId == OnOff::Id && path.mAttributeId == OnOff::Attributes::OnOff::Id;
+    const bool level = path.mClusterId == LevelControl::Id && path.mAttributeId == LevelControl::Attributes::CurrentLevel::Id;
+    if ((onOff || level) && CancelTransition(path.mEndpointId))
+    {
+        ChipLogProgress(Zcl, "Level transition on endpoint %u cancelled by an external change", path.mEndpointId);
+    }
+}
+
+Status LevelControlCommandHandler::HandleMoveToLevel(EndpointId endpoint, uint8_t level, uint16_t transitionTime, bool withOnOff)
+{
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    GetLevelBounds(endpoint, minLevel, maxLevel);
+
+    Milliseconds32 duration(0);
+    if (transitionTime == kUseDefaultTransitionTime)
+    {
+        // Without an OnOffTransitionTime attribute, move as fast as possible.
+        uint16_t onOffTransitionTime = 0;
+        if (LevelControl::Attributes::OnOffTransitionTime::Get(endpoint, &onOffTransitionTime) == EMBER_ZCL_STATUS_SUCCESS)
+        {
+            duration = FromTenthsOfSeconds(onOffTransitionTime);
+        }
+    }
+    else
+    {
+        duration = FromTenthsOfSeconds(transitionTime);
+    }
+
+    return StartTransition(endpoint, std::min(std::max(level, minLevel), maxLevel), duration, withOnOff);
+}
+
+Status LevelControlCommandHandler::HandleMove(EndpointId endpoint, bool up, uint8_t rate, bool withOnOff)
+{
+    VerifyOrReturnError(rate != 0, Status::InvalidCommand);
+
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    GetLevelBounds(endpoint, minLevel, maxLevel);
+
+    if (rate == kUseDefaultMoveRate)
+    {
+        // Without a DefaultMoveRate, move as fast as possible.
+        app::DataModel::Nullable<uint8_t> defaultMoveRate;
+        const bool hasDefault =
+            LevelControl::Attributes::DefaultMoveRate::Get(endpoint, defaultMoveRate) == EMBER_ZCL_STATUS_SUCCESS &&
+            !defaultMoveRate.IsNull() && defaultMoveRate.Value() != 0;
+        rate = hasDefault ? defaultMoveRate.Value() : 0;
+    }
+
+    const uint8_t current   = GetCurrentLevel(endpoint, minLevel);
+    const uint8_t target    = up ? maxLevel : minLevel;
+    const uint32_t distance = static_cast<uint32_t>((current < target) ? target - current : current - target);
+
+    // Rate is in levels per second.
+    const Milliseconds32 duration((rate != 0) ? distance * 1000 / rate : 0);
+    return StartTransition(endpoint, target, duration, withOnOff);
+}
+
+Status LevelControlCommandHandler::HandleStep(EndpointId endpoint, bool up, uint8_t stepSize, uint16_t transitionTime,
+                                              bool withOnOff)
+{
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    GetLevelBounds(endpoint, minLevel, maxLevel);
+
+    const int current = GetCurrentLevel(endpoint, minLevel);
+    const int target  = up ? std::min(current + stepSize, static_cast<int>(maxLevel))
+                           : std::max(current - stepSize, static_cast<int>(minLevel));
+
+    // As fast as possible without a transition time.
+    const Milliseconds32 duration = (transitionTime == kUseDefaultTransitionTime) ? Milliseconds32(0)
+                                                                                  : FromTenthsOfSeconds(transitionTime);
+    return StartTransition(endpoint, static_cast<uint8_t>(target), duration, withOnOff);
+}
+
+Status LevelControlCommandHandler::HandleStop(EndpointId endpoint)
+{
+    SetTurnOffWhenDone(endpoint, false);
+    mEngine.Stop(endpoint);
+    return Status::Success;
+}
+
+Status LevelControlCommandHandler::StartTransition(EndpointId endpoint, uint8_t target, Milliseconds32 duration, bool withOnOff)
+{
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    GetLevelBounds(endpoint, minLevel, maxLevel);
+    const uint8_t current = GetCurrentLevel(endpoint, minLevel);
+
+    if (withOnOff && target > current)
+    {
+        SetOnOff(endpoint, true);
+    }
+    // Set before starting: a transition without duration completes right away.
+    SetTurnOffWhenDone(endpoint, withOnOff && target == minLevel);
+
+    CHIP_ERROR err = mEngine.Start(endpoint, current, target, duration);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Level transition on endpoint %u failed: %" CHIP_ERROR_FORMAT, endpoint, err.Format());
+        SetTurnOffWhenDone(endpoint, false);
+        return (err == CHIP_ERROR_NO_MEMORY) ? Status::ResourceExhausted : Status::Failure;
+    }
+    return Status::Success;
+}
+
+uint8_t LevelControlCommandHandler::GetCurrentLevel(EndpointId endpoint, uint8_t minLevel) const
+{
+    uint8_t level = minLevel;
+    if (mEngine.GetLevel(endpoint, level))
+    {
+        return level;
+    }
+
+    app::DataModel::Nullable<uint8_t> currentLevel;
+    if (LevelControl::Attributes::CurrentLevel::Get(endpoint, currentLevel) == EMBER_ZCL_STATUS_SUCCESS && !currentLevel.IsNull())
+    {
+        level = currentLevel.Value();
+    }
+    return level;
+}
+
+void LevelControlCommandHandler::SetTurnOffWhenDone(EndpointId endpoint, bool turnOff)
+{
+    EndpointId * free = nullptr;
+    for (EndpointId & entry : mTurnOffWhenDone)
+    {
+        if (entry == endpoint)
+        {
+            entry = turnOff ? endpoint : kInvalidEndpointId;
+            return;
+        }
+        if (entry == kInvalidEndpointId && free == nullptr)
+        {
+            free = &entry;
+        }
+    }
+    // The engine runs at most kMaxTransitions at once, so there is always room.
+    if (turnOff && free != nullptr)
+    {
+        *free = endpoint;
+    }
+}
+
+void LevelControlCommandHandler::SetOnOff(EndpointId endpoint, bool on)
+{
+    mWriting = true;
+    OnOffServer::Instance().setOnOffValue(endpoint, on ? OnOff::Commands::On::Id : OnOff::Commands::Off::Id, true);
+    mWriting = false;
+}
+
+void LevelControlCommandHandler::OnLevelStep(EndpointId endpoint, uint8_t level)
+{
+    if (endpoint == LightDriver::kEndpoint)
+    {
+        LightDriver::GetInstance().ShowLevel(level);
+    }
+}
+
+void LevelControlCommandHandler::OnLevelPublish(EndpointId endpoint, uint8_t level, Milliseconds32 remaining)
+{
+    // RemainingTime is in tenths of a second, rounded up so it only reads 0 once done.
+    const uint32_t tenths = std::min<uint32_t>((remaining.count() + 99) / 100, UINT16_MAX);
+
+    // One data version bump for both, and repeated publishes between reports coalesce.
+    mPublishBatch.Set(endpoint, LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id, ZCL_INT8U_ATTRIBUTE_TYPE, level);
+    mPublishBatch.Set(endpoint, LevelControl::Id, LevelControl::Attributes::RemainingTime::Id, ZCL_INT16U_ATTRIBUTE_TYPE,
+                      static_cast<uint16_t>(tenths));
+    mWriting = true;
+    mPublishBatch.Commit();
+    mWriting = false;
+}
+
+void LevelControlCommandHandler::OnTransitionComplete(EndpointId endpoint, uint8_t level)
+{
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    GetLevelBounds(endpoint, minLevel, maxLevel);
+
+    for (EndpointId & entry : mTurnOffWhenDone)
+    {
+        if (entry == endpoint)
+        {
+            entry = kInvalidEndpointId;
+            if (level == minLevel)
+            {
+                SetOnOff(endpoint, false);
+            }
+            return;
+        }
+    }
+}
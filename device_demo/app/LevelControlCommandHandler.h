@@ -0,0 +1,105 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <app/CommandHandlerInterface.h>
+#include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <protocols/interaction_model/StatusCode.h>
+
+#include "AttributeUpdateBatch.h"
+#include "GroupEndpointIndex.h"
+#include "GroupInvokeFanout.h"
+#include "LevelTransitionEngine.h"
+
+/**
+ * Handles the LevelControl MoveToLevel, Move, Step and Stop commands (and their WithOnOff
+ * variants) on every endpoint, running the transitions on a LevelTransitionEngine instead of
+ * the level control server's per-endpoint timer.
+ *
+ * Each step is shown on the light driver right away; CurrentLevel and RemainingTime are only
+ * written at the engine's publish rate, which bounds the attribute reports a transition causes.
+ * A group-addressed command is fanned out through GroupInvokeFanout, starting the transitions of
+ * all member endpoints from the first call.
+ *
+ * Transitions the OnOff cluster starts itself (On/Off with OnLevel) still run in the level
+ * control server; OnAttributeChanged cancels the engine's transition whenever anything else
+ * changes OnOff or CurrentLevel, so only one of them drives the level at a time. Stop and
+ * StopWithOnOff for an endpoint without an engine transition go on to the level control server,
+ * which stops its own.
+ */
+class LevelControlCommandHandler : public chip::app::CommandHandlerInterface, private LevelTransitionEngine::Delegate
+{
+public:
+    static LevelControlCommandHandler & GetInstance();
+
+    /**
+     * Registers with the interaction model engine. Call after Server::Init; `groups` must be the
+     * server's group data provider.
+     */
+    CHIP_ERROR Init(const LevelTransitionEngine::Config & config, GroupEndpointIndex & groups);
+    void Shutdown();
+
+    void InvokeCommand(HandlerContext & handlerContext) override;
+
+    /**
+     * Drops the running transition of `endpoint`, if any, without writing CurrentLevel or
+     * RemainingTime; for callers that set the level themselves (scene recall). Returns false if
+     * there was none.
+     */
+    bool CancelTransition(chip::EndpointId endpoint);
+
+    /**
+     * Feed from MatterPostAttributeChangeCallback. Changes this handler makes itself are ignored.
+     */
+    void OnAttributeChanged(const chip::app::ConcreteAttributePath & path);
+
+private:
+    LevelControlCommandHandler();
+
+    chip::Protocols::InteractionModel::Status HandleMoveToLevel(chip::EndpointId endpoint, uint8_t level, uint16_t transitionTime,
+                                                                bool withOnOff);
+    chip::Protocols::InteractionModel::Status HandleMove(chip::EndpointId endpoint, bool up, uint8_t rate, bool withOnOff);
+    chip::Protocols::InteractionModel::Status HandleStep(chip::EndpointId endpoint, bool up, uint8_t stepSize,
+                                                         uint16_t transitionTime, bool withOnOff);
+    chip::Protocols::InteractionModel::Status HandleStop(chip::EndpointId endpoint);
+    chip::Protocols::InteractionModel::Status StartTransition(chip::EndpointId endpoint, uint8_t target,
+                                                              chip::System::Clock::Milliseconds32 duration, bool withOnOff);
+
+    uint8_t GetCurrentLevel(chip::EndpointId endpoint, uint8_t minLevel) const;
+    void SetTurnOffWhenDone(chip::EndpointId endpoint, bool turnOff);
+    void SetOnOff(chip::EndpointId endpoint, bool on);
+
+    // LevelTransitionEngine::Delegate
+    void OnLevelStep(chip::EndpointId endpoint, uint8_t level) override;
+    void OnLevelPublish(chip::EndpointId endpoint, uint8_t level, chip::System::Clock::Milliseconds32 remaining) override;
+    void OnTransitionComplete(chip::EndpointId endpoint, uint8_t level) override;
+
+    LevelTransitionEngine mEngine;
+    AttributeUpdateBatch mPublishBatch;
+    GroupInvokeFanout mGroupInvoke;
+    bool mRegistered = false;
+    bool mWriting    = false; // set while this handler writes OnOff or CurrentLevel itself
+
+    // Endpoints whose running WithOnOff transition turns the light off if it ends at MinLevel.
+    chip::EndpointId mTurnOffWhenDone[LevelTransitionEngine::kMaxTransitions];
+};
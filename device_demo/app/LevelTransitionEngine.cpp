@@ -0,0 +1,338 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LevelTransitionEngine.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+
+using namespace chip;
+using namespace chip::System::Clock;
+
+namespace {
+
+uint32_t ToTicks(Milliseconds32 duration)
+{
+    const uint32_t tick = LevelTransitionEngine::kTick.count();
+    return (duration.count() + tick - 1) / tick;
+}
+
+} // namespace
+
+void LevelTransitionEngine::Init(Delegate * delegate, const Config & config)
+{
+    mDelegate     = delegate;
+    mStepTicks    = std::max<uint32_t>(ToTicks(config.stepInterval), 1);
+    mPublishTicks = std::max<uint32_t>(ToTicks(config.publishInterval), 1);
+
+    mFree = nullptr;
+    for (Transition & transition : mTransitions)
+    {
+        transition.next = mFree;
+        mFree           = &transition;
+    }
+    mByEndpoint.reserve(kMaxTransitions);
+}
+
+void LevelTransitionEngine::Shutdown()
+{
+    DeviceLayer::SystemLayer().CancelTimer(OnTick, this);
+    for (Transition & transition : mTransitions)
+    {
+        transition = Transition();
+    }
+    std::fill(std::begin(mWheel), std::end(mWheel), nullptr);
+    mByEndpoint.clear();
+    mFree        = nullptr;
+    mActiveCount = 0;
+    mDelegate    = nullptr;
+}
+
+CHIP_ERROR LevelTransitionEngine::Start(EndpointId endpoint, uint8_t from, uint8_t to, Milliseconds32 duration)
+{
+    VerifyOrReturnError(mDelegate != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Transition * transition = Find(endpoint);
+    if (transition != nullptr)
+    {
+        Unschedule(*transition);
+    }
+    else
+    {
+        VerifyOrReturnError(mFree != nullptr, CHIP_ERROR_NO_MEMORY);
+        transition = mFree;
+        mFree      = transition->next;
+        if (mActiveCount++ == 0)
+        {
+            mEpoch = System::SystemClock().GetMonotonicTimestamp();
+            mTick  = 0;
+        }
+        transition->endpoint  = endpoint;
+        transition->next      = nullptr;
+        mByEndpoint[endpoint] = transition;
+    }
+
+    const uint32_t durationTicks = ToTicks(duration);
+    const uint32_t distance      = static_cast<uint32_t>((from < to) ? to - from : from - to);
+
+    transition->target          = to;
+    transition->level           = from;
+    transition->startQ16        = static_cast<int32_t>(from) << 16;
+    transition->deltaQ16        = (static_cast<int32_t>(to) - static_cast<int32_t>(from)) * (1 << 16);
+    // mTick lags while the timer sleeps until the next step; later ticks are still visited in order.
+    transition->startTick       = std::max(mTick, CurrentTick());
+    transition->durationTicks   = durationTicks;
+    transition->lastPublishTick = transition->startTick;
+    // No point stepping more often than the level can change.
+    transition->steps = std::min(std::max<uint32_t>(durationTicks / mStepTicks, 1), std::max<uint32_t>(distance, 1));
+    transition->step  = 0;
+
+    if (durationTicks == 0 || distance == 0)
+    {
+        Finish(*transition);
+        return CHIP_NO_ERROR;
+    }
+
+    mDelegate->OnLevelPublish(endpoint, from, Milliseconds32(durationTicks * kTick.count()));
+
+    transition->deadline = transition->startTick + transition->durationTicks / transition->steps;
+    Schedule(*transition);
+    ArmTimer();
+    return CHIP_NO_ERROR;
+}
+
+bool LevelTransitionEngine::Stop(EndpointId endpoint)
+{
+    Transition * transition = Find(endpoint);
+    VerifyOrReturnError(transition != nullptr, false);
+
+    const uint8_t level = transition->level;
+    Cancel(endpoint);
+    mDelegate->OnLevelPublish(endpoint, level, Milliseconds32(0));
+    return true;
+}
+
+bool LevelTransitionEngine::Cancel(EndpointId endpoint)
+{
+    Transition * transition = Find(endpoint);
+    VerifyOrReturnError(transition != nullptr, false);
+
+    Unschedule(*transition);
+    Release(*transition);
+    if (mActiveCount == 0)
+    {
+        DeviceLayer::SystemLayer().CancelTimer(OnTick, this);
+    }
+    return true;
+}
+
+bool LevelTransitionEngine::GetLevel(EndpointId endpoint, uint8_t & level) const
+{
+    const Transition * transition = Find(endpoint);
+    VerifyOrReturnError(transition != nullptr, false);
+    level = transition->level;
+    return true;
+}
+
+LevelTransitionEngine::Transition * LevelTransitionEngine::Find(EndpointId endpoint) const
+{
+    const auto it = mByEndpoint.find(endpoint);
+    return (it != mByEndpoint.end()) ? it->second : nullptr;
+}
+
+uint32_t LevelTransitionEngine::CurrentTick() const
+{
+    const Timestamp elapsed = System::SystemClock().GetMonotonicTimestamp() - mEpoch;
+    return static_cast<uint32_t>(elapsed.count() / kTick.count());
+}
+
+void LevelTransitionEngine::Schedule(Transition & transition)
+{
+    Transition *& slot   = mWheel[transition.deadline % kWheelSlots];
+    transition.next      = slot;
+    transition.scheduled = true;
+    slot                 = &transition;
+}
+
+void LevelTransitionEngine::Unschedule(Transition & transition)
+{
+    VerifyOrReturn(transition.scheduled);
+    for (Transition ** link = &mWheel[transition.deadline % kWheelSlots]; *link != nullptr; link = &(*link)->next)
+    {
+        if (*link == &transition)
+        {
+            *link = transition.next;
+            break;
+        }
+    }
+    transition.next      = nullptr;
+    transition.scheduled = false;
+}
+
+void LevelTransitionEngine::Release(Transition & transition)
+{
+    mByEndpoint.erase(transition.endpoint);
+    transition      = Transition();
+    transition.next = mFree;
+    mFree           = &transition;
+    mActiveCount--;
+}
+
+void LevelTransitionEngine::OnTick(System::Layer * layer, void * context)
+{
+    (void) layer;
+    LevelTransitionEngine * self = static_cast<LevelTransitionEngine *>(context);
+
+    // Catch up with every tick that has passed, including any the timer slept through.
+    const uint32_t now = self->CurrentTick();
+    while (self->mTick < now && self->mActiveCount > 0)
+    {
+        self->mTick++;
+
+        // Take the slot's list apart first: delegate callbacks may start or stop transitions.
+        Transition * due[kMaxTransitions];
+        size_t dueCount   = 0;
+        Transition * list = self->mWheel[self->mTick % kWheelSlots];
+        self->mWheel[self->mTick % kWheelSlots] = nullptr;
+        while (list != nullptr)
+        {
+            Transition * transition = list;
+            list                    = transition->next;
+            transition->next        = nullptr;
+            transition->scheduled   = false;
+            if (transition->deadline == self->mTick)
+            {
+                due[dueCount++] = transition;
+            }
+            else
+            {
+                self->Schedule(*transition); // a later turn of the wheel
+            }
+        }
+
+        for (size_t i = 0; i < dueCount; i++)
+        {
+            Transition * transition = due[i];
+            if (!transition->scheduled && transition->endpoint != kInvalidEndpointId && transition->deadline == self->mTick)
+            {
+                self->Advance(*transition);
+            }
+        }
+    }
+
+    if (self->mActiveCount > 0)
+    {
+        self->ArmTimer();
+    }
+}
+
+void LevelTransitionEngine::Advance(Transition & transition)
+{
+    transition.step++;
+    if (transition.step >= transition.steps)
+    {
+        Finish(transition);
+        return;
+    }
+
+    const int64_t levelQ16 =
+        transition.startQ16 + static_cast<int64_t>(transition.deltaQ16) * transition.step / static_cast<int64_t>(transition.steps);
+    const uint8_t level = static_cast<uint8_t>((levelQ16 + (1 << 15)) >> 16);
+
+    const EndpointId endpoint = transition.endpoint;
+    if (level != transition.level)
+    {
+        transition.level = level;
+        mDelegate->OnLevelStep(endpoint, level);
+    }
+    if (mTick - transition.lastPublishTick >= mPublishTicks)
+    {
+        transition.lastPublishTick = mTick;
+        mDelegate->OnLevelPublish(endpoint, level, Remaining(transition));
+    }
+
+    // Step k is due at startTick + k * durationTicks / steps, so timing does not drift either.
+    transition.deadline = transition.startTick +
+        static_cast<uint32_t>(static_cast<uint64_t>(transition.durationTicks) * (transition.step + 1) / transition.steps);
+    Schedule(transition);
+}
+
+void LevelTransitionEngine::Finish(Transition & transition)
+{
+    const EndpointId endpoint = transition.endpoint;
+    const uint8_t target      = transition.target;
+    const bool changed        = (transition.level != target);
+    Release(transition);
+
+    if (changed)
+    {
+        mDelegate->OnLevelStep(endpoint, target);
+    }
+    mDelegate->OnLevelPublish(endpoint, target, Milliseconds32(0));
+    mDelegate->OnTransitionComplete(endpoint, target);
+}
+
+void LevelTransitionEngine::ArmTimer()
+{
+    // Sleep until the earliest step instead of ticking through empty slots. Starting the timer
+    // again replaces the pending one.
+    const uint32_t nextTick = NextDeadline();
+    VerifyOrReturn(nextTick != UINT32_MAX);
+
+    const Timestamp deadline = mEpoch + Milliseconds64(static_cast<uint64_t>(nextTick) * kTick.count());
+    const Timestamp now      = System::SystemClock().GetMonotonicTimestamp();
+    const Timestamp delay    = (deadline > now) ? deadline - now : Timestamp(0);
+
+    DeviceLayer::SystemLayer().StartTimer(std::chrono::duration_cast<Milliseconds32>(delay), OnTick, this);
+}
+
+uint32_t LevelTransitionEngine::NextDeadline() const
+{
+    // Every deadline is after mTick. Walk the slots of the next turn in order; an entry of a slot
+    // may be one or more turns further out, so it only counts if it is due on that very tick.
+    for (uint32_t tick = mTick + 1; tick <= mTick + kWheelSlots; tick++)
+    {
+        for (const Transition * transition = mWheel[tick % kWheelSlots]; transition != nullptr; transition = transition->next)
+        {
+            if (transition->deadline == tick)
+            {
+                return tick;
+            }
+        }
+    }
+
+    // Nothing is due within a turn: the earliest of the scheduled transitions.
+    uint32_t nextTick = UINT32_MAX;
+    for (const Transition * slot : mWheel)
+    {
+        for (const Transition * transition = slot; transition != nullptr; transition = transition->next)
+        {
+            nextTick = std::min(nextTick, transition->deadline);
+        }
+    }
+    return nextTick;
+}
+
+Milliseconds32 LevelTransitionEngine::Remaining(const Transition & transition) const
+{
+    const uint32_t endTick = transition.startTick + transition.durationTicks;
+    return Milliseconds32((endTick > mTick) ? (endTick - mTick) * kTick.count() : 0);
+}
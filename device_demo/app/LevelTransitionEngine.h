@@ -0,0 +1,150 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+/**
+ * Runs level transitions for any number of endpoints off a single hashed timer wheel.
+ *
+ * The wheel turns in kTick steps on one system timer, which sleeps until the earliest pending
+ * step. Each transition sits in the wheel slot of its next step and is only visited on that
+ * tick, so slow transitions cost nothing in between. The earliest step is found by looking one
+ * turn ahead in the wheel, and transitions are found by endpoint through a map, so neither
+ * depends on kMaxTransitions. Levels are interpolated in 16.16 fixed point from the start of
+ * the transition, so rounding never accumulates, and the last step always lands exactly on the
+ * target.
+ *
+ * The delegate sees every step (OnLevelStep, e.g. to drive hardware) but only a bounded rate
+ * of OnLevelPublish calls, meant for attribute writes and the reports they cause.
+ *
+ * All methods must be called from the CHIP stack thread.
+ */
+class LevelTransitionEngine
+{
+public:
+    static constexpr chip::System::Clock::Milliseconds32 kTick{ 10 };
+    static constexpr size_t kWheelSlots = 64;
+    // Enough for a group command that reaches the light and every bridged light at once.
+    static constexpr size_t kMaxTransitions = 1 + CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT;
+
+    struct Config
+    {
+        // Shortest time between two steps of one transition, rounded up to whole ticks.
+        chip::System::Clock::Milliseconds32 stepInterval{ 20 };
+        // Shortest time between two OnLevelPublish calls for one transition.
+        chip::System::Clock::Milliseconds32 publishInterval{ 100 };
+    };
+
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        // Every level change, at the step resolution.
+        virtual void OnLevelStep(chip::EndpointId endpoint, uint8_t level) = 0;
+        // At most once per publishInterval while running, and always at the start and end.
+        virtual void OnLevelPublish(chip::EndpointId endpoint, uint8_t level, chip::System::Clock::Milliseconds32 remaining) = 0;
+        // The transition reached its target (not called on Stop).
+        virtual void OnTransitionComplete(chip::EndpointId endpoint, uint8_t level) = 0;
+    };
+
+    void Init(Delegate * delegate, const Config & config);
+    void Shutdown();
+
+    /**
+     * Starts moving `endpoint` from `from` to `to` over `duration`, replacing any transition it
+     * already had. A zero duration applies `to` right away.
+     */
+    CHIP_ERROR Start(chip::EndpointId endpoint, uint8_t from, uint8_t to, chip::System::Clock::Milliseconds32 duration);
+
+    /**
+     * Stops the transition of `endpoint` where it is and publishes that level. Returns false if
+     * it had none.
+     */
+    bool Stop(chip::EndpointId endpoint);
+
+    /**
+     * Drops the transition of `endpoint` without publishing anything, for callers that write
+     * the level themselves. Returns false if it had none.
+     */
+    bool Cancel(chip::EndpointId endpoint);
+
+    bool IsActive(chip::EndpointId endpoint) const { return Find(endpoint) != nullptr; }
+
+    /**
+     * The level the transition of `endpoint` has reached, which may be ahead of the last
+     * published one. Returns false if it has no transition.
+     */
+    bool GetLevel(chip::EndpointId endpoint, uint8_t & level) const;
+
+private:
+    struct Transition
+    {
+        chip::EndpointId endpoint = chip::kInvalidEndpointId;
+        uint8_t target            = 0;
+        uint8_t level             = 0; // last level passed to OnLevelStep
+        int32_t startQ16          = 0; // 16.16 fixed point
+        int32_t deltaQ16          = 0;
+        uint32_t startTick        = 0;
+        uint32_t durationTicks    = 0;
+        uint32_t steps            = 0;
+        uint32_t step             = 0; // steps taken so far
+        uint32_t deadline         = 0; // tick of the next step
+        uint32_t lastPublishTick  = 0;
+        bool scheduled            = false;
+        Transition * next         = nullptr; // within its wheel slot, or the free list
+    };
+
+    static void OnTick(chip::System::Layer * layer, void * context);
+
+    Transition * Find(chip::EndpointId endpoint) const;
+    uint32_t CurrentTick() const;
+    void Schedule(Transition & transition);
+    void Unschedule(Transition & transition);
+    void Advance(Transition & transition);
+    void Finish(Transition & transition);
+    void Release(Transition & transition);
+    void ArmTimer();
+    uint32_t NextDeadline() const;
+    chip::System::Clock::Milliseconds32 Remaining(const Transition & transition) const;
+
+    Delegate * mDelegate = nullptr;
+    uint32_t mStepTicks    = 1;
+    uint32_t mPublishTicks = 1;
+
+    Transition mTransitions[kMaxTransitions];
+    Transition * mWheel[kWheelSlots] = {};
+    Transition * mFree               = nullptr;
+    size_t mActiveCount              = 0;
+    std::unordered_map<chip::EndpointId, Transition *> mByEndpoint;
+
+    // Tick 0 of the wheel, reset whenever it starts turning from idle.
+    chip::System::Clock::Timestamp mEpoch;
+    uint32_t mTick = 0; // last tick processed
+};
@@ -6,6 +6,7 @@
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <platform/internal/CHIPDeviceLayerInternal.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -17,6 +18,15 @@ namespace DeviceLayer {
 namespace {
 constexpr TLV::Tag kLabelNameTag  = TLV::ContextTag(0);
 constexpr TLV::Tag kLabelValueTag = TLV::ContextTag(1);
+
+// All user labels of an endpoint, packed as one TLV array of label structures. Replaces the
+// older UserLabelLengthKey + one UserLabelIndexKey per entry layout.
+template <size_t N>
+const char * UserLabelListKey(char (&key)[N], EndpointId endpoint)
+{
+    snprintf(key, N, "g/userlbls/%x", endpoint);
+    return key;
+}
 } // anonymous namespace
 
 LightDeviceInfoProvider & LightDeviceInfoProvider::GetDefaultInstance()
@@ -101,98 +111,256 @@ bool LightDeviceInfoProvider::FixedLabelIteratorImpl::Next(FixedLabelType & outp
     return retval;
 }
 
+CHIP_ERROR LightDeviceInfoProvider::SetUserLabelList(EndpointId endpoint, Span<const UserLabelType> labels)
+{
+    VerifyOrReturnError(labels.size() <= kMaxUserLabelListLength, CHIP_ERROR_INVALID_LIST_LENGTH);
+
+    UserLabelList list;
+    for (const UserLabelType & label : labels)
+    {
+        VerifyOrReturnError(label.label.size() <= kMaxLabelNameLength, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(label.value.size() <= kMaxLabelValueLength, CHIP_ERROR_INVALID_ARGUMENT);
+        Platform::CopyString(list.entries[list.count].label, label.label);
+        Platform::CopyString(list.entries[list.count].value, label.value);
+        list.count++;
+    }
+
+    return StoreUserLabelList(endpoint, list);
+}
+
+// Every override below stores the whole packed record at once, so storage always holds a
+// complete list, whichever sequence of calls DeviceInfoProvider makes and wherever it stops.
 CHIP_ERROR LightDeviceInfoProvider::SetUserLabelLength(EndpointId endpoint, size_t val)
 {
-    DefaultStorageKeyAllocator keyAlloc;
+    VerifyOrReturnError(val <= kMaxUserLabelListLength, CHIP_ERROR_INVALID_LIST_LENGTH);
 
-    return mStorage->SyncSetKeyValue(keyAlloc.UserLabelLengthKey(endpoint), &val, static_cast<uint16_t>(sizeof(val)));
+    UserLabelList list;
+    ReturnErrorOnFailure(LoadUserLabelList(endpoint, list));
+    VerifyOrReturnError(val != list.count, CHIP_NO_ERROR);
+
+    for (size_t i = list.count; i < val; i++)
+    {
+        list.entries[i] = UserLabelList::Entry();
+    }
+    list.count = val;
+
+    return StoreUserLabelList(endpoint, list);
 }
 
 CHIP_ERROR LightDeviceInfoProvider::GetUserLabelLength(EndpointId endpoint, size_t & val)
 {
-    DefaultStorageKeyAllocator keyAlloc;
-    uint16_t len = static_cast<uint16_t>(sizeof(val));
-
-    return mStorage->SyncGetKeyValue(keyAlloc.UserLabelLengthKey(endpoint), &val, len);
+    UserLabelList list;
+    ReturnErrorOnFailure(LoadUserLabelList(endpoint, list));
+    val = list.count;
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR LightDeviceInfoProvider::SetUserLabelAt(EndpointId endpoint, size_t index, const UserLabelType & userLabel)
 {
-    DefaultStorageKeyAllocator keyAlloc;
-    uint8_t buf[UserLabelTLVMaxSize()];
-    TLV::TLVWriter writer;
-    writer.Init(buf);
+    VerifyOrReturnError(index < kMaxUserLabelListLength, CHIP_ERROR_INVALID_LIST_LENGTH);
+    VerifyOrReturnError(userLabel.label.size() <= kMaxLabelNameLength, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(userLabel.value.size() <= kMaxLabelValueLength, CHIP_ERROR_INVALID_ARGUMENT);
 
-    TLV::TLVType outerType;
-    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
-    ReturnErrorOnFailure(writer.PutString(kLabelNameTag, userLabel.label));
-    ReturnErrorOnFailure(writer.PutString(kLabelValueTag, userLabel.value));
-    ReturnErrorOnFailure(writer.EndContainer(outerType));
+    UserLabelList list;
+    ReturnErrorOnFailure(LoadUserLabelList(endpoint, list));
+    for (size_t i = list.count; i < index; i++)
+    {
+        list.entries[i] = UserLabelList::Entry();
+    }
+    if (index >= list.count)
+    {
+        list.count = index + 1;
+    }
+    Platform::CopyString(list.entries[index].label, userLabel.label);
+    Platform::CopyString(list.entries[index].value, userLabel.value);
 
-    return mStorage->SyncSetKeyValue(keyAlloc.UserLabelIndexKey(endpoint, index), buf,
-                                     static_cast<uint16_t>(writer.GetLengthWritten()));
+    return StoreUserLabelList(endpoint, list);
 }
 
 CHIP_ERROR LightDeviceInfoProvider::DeleteUserLabelAt(EndpointId endpoint, size_t index)
 {
-    DefaultStorageKeyAllocator keyAlloc;
+    UserLabelList list;
+    ReturnErrorOnFailure(LoadUserLabelList(endpoint, list));
 
-    return mStorage->SyncDeleteKeyValue(keyAlloc.UserLabelIndexKey(endpoint, index));
+    // DeviceInfoProvider deletes by index without expecting the entries behind to move:
+    // ClearUserLabelList goes up from 0, SetUserLabelList trims from the end after shrinking
+    // the length. Truncating keeps every lower index where it was, and each of those sequences
+    // ends in a single write of the shortened list.
+    VerifyOrReturnError(index < list.count, CHIP_NO_ERROR);
+    list.count = index;
+
+    return StoreUserLabelList(endpoint, list);
 }
 
-DeviceInfoProvider::UserLabelIterator * LightDeviceInfoProvider::IterateUserLabel(EndpointId endpoint)
+CHIP_ERROR LightDeviceInfoProvider::LoadUserLabelList(EndpointId endpoint, UserLabelList & list)
 {
-    return chip::Platform::New<UserLabelIteratorImpl>(*this, endpoint);
+    auto it = mUserLabelCache.find(endpoint);
+    if (it != mUserLabelCache.end())
+    {
+        list = it->second;
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(ReadUserLabelList(endpoint, list));
+    mUserLabelCache[endpoint] = list;
+    return CHIP_NO_ERROR;
 }
 
-LightDeviceInfoProvider::UserLabelIteratorImpl::UserLabelIteratorImpl(LightDeviceInfoProvider & provider, EndpointId endpoint) :
-    mProvider(provider), mEndpoint(endpoint)
+CHIP_ERROR LightDeviceInfoProvider::ReadUserLabelList(EndpointId endpoint, UserLabelList & list)
 {
-    size_t total = 0;
+    char key[PersistentStorageDelegate::kKeyLengthMax + 1];
+    uint8_t buf[UserLabelListTLVMaxSize()];
+    uint16_t len = static_cast<uint16_t>(sizeof(buf));
 
-    ReturnOnFailure(mProvider.GetUserLabelLength(mEndpoint, total));
-    mTotal = total;
-    mIndex = 0;
+    list.count = 0;
+
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(UserLabelListKey(key, endpoint), buf, len);
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        return MigrateLegacyUserLabels(endpoint, list);
+    }
+    ReturnErrorOnFailure(err);
+
+    TLV::ContiguousBufferTLVReader reader;
+    reader.Init(buf, len);
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, TLV::AnonymousTag()));
+
+    TLV::TLVType arrayType;
+    ReturnErrorOnFailure(reader.EnterContainer(arrayType));
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        VerifyOrReturnError(list.count < kMaxUserLabelListLength, CHIP_ERROR_INVALID_LIST_LENGTH);
+        ReturnErrorOnFailure(DecodeUserLabel(reader, list.entries[list.count]));
+        list.count++;
+    }
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+
+    return reader.ExitContainer(arrayType);
 }
 
-bool LightDeviceInfoProvider::UserLabelIteratorImpl::Next(UserLabelType & output)
+CHIP_ERROR LightDeviceInfoProvider::StoreUserLabelList(EndpointId endpoint, const UserLabelList & list)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
+    char key[PersistentStorageDelegate::kKeyLengthMax + 1];
+    uint8_t buf[UserLabelListTLVMaxSize()];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
 
-    VerifyOrReturnError(mIndex < mTotal, false);
+    TLV::TLVType arrayType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, arrayType));
+    for (size_t i = 0; i < list.count; i++)
+    {
+        TLV::TLVType outerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+        ReturnErrorOnFailure(writer.PutString(kLabelNameTag, list.entries[i].label));
+        ReturnErrorOnFailure(writer.PutString(kLabelValueTag, list.entries[i].value));
+        ReturnErrorOnFailure(writer.EndContainer(outerType));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(arrayType));
 
+    CHIP_ERROR err =
+        mStorage->SyncSetKeyValue(UserLabelListKey(key, endpoint), buf, static_cast<uint16_t>(writer.GetLengthWritten()));
+    if (err != CHIP_NO_ERROR)
+    {
+        // What made it to storage is unknown: drop the entry so the next access reads it back.
+        mUserLabelCache.erase(endpoint);
+        return err;
+    }
+
+    mUserLabelCache[endpoint] = list;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LightDeviceInfoProvider::MigrateLegacyUserLabels(EndpointId endpoint, UserLabelList & list)
+{
     DefaultStorageKeyAllocator keyAlloc;
-    uint8_t buf[UserLabelTLVMaxSize()];
-    uint16_t len = static_cast<uint16_t>(sizeof(buf));
+    size_t legacyLength = 0;
+    uint16_t len        = static_cast<uint16_t>(sizeof(legacyLength));
 
-    err = mProvider.mStorage->SyncGetKeyValue(keyAlloc.UserLabelIndexKey(mEndpoint, mIndex), buf, len);
-    VerifyOrReturnError(err == CHIP_NO_ERROR, false);
+    list.count = 0;
 
-    TLV::ContiguousBufferTLVReader reader;
-    reader.Init(buf);
-    err = reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag());
-    VerifyOrReturnError(err == CHIP_NO_ERROR, false);
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(keyAlloc.UserLabelLengthKey(endpoint), &legacyLength, len);
+    VerifyOrReturnError(err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND, CHIP_NO_ERROR);
+    ReturnErrorOnFailure(err);
+
+    // Same as the old iterator: the list ends at the first entry that cannot be read back.
+    while (list.count < legacyLength && list.count < kMaxUserLabelListLength)
+    {
+        uint8_t buf[UserLabelTLVMaxSize()];
+        TLV::ContiguousBufferTLVReader reader;
+
+        len = static_cast<uint16_t>(sizeof(buf));
+        if (mStorage->SyncGetKeyValue(keyAlloc.UserLabelIndexKey(endpoint, list.count), buf, len) != CHIP_NO_ERROR)
+        {
+            break;
+        }
+
+        reader.Init(buf, len);
+        if (reader.Next() != CHIP_NO_ERROR || DecodeUserLabel(reader, list.entries[list.count]) != CHIP_NO_ERROR)
+        {
+            break;
+        }
+        list.count++;
+    }
+
+    // Write the packed record before dropping the old keys: if we stop in between, the packed
+    // record is what gets read from then on and the leftover keys are never looked at again.
+    ReturnErrorOnFailure(StoreUserLabelList(endpoint, list));
+
+    mStorage->SyncDeleteKeyValue(keyAlloc.UserLabelLengthKey(endpoint));
+    for (size_t i = 0; i < legacyLength && i < kMaxUserLabelListLength; i++)
+    {
+        mStorage->SyncDeleteKeyValue(keyAlloc.UserLabelIndexKey(endpoint, i));
+    }
+
+    ChipLogProgress(DeviceLayer, "Migrated %u user labels on endpoint %u to a single record", static_cast<unsigned>(list.count),
+                    endpoint);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LightDeviceInfoProvider::DecodeUserLabel(TLV::ContiguousBufferTLVReader & reader, UserLabelList::Entry & entry)
+{
+    VerifyOrReturnError(reader.GetType() == TLV::kTLVType_Structure, CHIP_ERROR_WRONG_TLV_TYPE);
 
     TLV::TLVType containerType;
-    VerifyOrReturnError(reader.EnterContainer(containerType) == CHIP_NO_ERROR, false);
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
 
     chip::CharSpan label;
     chip::CharSpan value;
 
-    VerifyOrReturnError(reader.Next(kLabelNameTag) == CHIP_NO_ERROR, false);
-    VerifyOrReturnError(reader.Get(label) == CHIP_NO_ERROR, false);
+    ReturnErrorOnFailure(reader.Next(kLabelNameTag));
+    ReturnErrorOnFailure(reader.Get(label));
+
+    ReturnErrorOnFailure(reader.Next(kLabelValueTag));
+    ReturnErrorOnFailure(reader.Get(value));
 
-    VerifyOrReturnError(reader.Next(kLabelValueTag) == CHIP_NO_ERROR, false);
-    VerifyOrReturnError(reader.Get(value) == CHIP_NO_ERROR, false);
+    ReturnErrorOnFailure(reader.VerifyEndOfContainer());
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
 
-    VerifyOrReturnError(reader.VerifyEndOfContainer() == CHIP_NO_ERROR, false);
-    VerifyOrReturnError(reader.ExitContainer(containerType) == CHIP_NO_ERROR, false);
+    Platform::CopyString(entry.label, label);
+    Platform::CopyString(entry.value, value);
 
-    Platform::CopyString(mUserLabelNameBuf, label);
-    Platform::CopyString(mUserLabelValueBuf, value);
+    return CHIP_NO_ERROR;
+}
+
+DeviceInfoProvider::UserLabelIterator * LightDeviceInfoProvider::IterateUserLabel(EndpointId endpoint)
+{
+    return chip::Platform::New<UserLabelIteratorImpl>(*this, endpoint);
+}
+
+LightDeviceInfoProvider::UserLabelIteratorImpl::UserLabelIteratorImpl(LightDeviceInfoProvider & provider, EndpointId endpoint) :
+    mProvider(provider), mEndpoint(endpoint)
+{
+    // Served from the cache; only the first access to an endpoint reads storage.
+    ReturnOnFailure(mProvider.LoadUserLabelList(mEndpoint, mList));
+    mIndex = 0;
+}
+
+bool LightDeviceInfoProvider::UserLabelIteratorImpl::Next(UserLabelType & output)
+{
+    VerifyOrReturnError(mIndex < mList.count, false);
 
-    output.label = CharSpan::fromCharString(mUserLabelNameBuf);
-    output.value = CharSpan::fromCharString(mUserLabelValueBuf);
+    output.label = CharSpan::fromCharString(mList.entries[mIndex].label);
+    output.value = CharSpan::fromCharString(mList.entries[mIndex].value);
 
     mIndex++;
 
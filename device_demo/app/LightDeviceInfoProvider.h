@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+
+#include <lib/core/CHIPTLV.h>
 #include <lib/support/EnforceFormat.h>
 #include <platform/DeviceInfoProvider.h>
 
@@ -20,7 +23,32 @@ public:
 
     static LightDeviceInfoProvider & GetDefaultInstance();
 
+    /**
+     * Replaces the whole user label list of an endpoint with a single storage write.
+     *
+     * Either the previous list or the new one is stored at any point in time; there is no
+     * intermediate state where the length disagrees with the entries. UserLabelServer sends the
+     * User Label cluster's list writes and clears here.
+     */
+    CHIP_ERROR SetUserLabelList(EndpointId endpoint, Span<const UserLabelType> labels);
+    using DeviceInfoProvider::SetUserLabelList;
+
 protected:
+    /**
+     * The user labels of one endpoint, as stored in a single packed record.
+     */
+    struct UserLabelList
+    {
+        struct Entry
+        {
+            char label[kMaxLabelNameLength + 1]  = {};
+            char value[kMaxLabelValueLength + 1] = {};
+        };
+
+        size_t count = 0;
+        Entry entries[kMaxUserLabelListLength];
+    };
+
     class FixedLabelIteratorImpl : public FixedLabelIterator
     {
     public:
@@ -40,7 +68,7 @@ protected:
     {
     public:
         UserLabelIteratorImpl(LightDeviceInfoProvider & provider, EndpointId endpoint);
-        size_t Count() override { return mTotal; }
+        size_t Count() override { return mList.count; }
         bool Next(UserLabelType & output) override;
         void Release() override { chip::Platform::Delete(this); }
 
@@ -48,9 +76,7 @@ protected:
         LightDeviceInfoProvider & mProvider;
         EndpointId mEndpoint = 0;
         size_t mIndex        = 0;
-        size_t mTotal        = 0;
-        char mUserLabelNameBuf[kMaxLabelNameLength + 1];
-        char mUserLabelValueBuf[kMaxLabelValueLength + 1];
+        UserLabelList mList;
     };
 
     class SupportedLocalesIteratorImpl : public SupportedLocalesIterator
@@ -85,6 +111,18 @@ protected:
 
 private:
     static constexpr size_t UserLabelTLVMaxSize() { return TLV::EstimateStructOverhead(kMaxLabelNameLength, kMaxLabelValueLength); }
+    // One array control byte plus its end-of-container byte around the label structures.
+    static constexpr size_t UserLabelListTLVMaxSize() { return kMaxUserLabelListLength * UserLabelTLVMaxSize() + 2; }
+
+    // Read-through: served from mUserLabelCache, which is filled from storage on first access.
+    CHIP_ERROR LoadUserLabelList(EndpointId endpoint, UserLabelList & list);
+    CHIP_ERROR ReadUserLabelList(EndpointId endpoint, UserLabelList & list);
+    CHIP_ERROR StoreUserLabelList(EndpointId endpoint, const UserLabelList & list);
+    CHIP_ERROR MigrateLegacyUserLabels(EndpointId endpoint, UserLabelList & list);
+    static CHIP_ERROR DecodeUserLabel(TLV::ContiguousBufferTLVReader & reader, UserLabelList::Entry & entry);
+
+    // Per-endpoint copy of the stored user labels, kept in sync by StoreUserLabelList.
+    std::map<EndpointId, UserLabelList> mUserLabelCache;
 };
 
 } // namespace DeviceLayer
@@ -0,0 +1,312 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LightDriver.h"
+
+#include <app-common/zap-generated/attributes/Accessors.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+using namespace chip::app::Clusters;
+
+namespace {
+constexpr uint8_t kNullLevel = 0xFF; // ember encoding of a null INT8U
+} // namespace
+
+LightDriver & LightDriver::GetInstance()
+{
+    static LightDriver sInstance;
+    return sInstance;
+}
+
+LightOutput LightDriver::Unpack(uint16_t packed)
+{
+    LightOutput output;
+    output.on    = (packed & 0x100) != 0;
+    output.level = static_cast<uint8_t>(packed & 0xFF);
+    return output;
+}
+
+CHIP_ERROR LightDriver::Init(std::unique_ptr<LightSink> sink)
+{
+    VerifyOrReturnError(sink != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mDriver.joinable(), CHIP_ERROR_INCORRECT_STATE);
+
+    ReturnErrorOnFailure(sink->Open());
+    mSink            = std::move(sink);
+    mStopping        = false;
+    mWaveformCommand = WaveformCommand::kNone;
+    mHasApplied      = false;
+    mWaveformPlaying = false;
+
+    bool onOff = false;
+    if (OnOff::Attributes::OnOff::Get(kEndpoint, &onOff) == EMBER_ZCL_STATUS_SUCCESS)
+    {
+        mOutput.on = onOff;
+    }
+    app::DataModel::Nullable<uint8_t> currentLevel;
+    if (LevelControl::Attributes::CurrentLevel::Get(kEndpoint, currentLevel) == EMBER_ZCL_STATUS_SUCCESS &&
+        !currentLevel.IsNull())
+    {
+        mOutput.level = currentLevel.Value();
+    }
+
+    mDriver = std::thread(&LightDriver::DriverLoop, this);
+    Submit(mOutput);
+
+    ChipLogProgress(Zcl, "Light driver started with %s sink", mSink->GetName());
+    return CHIP_NO_ERROR;
+}
+
+void LightDriver::Shutdown()
+{
+    VerifyOrReturn(mDriver.joinable());
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mDriverWake.notify_one();
+    mDriver.join();
+
+    mSink->Close();
+    mSink.reset();
+}
+
+void LightDriver::OnAttributeChanged(const app::ConcreteAttributePath & path, uint8_t type, uint16_t size, const uint8_t * value)
+{
+    (void) type;
+    VerifyOrReturn(mDriver.joinable() && path.mEndpointId == kEndpoint);
+    VerifyOrReturn(size == 1 && value != nullptr);
+
+    LightOutput next = mOutput;
+    if (path.mClusterId == OnOff::Id && path.mAttributeId == OnOff::Attributes::OnOff::Id)
+    {
+        next.on = (*value != 0);
+    }
+    else if (path.mClusterId == LevelControl::Id && path.mAttributeId == LevelControl::Attributes::CurrentLevel::Id)
+    {
+        next.level = (*value == kNullLevel) ? LightOutput::kMaxLevel : *value;
+    }
+    else
+    {
+        return;
+    }
+
+    VerifyOrReturn(next != mOutput);
+    mOutput = next;
+    Submit(next);
+}
+
+void LightDriver::ShowLevel(uint8_t level)
+{
+    VerifyOrReturn(mDriver.joinable() && level != mOutput.level);
+    mOutput.level = level;
+    Submit(mOutput);
+}
+
+CHIP_ERROR LightDriver::PlayWaveform(const LightWaveform & waveform)
+{
+    VerifyOrReturnError(mDriver.joinable(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(waveform.samples != nullptr && waveform.sampleCount > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(waveform.sampleInterval.count() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWaveformCommand   = WaveformCommand::kPlay;
+        mRequestedWaveform = waveform;
+    }
+    mDriverWake.notify_one();
+    return CHIP_NO_ERROR;
+}
+
+void LightDriver::StopWaveform(bool finishPass)
+{
+    VerifyOrReturn(mDriver.joinable());
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Also withdraws a play that the driver has not picked up yet.
+        mWaveformCommand = finishPass ? WaveformCommand::kFinish : WaveformCommand::kStop;
+    }
+    mDriverWake.notify_one();
+}
+
+void LightDriver::Submit(const LightOutput & output)
+{
+    mLatest.store(Pack(output), std::memory_order_relaxed);
+
+    LightOutput queued = output;
+    if (!mQueue.Push(std::move(queued)))
+    {
+        // Never wait for the driver here; it picks up mLatest once it has drained the ring.
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        mOverflowed.store(true, std::memory_order_release);
+    }
+    WakeDriver();
+}
+
+void LightDriver::WakeDriver()
+{
+    // Pairs with the fence in DriverLoop: either the driver sees the new item before going to
+    // sleep, or we see it idle and take the mutex to wake it. The driver never holds the mutex
+    // while talking to the sink.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mDriverIdle.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDriverWake.notify_one();
+    }
+}
+
+void LightDriver::DriverLoop()
+{
+    while (true)
+    {
+        bool stopping           = false;
+        WaveformCommand command = WaveformCommand::kNone;
+        LightWaveform requested;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDriverIdle.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto ready = [this] {
+                return mStopping || mWaveformCommand != WaveformCommand::kNone || !mQueue.Empty() ||
+                    mOverflowed.load(std::memory_order_relaxed);
+            };
+            if (mWaveformPlaying)
+            {
+                mDriverWake.wait_until(lock, mNextSample, ready);
+            }
+            else
+            {
+                mDriverWake.wait(lock, ready);
+            }
+            mDriverIdle.store(false, std::memory_order_relaxed);
+
+            stopping         = mStopping;
+            command          = mWaveformCommand;
+            requested        = mRequestedWaveform;
+            mWaveformCommand = WaveformCommand::kNone;
+        }
+
+        // Shutdown only sets mStopping after its last Submit, so this drains everything.
+        LightOutput output;
+        while (mQueue.Pop(output))
+        {
+            Show(output);
+        }
+
+        // mOverflowed is published after mLatest, so the exchange makes the latest value visible.
+        if (mOverflowed.exchange(false, std::memory_order_acquire))
+        {
+            Show(Unpack(mLatest.load(std::memory_order_relaxed)));
+        }
+
+        if (stopping)
+        {
+            EndWaveform();
+            return;
+        }
+        RunWaveform(command, requested);
+    }
+}
+
+void LightDriver::Show(const LightOutput & output)
+{
+    mBase = output;
+    if (!mWaveformPlaying)
+    {
+        Apply(output);
+    }
+}
+
+void LightDriver::RunWaveform(WaveformCommand command, const LightWaveform & requested)
+{
+    const auto now = std::chrono::steady_clock::now();
+    switch (command)
+    {
+    case WaveformCommand::kPlay:
+        mWaveform          = requested;
+        mWaveformPlaying   = true;
+        mWaveformFinishing = false;
+        mWaveformSample    = 0;
+        mWaveformPass      = 0;
+        mNextSample        = now;
+        break;
+    case WaveformCommand::kFinish:
+        mWaveformFinishing = mWaveformPlaying;
+        break;
+    case WaveformCommand::kStop:
+        EndWaveform();
+        break;
+    case WaveformCommand::kNone:
+        break;
+    }
+
+    // Skip over samples that are already past (e.g. behind a slow sink) and only show the
+    // latest one that is due.
+    bool due = false;
+    while (mWaveformPlaying && mNextSample <= now)
+    {
+        if (mWaveformSample == mWaveform.sampleCount)
+        {
+            mWaveformSample = 0;
+            mWaveformPass++;
+            if (mWaveformFinishing || (mWaveform.repeat != 0 && mWaveformPass >= mWaveform.repeat))
+            {
+                EndWaveform();
+                return;
+            }
+        }
+        mWaveformSample++;
+        mNextSample += mWaveform.sampleInterval;
+        due = true;
+    }
+    VerifyOrReturn(due);
+
+    const uint8_t sample = mWaveform.samples[mWaveformSample - 1];
+    LightOutput shown;
+    shown.on    = (sample != 0);
+    shown.level = (sample != 0) ? sample : mBase.level;
+    Apply(shown);
+}
+
+void LightDriver::EndWaveform()
+{
+    VerifyOrReturn(mWaveformPlaying);
+    mWaveformPlaying = false;
+    Apply(mBase);
+}
+
+void LightDriver::Apply(const LightOutput & output)
+{
+    VerifyOrReturn(!mHasApplied || output != mApplied);
+
+    CHIP_ERROR err = mSink->Apply(output);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Light driver: %s sink failed: %" CHIP_ERROR_FORMAT, mSink->GetName(), err.Format());
+        return;
+    }
+    mApplied    = output;
+    mHasApplied = true;
+}
@@ -0,0 +1,197 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <system/SystemClock.h>
+
+#include "SpscRing.h"
+
+/**
+ * What the light's hardware should show.
+ */
+struct LightOutput
+{
+    static constexpr uint8_t kMaxLevel = 254;
+
+    bool on       = false;
+    uint8_t level = kMaxLevel; // 0..kMaxLevel; a null CurrentLevel is shown as kMaxLevel
+
+    bool operator==(const LightOutput & other) const { return on == other.on && level == other.level; }
+    bool operator!=(const LightOutput & other) const { return !(*this == other); }
+};
+
+/**
+ * A light pattern the driver thread plays back on its own: one sample every sampleInterval, where
+ * 0 shows the light off and anything else shows it on at that level. The driver keeps a pointer
+ * to the samples while playing, so they must outlive the playback (in practice, static tables).
+ */
+struct LightWaveform
+{
+    const uint8_t * samples = nullptr;
+    size_t sampleCount      = 0;
+    chip::System::Clock::Milliseconds16 sampleInterval{ 0 };
+    uint16_t repeat = 1; // passes over the samples; 0 plays until stopped
+};
+
+/**
+ * Where LightDriver sends its output. Only ever called from the driver thread, so an
+ * implementation may block on I/O.
+ */
+class LightSink
+{
+public:
+    virtual ~LightSink() = default;
+
+    virtual const char * GetName() const = 0;
+
+    virtual CHIP_ERROR Open() { return CHIP_NO_ERROR; }
+    virtual CHIP_ERROR Apply(const LightOutput & output) = 0;
+    virtual void Close() {}
+};
+
+/**
+ * Drives the light endpoint's OnOff and CurrentLevel onto a LightSink.
+ *
+ * Attribute changes are turned into LightOutput snapshots on the CHIP stack thread and handed
+ * to a driver thread through a lock-free ring, so a slow sink never holds up the event loop.
+ * If the driver falls so far behind that the ring is full, intermediate snapshots are dropped
+ * and the driver catches up with the latest one.
+ *
+ * The driver thread can also play a LightWaveform over the attribute state by itself, timing
+ * each sample with its own wait, so effects like blinking cost the stack thread nothing past
+ * PlayWaveform and StopWaveform.
+ *
+ * Everything but the counters must be called from the CHIP stack thread.
+ */
+class LightDriver
+{
+public:
+    static constexpr chip::EndpointId kEndpoint = 1;
+    static constexpr size_t kQueueDepth         = 32;
+
+    static LightDriver & GetInstance();
+
+    /**
+     * Opens `sink`, starts the driver thread and shows the endpoint's current state. Call after
+     * Server::Init.
+     */
+    CHIP_ERROR Init(std::unique_ptr<LightSink> sink);
+
+    /**
+     * Applies everything queued so far, then stops the driver thread and closes the sink.
+     */
+    void Shutdown();
+
+    /**
+     * Feed from MatterPostAttributeChangeCallback.
+     */
+    void OnAttributeChanged(const chip::app::ConcreteAttributePath & path, uint8_t type, uint16_t size, const uint8_t * value);
+
+    /**
+     * Shows `level` ahead of the CurrentLevel attribute, for the intermediate steps of a level
+     * transition that are not published as attribute changes.
+     */
+    void ShowLevel(uint8_t level);
+
+    /**
+     * Plays `waveform` on the driver thread in place of the attribute state, replacing any
+     * waveform already playing. No timer or attribute write is involved per sample. When the
+     * waveform ends or is stopped, the light returns to the attribute state, including any change
+     * made in the meantime.
+     */
+    CHIP_ERROR PlayWaveform(const LightWaveform & waveform);
+
+    /**
+     * Ends the playing waveform right away, or with `finishPass` once its current pass is over.
+     */
+    void StopWaveform(bool finishPass);
+
+    bool IsRunning() const { return mDriver.joinable(); }
+
+    /**
+     * Number of snapshots that did not fit in the ring and were superseded by a later one.
+     */
+    size_t GetDroppedCount() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    enum class WaveformCommand : uint8_t
+    {
+        kNone,
+        kPlay,
+        kFinish,
+        kStop,
+    };
+
+    static uint16_t Pack(const LightOutput & output) { return static_cast<uint16_t>((output.on ? 0x100 : 0) | output.level); }
+    static LightOutput Unpack(uint16_t packed);
+
+    void Submit(const LightOutput & output);
+    void WakeDriver();
+    void DriverLoop();
+    void Show(const LightOutput & output);
+    void RunWaveform(WaveformCommand command, const LightWaveform & requested);
+    void EndWaveform();
+    void Apply(const LightOutput & output);
+
+    std::unique_ptr<LightSink> mSink;
+
+    // State as seen by the CHIP stack thread.
+    LightOutput mOutput;
+
+    SpscRing<LightOutput, kQueueDepth> mQueue;
+    // Latest submitted output; the driver thread falls back to it after an overflow.
+    std::atomic<uint16_t> mLatest{ 0 };
+    std::atomic<bool> mOverflowed{ false };
+    std::atomic<size_t> mDropped{ 0 };
+
+    // Only used to sleep and wake; the queue itself is lock-free.
+    std::atomic<bool> mDriverIdle{ false };
+    std::mutex mMutex;
+    std::condition_variable mDriverWake;
+    bool mStopping = false;
+    // Waveform starts and stops are rare, so they are handed over under the mutex.
+    WaveformCommand mWaveformCommand = WaveformCommand::kNone;
+    LightWaveform mRequestedWaveform;
+
+    // Driver thread only.
+    LightOutput mApplied;
+    bool mHasApplied = false;
+    LightOutput mBase; // latest snapshot, shown again when a waveform ends
+    LightWaveform mWaveform;
+    bool mWaveformPlaying   = false;
+    bool mWaveformFinishing = false;
+    size_t mWaveformSample  = 0;
+    uint16_t mWaveformPass  = 0;
+    std::chrono::steady_clock::time_point mNextSample;
+
+    std::thread mDriver;
+};
@@ -0,0 +1,184 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LightSinks.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+CHIP_ERROR FileLightSink::Open()
+{
+    VerifyOrReturnError(mFd < 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mMaxValue > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // sysfs attributes must exist already; only create regular files.
+    mFd = open(mPath.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    struct stat st;
+    if (fstat(mFd, &st) != 0)
+    {
+        const int fstatErrno = errno;
+        Close();
+        return CHIP_ERROR_POSIX(fstatErrno);
+    }
+    mRegularFile = S_ISREG(st.st_mode);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FileLightSink::Apply(const LightOutput & output)
+{
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    // Rounded to the nearest step of the sink's range.
+    const uint64_t scaled = (static_cast<uint64_t>(output.level) * mMaxValue + LightOutput::kMaxLevel / 2) / LightOutput::kMaxLevel;
+    const uint64_t value  = output.on ? scaled : 0;
+
+    char buffer[24];
+    const int length = snprintf(buffer, sizeof(buffer), "%llu\n", static_cast<unsigned long long>(value));
+    VerifyOrReturnError(length > 0 && static_cast<size_t>(length) < sizeof(buffer), CHIP_ERROR_INTERNAL);
+
+    // sysfs attributes take a whole value per write, always from the start of the file.
+    const ssize_t written = pwrite(mFd, buffer, static_cast<size_t>(length), 0);
+    VerifyOrReturnError(written >= 0, CHIP_ERROR_POSIX(errno));
+    VerifyOrReturnError(written == length, CHIP_ERROR_INTERNAL);
+
+    // A plain file keeps whatever followed a longer previous value; cut it off.
+    if (mRegularFile)
+    {
+        VerifyOrReturnError(ftruncate(mFd, length) == 0, CHIP_ERROR_POSIX(errno));
+    }
+    return CHIP_NO_ERROR;
+}
+
+void FileLightSink::Close()
+{
+    VerifyOrReturn(mFd >= 0);
+    close(mFd);
+    mFd = -1;
+}
+
+CHIP_ERROR SharedMemoryLightSink::Open()
+{
+    VerifyOrReturnError(mState == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(!mName.empty() && mName[0] == '/', CHIP_ERROR_INVALID_ARGUMENT);
+
+    int fd = shm_open(mName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    void * mapping = MAP_FAILED;
+
+    VerifyOrExit(ftruncate(fd, sizeof(LightSharedState)) == 0, err = CHIP_ERROR_POSIX(errno));
+    mapping = mmap(nullptr, sizeof(LightSharedState), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    VerifyOrExit(mapping != MAP_FAILED, err = CHIP_ERROR_POSIX(errno));
+    mState = static_cast<LightSharedState *>(mapping);
+
+exit:
+    close(fd);
+    return err;
+}
+
+CHIP_ERROR SharedMemoryLightSink::Apply(const LightOutput & output)
+{
+    VerifyOrReturnError(mState != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    const uint32_t sequence = mState->sequence.load(std::memory_order_relaxed);
+    mState->sequence.store(sequence | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    mState->on.store(output.on ? 1 : 0, std::memory_order_relaxed);
+    mState->level.store(output.level, std::memory_order_relaxed);
+    mState->sequence.store((sequence | 1) + 1, std::memory_order_release);
+    return CHIP_NO_ERROR;
+}
+
+void SharedMemoryLightSink::Close()
+{
+    VerifyOrReturn(mState != nullptr);
+    munmap(mState, sizeof(LightSharedState));
+    mState = nullptr;
+}
+
+CHIP_ERROR RecordingLightSink::Apply(const LightOutput & output)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRecorded.push_back(output);
+    ChipLogDetail(Zcl, "Light driver: on=%u level=%u", output.on, output.level);
+    return CHIP_NO_ERROR;
+}
+
+std::vector<LightOutput> RecordingLightSink::GetRecorded() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRecorded;
+}
+
+CHIP_ERROR CreateLightSink(const char * spec, std::unique_ptr<LightSink> & sink)
+{
+    VerifyOrReturnError(spec != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (strcmp(spec, "record") == 0)
+    {
+        sink.reset(new RecordingLightSink());
+        return CHIP_NO_ERROR;
+    }
+
+    if (strncmp(spec, "shm:", 4) == 0)
+    {
+        VerifyOrReturnError(spec[4] != '\0', CHIP_ERROR_INVALID_ARGUMENT);
+        sink.reset(new SharedMemoryLightSink(spec + 4));
+        return CHIP_NO_ERROR;
+    }
+
+    if (strncmp(spec, "file:", 5) == 0)
+    {
+        std::string path(spec + 5);
+        uint32_t maxValue = LightOutput::kMaxLevel;
+
+        // An optional trailing ":<max>"; paths may contain ':' themselves.
+        const size_t separator = path.rfind(':');
+        if (separator != std::string::npos)
+        {
+            char * end                = nullptr;
+            const unsigned long value = strtoul(path.c_str() + separator + 1, &end, 10);
+            if (end != path.c_str() + separator + 1 && *end == '\0')
+            {
+                VerifyOrReturnError(value > 0 && value <= UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+                maxValue = static_cast<uint32_t>(value);
+                path.resize(separator);
+            }
+        }
+        VerifyOrReturnError(!path.empty(), CHIP_ERROR_INVALID_ARGUMENT);
+
+        sink.reset(new FileLightSink(std::move(path), maxValue));
+        return CHIP_NO_ERROR;
+    }
+
+    return CHIP_ERROR_INVALID_ARGUMENT;
+}
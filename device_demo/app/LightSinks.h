@@ -0,0 +1,116 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LightDriver.h"
+
+/**
+ * Writes the brightness as a decimal number to a file, scaled to 0..maxValue (0 when off).
+ *
+ * Fits /sys/class/leds/<led>/brightness (maxValue = max_brightness) as well as
+ * /sys/class/pwm/pwmchipN/pwmM/duty_cycle (maxValue = the period in ns), or any plain file.
+ */
+class FileLightSink : public LightSink
+{
+public:
+    FileLightSink(std::string path, uint32_t maxValue) : mPath(std::move(path)), mMaxValue(maxValue) {}
+    ~FileLightSink() override { Close(); }
+
+    const char * GetName() const override { return "file"; }
+
+    CHIP_ERROR Open() override;
+    CHIP_ERROR Apply(const LightOutput & output) override;
+    void Close() override;
+
+private:
+    std::string mPath;
+    uint32_t mMaxValue;
+    int mFd           = -1;
+    bool mRegularFile = false; // not sysfs: stale bytes past the value must be truncated
+};
+
+/**
+ * Layout of the shared memory object written by SharedMemoryLightSink.
+ *
+ * `sequence` is odd while the writer updates the other fields; readers retry until they see the
+ * same even value before and after copying them.
+ */
+struct LightSharedState
+{
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint8_t> on;
+    std::atomic<uint8_t> level;
+};
+
+/**
+ * Publishes the output in a POSIX shared memory object, for a simulator or UI process.
+ */
+class SharedMemoryLightSink : public LightSink
+{
+public:
+    explicit SharedMemoryLightSink(std::string name) : mName(std::move(name)) {}
+    ~SharedMemoryLightSink() override { Close(); }
+
+    const char * GetName() const override { return "shm"; }
+
+    CHIP_ERROR Open() override;
+    CHIP_ERROR Apply(const LightOutput & output) override;
+    void Close() override;
+
+private:
+    std::string mName;
+    LightSharedState * mState = nullptr;
+};
+
+/**
+ * Keeps every applied output in memory, for tests.
+ */
+class RecordingLightSink : public LightSink
+{
+public:
+    const char * GetName() const override { return "record"; }
+
+    CHIP_ERROR Apply(const LightOutput & output) override;
+
+    /**
+     * Safe to call from any thread.
+     */
+    std::vector<LightOutput> GetRecorded() const;
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<LightOutput> mRecorded;
+};
+
+/**
+ * Creates a sink from a --light-driver argument:
+ *
+ *   file:<path>[:<max>]   FileLightSink, max defaults to LightOutput::kMaxLevel
+ *   shm:<name>            SharedMemoryLightSink
+ *   record                RecordingLightSink
+ */
+CHIP_ERROR CreateLightSink(const char * spec, std::unique_ptr<LightSink> & sink);
@@ -0,0 +1,277 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LightStatePersistence.h"
+
+#include <algorithm>
+
+#include <app-common/zap-generated/attributes/Accessors.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/util/af-types.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/CHIPDeviceLayer.h>
+
+using namespace chip;
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr char kLightStateKey[] = "light/state";
+
+constexpr TLV::Tag kOnOffTag        = TLV::ContextTag(0);
+constexpr TLV::Tag kCurrentLevelTag = TLV::ContextTag(1); // absent when CurrentLevel is null
+
+constexpr size_t kLightStateTLVMaxSize = TLV::EstimateStructOverhead(sizeof(bool), sizeof(uint8_t));
+
+constexpr uint8_t kNullLevel = 0xFF; // ember encoding of a null INT8U
+
+} // namespace
+
+LightStatePersistence & LightStatePersistence::GetInstance()
+{
+    static LightStatePersistence sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR LightStatePersistence::Init(PersistentStorageDelegate * storage)
+{
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    mStorage = storage;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LightStatePersistence::Restore()
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    State saved;
+    CHIP_ERROR err = Load(saved);
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        // Nothing to restore; start tracking from whatever the cluster init callbacks left, so
+        // the first change does not persist defaults for the attribute that did not change.
+        mState = ReadAttributes();
+        return CHIP_NO_ERROR;
+    }
+    ReturnErrorOnFailure(err);
+
+    mStoredState   = saved;
+    State restored = saved;
+
+    DataModel::Nullable<OnOff::OnOffStartUpOnOff> startUpOnOff;
+    if (OnOff::Attributes::StartUpOnOff::Get(kEndpoint, startUpOnOff) == EMBER_ZCL_STATUS_SUCCESS && !startUpOnOff.IsNull())
+    {
+        switch (startUpOnOff.Value())
+        {
+        case OnOff::OnOffStartUpOnOff::kOff:
+            restored.onOff = false;
+            break;
+        case OnOff::OnOffStartUpOnOff::kOn:
+            restored.onOff = true;
+            break;
+        case OnOff::OnOffStartUpOnOff::kTogglePreviousOnOff:
+            restored.onOff = !saved.onOff;
+            break;
+        default:
+            break;
+        }
+    }
+
+    DataModel::Nullable<uint8_t> startUpLevel;
+    if (LevelControl::Attributes::StartUpCurrentLevel::Get(kEndpoint, startUpLevel) == EMBER_ZCL_STATUS_SUCCESS &&
+        !startUpLevel.IsNull())
+    {
+        uint8_t minLevel = 0;
+        uint8_t maxLevel = kNullLevel - 1;
+        LevelControl::Attributes::MinLevel::Get(kEndpoint, &minLevel);
+        LevelControl::Attributes::MaxLevel::Get(kEndpoint, &maxLevel);
+
+        // 0 means "minimum"; anything else is clamped to the supported range.
+        const uint8_t level      = std::min(std::max(startUpLevel.Value(), minLevel), maxLevel);
+        restored.hasCurrentLevel = true;
+        restored.currentLevel    = (startUpLevel.Value() == 0) ? minLevel : level;
+    }
+
+    // The attribute writes below call back into OnAttributeChanged; they are not new state.
+    mRestoring = true;
+    OnOff::Attributes::OnOff::Set(kEndpoint, restored.onOff);
+    if (restored.hasCurrentLevel)
+    {
+        LevelControl::Attributes::CurrentLevel::Set(kEndpoint, restored.currentLevel);
+    }
+    else
+    {
+        LevelControl::Attributes::CurrentLevel::SetNull(kEndpoint);
+    }
+    mRestoring = false;
+
+    mState = restored;
+    if (mState != mStoredState)
+    {
+        ScheduleWrite();
+    }
+
+    ChipLogProgress(Zcl, "Restored light state: on=%u level=%u", restored.onOff,
+                    restored.hasCurrentLevel ? restored.currentLevel : kNullLevel);
+    return CHIP_NO_ERROR;
+}
+
+LightStatePersistence::State LightStatePersistence::ReadAttributes()
+{
+    State state;
+
+    bool onOff = false;
+    if (OnOff::Attributes::OnOff::Get(kEndpoint, &onOff) == EMBER_ZCL_STATUS_SUCCESS)
+    {
+        state.onOff = onOff;
+    }
+
+    DataModel::Nullable<uint8_t> currentLevel;
+    if (LevelControl::Attributes::CurrentLevel::Get(kEndpoint, currentLevel) == EMBER_ZCL_STATUS_SUCCESS && !currentLevel.IsNull())
+    {
+        state.hasCurrentLevel = true;
+        state.currentLevel    = currentLevel.Value();
+    }
+    return state;
+}
+
+void LightStatePersistence::OnAttributeChanged(const app::ConcreteAttributePath & path, uint8_t type, uint16_t size,
+                                               const uint8_t * value)
+{
+    (void) type;
+    VerifyOrReturn(!mRestoring && mStorage != nullptr && path.mEndpointId == kEndpoint);
+    VerifyOrReturn(size == 1 && value != nullptr);
+
+    State next = mState;
+    if (path.mClusterId == OnOff::Id && path.mAttributeId == OnOff::Attributes::OnOff::Id)
+    {
+        next.onOff = (*value != 0);
+    }
+    else if (path.mClusterId == LevelControl::Id && path.mAttributeId == LevelControl::Attributes::CurrentLevel::Id)
+    {
+        next.hasCurrentLevel = (*value != kNullLevel);
+        next.currentLevel    = *value;
+    }
+    else
+    {
+        return;
+    }
+
+    VerifyOrReturn(next != mState);
+    mState = next;
+    ScheduleWrite();
+}
+
+void LightStatePersistence::ScheduleWrite()
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    if (!mDirty)
+    {
+        mDirty      = true;
+        mDirtySince = now;
+    }
+
+    // Settle first, but never defer past kMaxDeferral nor write sooner than kMinWriteInterval.
+    System::Clock::Timestamp due = std::min<System::Clock::Timestamp>(now + kSettleTime, mDirtySince + kMaxDeferral);
+    due                          = std::max<System::Clock::Timestamp>(due, mLastWrite + kMinWriteInterval);
+
+    const System::Clock::Timeout delay = (due > now) ? (due - now) : System::Clock::kZero;
+    DeviceLayer::SystemLayer().StartTimer(delay, OnTimerExpired, this);
+}
+
+void LightStatePersistence::OnTimerExpired(System::Layer * layer, void * context)
+{
+    (void) layer;
+    CHIP_ERROR err = static_cast<LightStatePersistence *>(context)->Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Failed to persist light state: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+CHIP_ERROR LightStatePersistence::Flush()
+{
+    VerifyOrReturnError(mDirty, CHIP_NO_ERROR);
+    DeviceLayer::SystemLayer().CancelTimer(OnTimerExpired, this);
+
+    mDirty = false;
+    VerifyOrReturnError(mState != mStoredState, CHIP_NO_ERROR);
+
+    CHIP_ERROR err = Store(mState);
+    if (err != CHIP_NO_ERROR)
+    {
+        // Keep it pending; the next change (or shutdown) tries again.
+        mDirty = true;
+        return err;
+    }
+
+    mStoredState = mState;
+    mLastWrite   = System::SystemClock().GetMonotonicTimestamp();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LightStatePersistence::Load(State & state)
+{
+    uint8_t buf[kLightStateTLVMaxSize];
+    uint16_t len = static_cast<uint16_t>(sizeof(buf));
+    ReturnErrorOnFailure(mStorage->SyncGetKeyValue(kLightStateKey, buf, len));
+
+    TLV::ContiguousBufferTLVReader reader;
+    reader.Init(buf, len);
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+
+    TLV::TLVType containerType;
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+    ReturnErrorOnFailure(reader.Next(kOnOffTag));
+    ReturnErrorOnFailure(reader.Get(state.onOff));
+
+    CHIP_ERROR err        = reader.Next(kCurrentLevelTag);
+    state.hasCurrentLevel = (err == CHIP_NO_ERROR);
+    if (state.hasCurrentLevel)
+    {
+        ReturnErrorOnFailure(reader.Get(state.currentLevel));
+    }
+    else
+    {
+        VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    }
+
+    return reader.ExitContainer(containerType);
+}
+
+CHIP_ERROR LightStatePersistence::Store(const State & state)
+{
+    uint8_t buf[kLightStateTLVMaxSize];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+
+    TLV::TLVType containerType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    ReturnErrorOnFailure(writer.PutBoolean(kOnOffTag, state.onOff));
+    if (state.hasCurrentLevel)
+    {
+        ReturnErrorOnFailure(writer.Put(kCurrentLevelTag, state.currentLevel));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(containerType));
+
+    return mStorage->SyncSetKeyValue(kLightStateKey, buf, static_cast<uint16_t>(writer.GetLengthWritten()));
+}
@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/core/DataModelTypes.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+/**
+ * Persists the OnOff and LevelControl CurrentLevel state of the light endpoint across restarts.
+ *
+ * Attribute changes only mark the state dirty. The state is written once it has settled (no
+ * change for kSettleTime), never more often than once per kMinWriteInterval, and at the latest
+ * kMaxDeferral after it first became dirty. A level transition therefore costs a single write
+ * of its final value rather than one write per step.
+ *
+ * Both attributes are kept in one record, so Restore() is a single storage read. StartUpOnOff
+ * and StartUpCurrentLevel take precedence: the saved values are only used where those are null,
+ * i.e. request the previous state. Both default to null (zap-generated/endpoint_config.h), so a
+ * light restores its previous state until a controller sets a startup behavior.
+ *
+ * All methods must be called from the CHIP stack thread (or before it starts).
+ */
+class LightStatePersistence
+{
+public:
+    static constexpr chip::EndpointId kEndpoint = 1;
+
+    static constexpr chip::System::Clock::Milliseconds32 kSettleTime{ 1000 };
+    static constexpr chip::System::Clock::Milliseconds32 kMinWriteInterval{ 2000 };
+    static constexpr chip::System::Clock::Milliseconds32 kMaxDeferral{ 10000 };
+
+    static LightStatePersistence & GetInstance();
+
+    CHIP_ERROR Init(chip::PersistentStorageDelegate * storage);
+
+    /**
+     * Loads the saved state and applies it to the endpoint's attributes. Call after Server::Init.
+     */
+    CHIP_ERROR Restore();
+
+    /**
+     * Feed from MatterPostAttributeChangeCallback.
+     */
+    void OnAttributeChanged(const chip::app::ConcreteAttributePath & path, uint8_t type, uint16_t size, const uint8_t * value);
+
+    /**
+     * Writes pending state now, e.g. on shutdown.
+     */
+    CHIP_ERROR Flush();
+
+private:
+    struct State
+    {
+        bool onOff           = false;
+        bool hasCurrentLevel = false; // CurrentLevel is nullable
+        uint8_t currentLevel = 0;
+
+        bool operator==(const State & other) const
+        {
+            return onOff == other.onOff && hasCurrentLevel == other.hasCurrentLevel &&
+                (!hasCurrentLevel || currentLevel == other.currentLevel);
+        }
+        bool operator!=(const State & other) const { return !(*this == other); }
+    };
+
+    static State ReadAttributes();
+    static void OnTimerExpired(chip::System::Layer * layer, void * context);
+    void ScheduleWrite();
+    CHIP_ERROR Load(State & state);
+    CHIP_ERROR Store(const State & state);
+
+    chip::PersistentStorageDelegate * mStorage = nullptr;
+
+    State mState;       // latest attribute values
+    State mStoredState; // what storage holds
+    bool mDirty     = false;
+    bool mRestoring = false;
+
+    chip::System::Clock::Timestamp mDirtySince;
+    chip::System::Clock::Timestamp mLastWrite;
+};
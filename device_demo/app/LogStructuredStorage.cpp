@@ -0,0 +1,539 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "LogStructuredStorage.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/BufferReader.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr uint32_t kLogMagic      = 0x31564b4c; // "LKV1"
+constexpr size_t kLogHeaderSize   = 8;          // magic + reserved
+constexpr uint64_t kMinStaleBytes = 64 * 1024;  // don't bother compacting below this
+constexpr auto kCompactionRetryDelay = std::chrono::seconds(10);
+
+uint32_t Crc32(const uint8_t * data, size_t length)
+{
+    static const auto sTable = [] {
+        std::vector<uint32_t> table(256);
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = sTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+CHIP_ERROR WriteFully(int fd, const uint8_t * data, size_t length, uint64_t offset)
+{
+    while (length > 0)
+    {
+        ssize_t written = pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        VerifyOrReturnError(written > 0, CHIP_ERROR_POSIX(errno));
+        data += written;
+        offset += static_cast<uint64_t>(written);
+        length -= static_cast<size_t>(written);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ReadFully(int fd, uint8_t * data, size_t length, uint64_t offset)
+{
+    while (length > 0)
+    {
+        ssize_t bytesRead = pread(fd, data, length, static_cast<off_t>(offset));
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        VerifyOrReturnError(bytesRead >= 0, CHIP_ERROR_POSIX(errno));
+        VerifyOrReturnError(bytesRead > 0, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+        data += bytesRead;
+        offset += static_cast<uint64_t>(bytesRead);
+        length -= static_cast<size_t>(bytesRead);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SyncParentDirectory(const std::string & path)
+{
+    size_t slash    = path.find_last_of('/');
+    std::string dir = (slash == std::string::npos) ? "." : path.substr(0, (slash == 0) ? 1 : slash);
+
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+    int rc        = fsync(fd);
+    int syncErrno = errno;
+    close(fd);
+    VerifyOrReturnError(rc == 0, CHIP_ERROR_POSIX(syncErrno));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteLogHeader(int fd)
+{
+    uint8_t header[kLogHeaderSize] = {};
+    Encoding::LittleEndian::Put32(header, kLogMagic);
+    ReturnErrorOnFailure(WriteFully(fd, header, sizeof(header), 0));
+    VerifyOrReturnError(ftruncate(fd, kLogHeaderSize) == 0, CHIP_ERROR_POSIX(errno));
+    return CHIP_NO_ERROR;
+}
+
+} // namespace
+
+CHIP_ERROR LogStructuredStorage::Init(const char * path)
+{
+    VerifyOrReturnError(path != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mFd < 0, CHIP_ERROR_INCORRECT_STATE);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    Index index;
+    uint64_t validEnd = 0;
+    struct stat st;
+
+    VerifyOrExit(fstat(fd, &st) == 0, err = CHIP_ERROR_POSIX(errno));
+
+    if (static_cast<uint64_t>(st.st_size) < kLogHeaderSize)
+    {
+        // New log, or one whose creation was interrupted before the header made it out.
+        SuccessOrExit(err = WriteLogHeader(fd));
+        VerifyOrExit(fsync(fd) == 0, err = CHIP_ERROR_POSIX(errno));
+        validEnd = kLogHeaderSize;
+    }
+    else
+    {
+        SuccessOrExit(err = Replay(fd, static_cast<uint64_t>(st.st_size), index, validEnd));
+        if (validEnd < static_cast<uint64_t>(st.st_size))
+        {
+            ChipLogError(DeviceLayer, "KVS log %s: dropping %u bytes of torn tail", path,
+                         static_cast<unsigned>(static_cast<uint64_t>(st.st_size) - validEnd));
+            VerifyOrExit(ftruncate(fd, static_cast<off_t>(validEnd)) == 0, err = CHIP_ERROR_POSIX(errno));
+            VerifyOrExit(fsync(fd) == 0, err = CHIP_ERROR_POSIX(errno));
+        }
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        close(fd);
+        return err;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPath          = path;
+        mFd            = fd;
+        mIndex         = std::move(index);
+        mEndOffset     = validEnd;
+        mDurableOffset = validEnd;
+        mLiveBytes     = 0;
+        for (const auto & entry : mIndex)
+        {
+            mLiveBytes += entry.second.recordSize;
+        }
+        mStopping = false;
+    }
+
+    ChipLogProgress(DeviceLayer, "KVS log %s: %u keys, %u of %u bytes live", path, static_cast<unsigned>(mIndex.size()),
+                    static_cast<unsigned>(mLiveBytes), static_cast<unsigned>(mEndOffset));
+
+    mCompactionThread = std::thread(&LogStructuredStorage::CompactionLoop, this);
+    return CHIP_NO_ERROR;
+}
+
+void LogStructuredStorage::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mCompactionCondition.notify_all();
+    if (mCompactionThread.joinable())
+    {
+        mCompactionThread.join();
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDurableCondition.wait(lock, [this] { return !mSyncInFlight; });
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+    mIndex.clear();
+}
+
+CHIP_ERROR LogStructuredStorage::Replay(int fd, uint64_t fileSize, Index & index, uint64_t & validEnd)
+{
+    std::vector<uint8_t> log(static_cast<size_t>(fileSize));
+    ReturnErrorOnFailure(ReadFully(fd, log.data(), log.size(), 0));
+
+    // Refuse to touch a file that is not ours rather than "recovering" it to empty.
+    VerifyOrReturnError(Encoding::LittleEndian::Get32(log.data()) == kLogMagic, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+
+    validEnd = kLogHeaderSize + ApplyRecords(log.data() + kLogHeaderSize, log.size() - kLogHeaderSize, kLogHeaderSize, index);
+    return CHIP_NO_ERROR;
+}
+
+size_t LogStructuredStorage::ApplyRecords(const uint8_t * data, size_t length, uint64_t baseOffset, Index & index)
+{
+    size_t offset = 0;
+    while (length - offset >= kRecordHeaderSize)
+    {
+        uint32_t crc      = 0;
+        uint8_t type      = 0;
+        uint8_t reserved  = 0;
+        uint16_t keyLen   = 0;
+        uint16_t valueLen = 0;
+
+        Encoding::LittleEndian::Reader reader(data + offset, kRecordHeaderSize);
+        reader.Read32(&crc).Read8(&type).Read8(&reserved).Read16(&keyLen).Read16(&valueLen);
+
+        const size_t recordSize = kRecordHeaderSize + keyLen + valueLen;
+        if (!reader.IsSuccess() || keyLen == 0 || recordSize > length - offset ||
+            Crc32(data + offset + sizeof(crc), recordSize - sizeof(crc)) != crc)
+        {
+            break;
+        }
+
+        std::string key(reinterpret_cast<const char *>(data + offset + kRecordHeaderSize), keyLen);
+        if (type == static_cast<uint8_t>(RecordType::kPut))
+        {
+            index[key] = Location{ baseOffset + offset + kRecordHeaderSize + keyLen, static_cast<uint32_t>(recordSize), valueLen };
+        }
+        else if (type == static_cast<uint8_t>(RecordType::kDelete))
+        {
+            index.erase(key);
+        }
+        else
+        {
+            break;
+        }
+
+        offset += recordSize;
+    }
+    return offset;
+}
+
+void LogStructuredStorage::EncodeRecord(std::vector<uint8_t> & record, RecordType type, const char * key, size_t keyLen,
+                                        const void * value, uint16_t size)
+{
+    record.resize(kRecordHeaderSize + keyLen + size);
+
+    Encoding::LittleEndian::BufferWriter writer(record.data(), record.size());
+    writer.Put32(0).Put8(static_cast<uint8_t>(type)).Put8(0).Put16(static_cast<uint16_t>(keyLen)).Put16(size);
+    writer.Put(key, keyLen);
+    if (size > 0)
+    {
+        writer.Put(value, size);
+    }
+
+    Encoding::LittleEndian::Put32(record.data(), Crc32(record.data() + sizeof(uint32_t), record.size() - sizeof(uint32_t)));
+}
+
+CHIP_ERROR LogStructuredStorage::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mIndex.find(key);
+    VerifyOrReturnError(it != mIndex.end(), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    const Location & location = it->second;
+    const uint16_t copySize   = (size < location.valueSize) ? size : location.valueSize;
+    if (copySize > 0)
+    {
+        VerifyOrReturnError(buffer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(ReadFully(mFd, static_cast<uint8_t *>(buffer), copySize, location.valueOffset));
+    }
+    size = copySize;
+    return (copySize < location.valueSize) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LogStructuredStorage::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(value != nullptr || size == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    return Append(RecordType::kPut, key, value, size);
+}
+
+CHIP_ERROR LogStructuredStorage::SyncDeleteKeyValue(const char * key)
+{
+    return Append(RecordType::kDelete, key, nullptr, 0);
+}
+
+CHIP_ERROR LogStructuredStorage::Append(RecordType type, const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    const size_t keyLen = strlen(key);
+    VerifyOrReturnError(keyLen > 0 && keyLen <= PersistentStorageDelegate::kKeyLengthMax, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::vector<uint8_t> record;
+    EncodeRecord(record, type, key, keyLen, value, size);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(!mFailed, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+
+    auto it = mIndex.find(key);
+    VerifyOrReturnError(type == RecordType::kPut || it != mIndex.end(), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    const uint64_t offset = mEndOffset;
+    CHIP_ERROR err        = WriteFully(mFd, record.data(), record.size(), offset);
+    if (err != CHIP_NO_ERROR)
+    {
+        // Don't leave a partial record for the next append to land behind.
+        (void) ftruncate(mFd, static_cast<off_t>(offset));
+        return err;
+    }
+    mEndOffset += record.size();
+
+    if (it != mIndex.end())
+    {
+        mLiveBytes -= it->second.recordSize;
+    }
+    if (type == RecordType::kPut)
+    {
+        mIndex[key] = Location{ offset + kRecordHeaderSize + keyLen, static_cast<uint32_t>(record.size()), size };
+        mLiveBytes += record.size();
+    }
+    else
+    {
+        mIndex.erase(it);
+    }
+
+    if (CompactionDue())
+    {
+        mCompactionCondition.notify_one();
+    }
+
+    return WaitDurable(lock, mGeneration, mEndOffset);
+}
+
+CHIP_ERROR LogStructuredStorage::WaitDurable(std::unique_lock<std::mutex> & lock, uint64_t generation, uint64_t offset)
+{
+    // A compaction swap leaves everything durable once it is no longer pending, so a new
+    // generation then satisfies any waiter from before the swap.
+    while (mSwapPending || (generation == mGeneration && mDurableOffset < offset))
+    {
+        if (mSyncInFlight || mSwapPending)
+        {
+            mDurableCondition.wait(lock);
+            continue;
+        }
+        VerifyOrReturnError(!mFailed, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+
+        // Group commit: sync everything appended so far on behalf of every waiter.
+        mSyncInFlight         = true;
+        const uint64_t target = mEndOffset;
+        const int fd          = mFd;
+
+        lock.unlock();
+        int rc        = fdatasync(fd);
+        int syncErrno = errno;
+        lock.lock();
+
+        mSyncInFlight = false;
+        if (rc == 0 && target > mDurableOffset)
+        {
+            mDurableOffset = target;
+        }
+        mDurableCondition.notify_all();
+        VerifyOrReturnError(rc == 0, CHIP_ERROR_POSIX(syncErrno));
+    }
+    VerifyOrReturnError(!mFailed, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    return CHIP_NO_ERROR;
+}
+
+bool LogStructuredStorage::CompactionDue() const
+{
+    const uint64_t staleBytes = mEndOffset - kLogHeaderSize - mLiveBytes;
+    return !mCompactionRunning && !mFailed && staleBytes >= kMinStaleBytes && staleBytes > mLiveBytes;
+}
+
+void LogStructuredStorage::CompactionLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping)
+    {
+        mCompactionCondition.wait(lock, [this] { return mStopping || CompactionDue(); });
+        if (mStopping)
+        {
+            break;
+        }
+
+        lock.unlock();
+        CHIP_ERROR err = Compact();
+        lock.lock();
+
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DeviceLayer, "KVS log compaction failed: %" CHIP_ERROR_FORMAT, err.Format());
+            mCompactionCondition.wait_for(lock, kCompactionRetryDelay, [this] { return mStopping; });
+        }
+    }
+}
+
+CHIP_ERROR LogStructuredStorage::Compact()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    VerifyOrReturnError(mFd >= 0 && !mCompactionRunning && !mFailed, CHIP_ERROR_INCORRECT_STATE);
+    mCompactionRunning = true;
+
+    // Records are never modified once appended, so the snapshot can be copied from the old
+    // file without holding the lock while writers keep appending behind it.
+    const Index snapshot       = mIndex;
+    const uint64_t snapshotEnd = mEndOffset;
+    const int oldFd            = mFd;
+    const std::string tmpPath  = mPath + ".compact";
+    lock.unlock();
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    Index index;
+    uint64_t newEnd      = kLogHeaderSize;
+    uint64_t previousEnd = 0;
+    int swappedFd        = -1;
+    std::vector<uint8_t> value;
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> tail;
+
+    int newFd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    VerifyOrExit(newFd >= 0, err = CHIP_ERROR_POSIX(errno));
+    SuccessOrExit(err = WriteLogHeader(newFd));
+
+    for (const auto & entry : snapshot)
+    {
+        const Location & location = entry.second;
+        value.resize(location.valueSize);
+        SuccessOrExit(err = ReadFully(oldFd, value.data(), value.size(), location.valueOffset));
+
+        EncodeRecord(record, RecordType::kPut, entry.first.c_str(), entry.first.size(), value.data(), location.valueSize);
+        SuccessOrExit(err = WriteFully(newFd, record.data(), record.size(), newEnd));
+
+        index[entry.first] = Location{ newEnd + kRecordHeaderSize + entry.first.size(), static_cast<uint32_t>(record.size()),
+                                       location.valueSize };
+        newEnd += record.size();
+    }
+    VerifyOrExit(fdatasync(newFd) == 0, err = CHIP_ERROR_POSIX(errno));
+
+    // Under the lock, only catch up with whatever was appended meanwhile and swap files; the
+    // sync and rename that make the swap durable run with writers let back in.
+    lock.lock();
+    mDurableCondition.wait(lock, [this] { return !mSyncInFlight; });
+
+    tail.resize(static_cast<size_t>(mEndOffset - snapshotEnd));
+    SuccessOrExit(err = ReadFully(oldFd, tail.data(), tail.size(), snapshotEnd));
+    VerifyOrExit(ApplyRecords(tail.data(), tail.size(), newEnd, index) == tail.size(), err = CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    SuccessOrExit(err = WriteFully(newFd, tail.data(), tail.size(), newEnd));
+    newEnd += tail.size();
+
+    previousEnd    = mEndOffset;
+    swappedFd      = newFd;
+    mFd            = newFd;
+    newFd          = -1;
+    mIndex         = std::move(index);
+    mEndOffset     = newEnd;
+    mDurableOffset = kLogHeaderSize;
+    mLiveBytes     = 0;
+    for (const auto & entry : mIndex)
+    {
+        mLiveBytes += entry.second.recordSize;
+    }
+    mGeneration++;
+    mSwapPending = true;
+    lock.unlock();
+
+    // Appends now land in the new file, but nothing is acknowledged until it is in place.
+    if (fdatasync(swappedFd) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    else if (rename(tmpPath.c_str(), mPath.c_str()) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    else if (SyncParentDirectory(mPath) != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "KVS log: failed to sync directory after compaction");
+    }
+
+    lock.lock();
+    mSwapPending = false;
+    if (err == CHIP_NO_ERROR)
+    {
+        mDurableOffset = newEnd;
+        ChipLogProgress(DeviceLayer, "KVS log compacted: %u -> %u bytes", static_cast<unsigned>(previousEnd),
+                        static_cast<unsigned>(newEnd));
+    }
+    else
+    {
+        // The log at mPath no longer matches what is being appended; refuse further writes
+        // rather than acknowledge records that a restart would not see.
+        mFailed = true;
+    }
+    close(oldFd);
+    mDurableCondition.notify_all();
+    mCompactionRunning = false;
+    return err;
+
+exit:
+    if (!lock.owns_lock())
+    {
+        lock.lock();
+    }
+    if (newFd >= 0)
+    {
+        close(newFd);
+        unlink(tmpPath.c_str());
+    }
+    mCompactionRunning = false;
+    return err;
+}
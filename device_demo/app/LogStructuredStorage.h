@@ -0,0 +1,132 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+
+/**
+ * Append-only, log-structured PersistentStorageDelegate backed by a single file.
+ *
+ * Every set or delete appends one CRC-protected record to the end of the log instead of
+ * rewriting the whole store. An in-memory hash index maps each live key to its latest value
+ * in the file, so reads are a single pread.
+ *
+ * Durability: a mutation returns once its record is on stable storage. Concurrent writers
+ * share fsyncs (group commit): whoever finds no sync in flight syncs everything appended so
+ * far, the others just wait for it.
+ *
+ * Space is reclaimed by a background thread that rewrites the live records into a fresh
+ * file and atomically renames it over the log once stale records outweigh live ones. Writers
+ * are only held off while the records appended during the rewrite are copied over and the
+ * file descriptors are swapped; acknowledgements wait until the rename is durable.
+ *
+ * A record torn by a crash is detected by its CRC and truncated away on the next Init.
+ *
+ * Record layout, integers little-endian:
+ *   u32 crc32 (of everything after it), u8 type, u8 reserved, u16 key length,
+ *   u16 value length, key bytes, value bytes
+ */
+class LogStructuredStorage : public chip::PersistentStorageDelegate
+{
+public:
+    LogStructuredStorage() = default;
+    ~LogStructuredStorage() override { Shutdown(); }
+
+    LogStructuredStorage(const LogStructuredStorage &) = delete;
+    LogStructuredStorage & operator=(const LogStructuredStorage &) = delete;
+
+    /**
+     * Opens (or creates) the log at `path`, replays it into the index and starts the
+     * compaction thread.
+     */
+    CHIP_ERROR Init(const char * path);
+
+    /**
+     * Stops the compaction thread and closes the log. Everything already acknowledged is durable.
+     */
+    void Shutdown();
+
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+
+    /**
+     * Rewrites the log with only the live records. Normally driven by the compaction thread.
+     */
+    CHIP_ERROR Compact();
+
+private:
+    enum class RecordType : uint8_t
+    {
+        kPut    = 1,
+        kDelete = 2,
+    };
+
+    struct Location
+    {
+        uint64_t valueOffset;
+        uint32_t recordSize;
+        uint16_t valueSize;
+    };
+
+    using Index = std::unordered_map<std::string, Location>;
+
+    static constexpr size_t kRecordHeaderSize = 10;
+
+    CHIP_ERROR Replay(int fd, uint64_t fileSize, Index & index, uint64_t & validEnd);
+    // Applies the well-formed records at the start of `data` to `index` and returns how many
+    // bytes they span; `baseOffset` is the file offset of `data`.
+    static size_t ApplyRecords(const uint8_t * data, size_t length, uint64_t baseOffset, Index & index);
+    static void EncodeRecord(std::vector<uint8_t> & record, RecordType type, const char * key, size_t keyLen, const void * value,
+                             uint16_t size);
+    CHIP_ERROR Append(RecordType type, const char * key, const void * value, uint16_t size);
+    CHIP_ERROR WaitDurable(std::unique_lock<std::mutex> & lock, uint64_t generation, uint64_t offset);
+    void CompactionLoop();
+    bool CompactionDue() const;
+
+    std::string mPath;
+    int mFd = -1;
+
+    std::mutex mMutex;
+    std::condition_variable mDurableCondition;
+    std::condition_variable mCompactionCondition;
+
+    Index mIndex;
+    uint64_t mEndOffset     = 0; // end of the last complete record
+    uint64_t mDurableOffset = 0; // everything before this is on stable storage
+    uint64_t mGeneration    = 0; // bumped whenever compaction swaps in a new file
+    uint64_t mLiveBytes     = 0; // size of the records the index points at
+    bool mSyncInFlight      = false;
+    bool mSwapPending       = false; // compaction swapped files but has not renamed the new one in place yet
+    bool mFailed            = false; // compaction could not put the new file in place; writes are refused
+    bool mCompactionRunning = false;
+    bool mStopping          = false;
+
+    std::thread mCompactionThread;
+};
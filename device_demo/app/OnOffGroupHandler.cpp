@@ -0,0 +1,77 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "OnOffGroupHandler.h"
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/InteractionModelEngine.h>
+#include <app/clusters/on-off-server/on-off-server.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+
+OnOffGroupHandler & OnOffGroupHandler::GetInstance()
+{
+    static OnOffGroupHandler sInstance;
+    return sInstance;
+}
+
+OnOffGroupHandler::OnOffGroupHandler() : CommandHandlerInterface(NullOptional, OnOff::Id) {}
+
+CHIP_ERROR OnOffGroupHandler::Init(GroupEndpointIndex & groups)
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+
+    mGroupInvoke.Init(groups);
+    ReturnErrorOnFailure(InteractionModelEngine::GetInstance()->RegisterCommandHandler(this));
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void OnOffGroupHandler::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    InteractionModelEngine::GetInstance()->UnregisterCommandHandler(this);
+    mRegistered = false;
+}
+
+void OnOffGroupHandler::InvokeCommand(HandlerContext & handlerContext)
+{
+    using namespace OnOff::Commands;
+
+    // Anything else goes on to the on-off server.
+    const CommandId command = handlerContext.mRequestPath.mCommandId;
+    VerifyOrReturn(command == Off::Id || command == On::Id || command == Toggle::Id);
+    VerifyOrReturn(handlerContext.mCommandHandler.GetSubjectDescriptor().authMode == Access::AuthMode::kGroup);
+
+    // The commands have no fields; group invokes get no response.
+    handlerContext.SetCommandHandled();
+    unsigned switched = 0;
+    const bool ran    = mGroupInvoke.Run(handlerContext.mCommandHandler, handlerContext.mRequestPath, [&](EndpointId endpoint) {
+        // What the on-off server's command callbacks do for each endpoint.
+        OnOffServer::Instance().setOnOffValue(endpoint, command, false);
+        switched++;
+    });
+    VerifyOrReturn(ran);
+    ChipLogDetail(Zcl, "Applied OnOff command 0x%02x on %u endpoints", static_cast<unsigned>(command), switched);
+}
@@ -0,0 +1,53 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/CommandHandlerInterface.h>
+#include <lib/core/CHIPError.h>
+
+#include "GroupEndpointIndex.h"
+#include "GroupInvokeFanout.h"
+
+/**
+ * Handles group-addressed OnOff Off, On and Toggle commands, switching all member endpoints
+ * through the on-off server from the first call of the invoke (see GroupInvokeFanout).
+ *
+ * Commands sent to a single endpoint, and the other OnOff commands, still go to the on-off
+ * server.
+ */
+class OnOffGroupHandler : public chip::app::CommandHandlerInterface
+{
+public:
+    static OnOffGroupHandler & GetInstance();
+
+    /**
+     * Registers with the interaction model engine. Call after Server::Init; `groups` must be the
+     * server's group data provider.
+     */
+    CHIP_ERROR Init(GroupEndpointIndex & groups);
+    void Shutdown();
+
+    void InvokeCommand(HandlerContext & handlerContext) override;
+
+private:
+    OnOffGroupHandler();
+
+    GroupInvokeFanout mGroupInvoke;
+    bool mRegistered = false;
+};
@@ -26,10 +26,6 @@
 
 #include <crypto/CHIPCryptoPAL.h>
 #include <lib/core/CHIPError.h>
-#include <lib/support/Base64.h>
-#include <lib/support/BytesToHex.h>
-
-#include <credentials/examples/DeviceAttestationCredsExample.h>
 
 using namespace chip;
 using namespace chip::ArgParser;
@@ -40,214 +36,118 @@ LinuxDeviceOptions gDeviceOptions;
 // Follow the code style of command line arguments in case we need to add more options in the future.
 enum
 {
-    kDeviceOption_BleDevice                             = 0x1000,
-    kDeviceOption_WiFi                                  = 0x1001,
-    kDeviceOption_Thread                                = 0x1002,
-    kDeviceOption_Version                               = 0x1003,
-    kDeviceOption_VendorID                              = 0x1004,
-    kDeviceOption_ProductID                             = 0x1005,
-    kDeviceOption_CustomFlow                            = 0x1006,
-    kDeviceOption_Capabilities                          = 0x1007,
-    kDeviceOption_Discriminator                         = 0x1008,
-    kDeviceOption_Passcode                              = 0x1009,
-    kDeviceOption_SecuredDevicePort                     = 0x100a,
-    kDeviceOption_SecuredCommissionerPort               = 0x100b,
-    kDeviceOption_UnsecuredCommissionerPort             = 0x100c,
-    kDeviceOption_Command                               = 0x100d,
-    kDeviceOption_PICS                                  = 0x100e,
-    kDeviceOption_KVS                                   = 0x100f,
-    kDeviceOption_InterfaceId                           = 0x1010,
-    kDeviceOption_Spake2pVerifierBase64                 = 0x1011,
-    kDeviceOption_Spake2pSaltBase64                     = 0x1012,
-    kDeviceOption_Spake2pIterations                     = 0x1013,
-    kDeviceOption_TraceFile                             = 0x1014,
-    kDeviceOption_TraceLog                              = 0x1015,
-    kDeviceOption_TraceDecode                           = 0x1016,
-    kOptionCSRResponseCSRIncorrectType                  = 0x1017,
-    kOptionCSRResponseCSRNonceIncorrectType             = 0x1018,
-    kOptionCSRResponseCSRNonceTooLong                   = 0x1019,
-    kOptionCSRResponseCSRNonceInvalid                   = 0x101a,
-    kOptionCSRResponseNOCSRElementsTooLong              = 0x101b,
-    kOptionCSRResponseAttestationSignatureIncorrectType = 0x101c,
-    kOptionCSRResponseAttestationSignatureInvalid       = 0x101d,
-    kOptionCSRResponseCSRExistingKeyPair                = 0x101e,
-    kDeviceOption_TestEventTriggerEnableKey             = 0x101f,
-    kCommissionerOption_FabricID                        = 0x1020,
+    kDeviceOption_VendorID                  = 0x1004,
+    kDeviceOption_ProductID                 = 0x1005,
+    kDeviceOption_Discriminator             = 0x1008,
+    kDeviceOption_Passcode                  = 0x1009,
+    kDeviceOption_SecuredDevicePort         = 0x100a,
+    kDeviceOption_UnsecuredCommissionerPort = 0x100c,
+    kDeviceOption_KVS                       = 0x100f,
+    kDeviceOption_Spake2pIterations         = 0x1013,
+    kDeviceOption_StartupTimeline           = 0x1021,
+    kDeviceOption_FactoryData               = 0x1022,
+    kDeviceOption_KvsBackend                = 0x1023,
+    kDeviceOption_KvsWriteBehind            = 0x1024,
+    kDeviceOption_LazyClusterInit           = 0x1025,
+    kDeviceOption_LightDriver               = 0x1026,
+    kDeviceOption_LevelStepMs               = 0x1027,
+    kDeviceOption_LevelPublishMs            = 0x1028,
+    kDeviceOption_BridgedLights             = 0x1029,
+    kDeviceOption_ReportTickMs              = 0x102A,
 };
 
 constexpr unsigned kAppUsageLength = 64;
 
 OptionDef sDeviceOptionDefs[] = {
-#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
-    { "ble-device", kArgumentRequired, kDeviceOption_BleDevice },
-#endif // CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
-#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
-    { "wifi", kNoArgument, kDeviceOption_WiFi },
-#endif // CHIP_DEVICE_CONFIG_ENABLE_WPA
-#if CHIP_ENABLE_OPENTHREAD
-    { "thread", kNoArgument, kDeviceOption_Thread },
-#endif // CHIP_ENABLE_OPENTHREAD
-    { "version", kArgumentRequired, kDeviceOption_Version },
     { "vendor-id", kArgumentRequired, kDeviceOption_VendorID },
     { "product-id", kArgumentRequired, kDeviceOption_ProductID },
-    { "custom-flow", kArgumentRequired, kDeviceOption_CustomFlow },
-    { "capabilities", kArgumentRequired, kDeviceOption_Capabilities },
     { "discriminator", kArgumentRequired, kDeviceOption_Discriminator },
     { "passcode", kArgumentRequired, kDeviceOption_Passcode },
-    { "spake2p-verifier-base64", kArgumentRequired, kDeviceOption_Spake2pVerifierBase64 },
-    { "spake2p-salt-base64", kArgumentRequired, kDeviceOption_Spake2pSaltBase64 },
     { "spake2p-iterations", kArgumentRequired, kDeviceOption_Spake2pIterations },
     { "secured-device-port", kArgumentRequired, kDeviceOption_SecuredDevicePort },
-    { "secured-commissioner-port", kArgumentRequired, kDeviceOption_SecuredCommissionerPort },
     { "unsecured-commissioner-port", kArgumentRequired, kDeviceOption_UnsecuredCommissionerPort },
-    { "command", kArgumentRequired, kDeviceOption_Command },
-    { "PICS", kArgumentRequired, kDeviceOption_PICS },
     { "KVS", kArgumentRequired, kDeviceOption_KVS },
-    { "interface-id", kArgumentRequired, kDeviceOption_InterfaceId },
-#if CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
-    { "trace_file", kArgumentRequired, kDeviceOption_TraceFile },
-    { "trace_log", kArgumentRequired, kDeviceOption_TraceLog },
-    { "trace_decode", kArgumentRequired, kDeviceOption_TraceDecode },
-#endif // CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
-    { "cert_error_csr_incorrect_type", kNoArgument, kOptionCSRResponseCSRIncorrectType },
-    { "cert_error_csr_existing_keypair", kNoArgument, kOptionCSRResponseCSRExistingKeyPair },
-    { "cert_error_csr_nonce_incorrect_type", kNoArgument, kOptionCSRResponseCSRNonceIncorrectType },
-    { "cert_error_csr_nonce_too_long", kNoArgument, kOptionCSRResponseCSRNonceTooLong },
-    { "cert_error_csr_nonce_invalid", kNoArgument, kOptionCSRResponseCSRNonceInvalid },
-    { "cert_error_nocsrelements_too_long", kNoArgument, kOptionCSRResponseNOCSRElementsTooLong },
-    { "cert_error_attestation_signature_incorrect_type", kNoArgument, kOptionCSRResponseAttestationSignatureIncorrectType },
-    { "cert_error_attestation_signature_invalid", kNoArgument, kOptionCSRResponseAttestationSignatureInvalid },
-    { "enable-key", kArgumentRequired, kDeviceOption_TestEventTriggerEnableKey },
-    { "commissioner-fabric-id", kArgumentRequired, kCommissionerOption_FabricID },
+    { "startup-timeline", kArgumentRequired, kDeviceOption_StartupTimeline },
+    { "factory-data", kArgumentRequired, kDeviceOption_FactoryData },
+    { "kvs-backend", kArgumentRequired, kDeviceOption_KvsBackend },
+    { "kvs-write-behind", kNoArgument, kDeviceOption_KvsWriteBehind },
+    { "lazy-cluster-init", kNoArgument, kDeviceOption_LazyClusterInit },
+    { "light-driver", kArgumentRequired, kDeviceOption_LightDriver },
+    { "level-step-ms", kArgumentRequired, kDeviceOption_LevelStepMs },
+    { "level-publish-ms", kArgumentRequired, kDeviceOption_LevelPublishMs },
+    { "bridged-lights", kArgumentRequired, kDeviceOption_BridgedLights },
+    { "report-tick-ms", kArgumentRequired, kDeviceOption_ReportTickMs },
     {}
 };
 
 const char * sDeviceOptionHelp =
-#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
-    "  --ble-device <number>\n"
-    "       The device number for CHIPoBLE, without 'hci' prefix, can be found by hciconfig.\n"
-#endif // CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
-#if CHIP_DEVICE_CONFIG_ENABLE_WPA
-    "\n"
-    "  --wifi\n"
-    "       Enable WiFi management via wpa_supplicant.\n"
-#endif // CHIP_DEVICE_CONFIG_ENABLE_WPA
-#if CHIP_ENABLE_OPENTHREAD
-    "\n"
-    "  --thread\n"
-    "       Enable Thread management via ot-agent.\n"
-#endif // CHIP_ENABLE_OPENTHREAD
-    "\n"
-    "  --version <version>\n"
-    "       The version indication provides versioning of the setup payload.\n"
-    "\n"
     "  --vendor-id <id>\n"
     "       The Vendor ID is assigned by the Connectivity Standards Alliance.\n"
     "\n"
     "  --product-id <id>\n"
     "       The Product ID is specified by vendor.\n"
     "\n"
-    "  --custom-flow <Standard = 0 | UserActionRequired = 1 | Custom = 2>\n"
-    "       A 2-bit unsigned enumeration specifying manufacturer-specific custom flow options.\n"
-    "\n"
-    "  --capabilities <None = 0, SoftAP = 1 << 0, BLE = 1 << 1, OnNetwork = 1 << 2>\n"
-    "       Discovery Capabilities Bitmask which contains information about Device’s available technologies for device discovery.\n"
-    "\n"
     "  --discriminator <discriminator>\n"
     "       A 12-bit unsigned integer match the value which a device advertises during commissioning.\n"
     "\n"
     "  --passcode <passcode>\n"
-    "       A 27-bit unsigned integer, which serves as proof of possession during commissioning. \n"
-    "       If not provided to compute a verifier, the --spake2p-verifier-base64 must be provided. \n"
-    "\n"
-    "  --spake2p-verifier-base64 <PASE verifier as base64>\n"
-    "       A raw concatenation of 'W0' and 'L' (67 bytes) as base64 to override the verifier\n"
-    "       auto-computed from the passcode, if provided.\n"
-    "\n"
-    "  --spake2p-salt-base64 <PASE salt as base64>\n"
-    "       16-32 bytes of salt to use for the PASE verifier, as base64. If omitted, will be generated\n"
-    "       randomly. If a --spake2p-verifier-base64 is passed, it must match against the salt otherwise\n"
-    "       failure will arise.\n"
+    "       A 27-bit unsigned integer, which serves as proof of possession during commissioning.\n"
     "\n"
     "  --spake2p-iterations <PASE PBKDF iterations>\n"
-    "       Number of PBKDF iterations to use. If omitted, will be 1000. If a --spake2p-verifier-base64 is\n"
-    "       passed, the iteration counts must match that used to generate the verifier otherwise failure will\n"
-    "       arise.\n"
+    "       Number of PBKDF iterations to use. If omitted, will be 1000.\n"
     "\n"
     "  --secured-device-port <port>\n"
     "       A 16-bit unsigned integer specifying the listen port to use for secure device messages (default is 5540).\n"
     "\n"
-    "  --secured-commissioner-port <port>\n"
-    "       A 16-bit unsigned integer specifying the listen port to use for secure commissioner messages (default is 5542). Only "
-    "valid when app is both device and commissioner\n"
-    "\n"
     "  --unsecured-commissioner-port <port>\n"
     "       A 16-bit unsigned integer specifying the port to use for unsecured commissioner messages (default is 5550).\n"
     "\n"
-    "  --commissioner-fabric-id <fabricid>\n"
-    "       The fabric ID to be used when this device is a commissioner (default in code is 1).\n"
+    "  --KVS <filepath>\n"
+    "       A file to store Key Value Store items (default " CHIP_DEVICE_KVS_PATH "). With --kvs-backend log this is\n"
+    "       the server storage log instead, and the platform key-value store keeps its default file.\n"
     "\n"
-    "  --command <command-name>\n"
-    "       A name for a command to execute during startup.\n"
+    "  Vendor and product ids, discriminator, passcode and iterations given with --factory-data are taken from\n"
+    "  the image instead.\n"
     "\n"
-    "  --PICS <filepath>\n"
-    "       A file containing PICS items.\n"
+    "  --startup-timeline <filepath>\n"
+    "       Write the duration of each startup phase to the provided file as Chrome trace-event JSON.\n"
     "\n"
-    "  --KVS <filepath>\n"
-    "       A file to store Key Value Store items.\n"
+    "  --factory-data <filepath>\n"
+    "       Map a read-only factory data image and serve vendor/product ids, hardware version, discriminator,\n"
+    "       SPAKE2+ parameters and attestation credentials from it. Nothing is written to the configuration\n"
+    "       store at boot when this is set.\n"
+    "\n"
+    "  --kvs-backend <file|log>\n"
+    "       Storage used by the server for fabrics, ACLs, group keys and labels. 'file' (default) is the platform\n"
+    "       key-value store; 'log' is an append-only log at the --KVS path (default " CHIP_DEVICE_KVS_LOG_PATH ").\n"
+    "\n"
+    "  --kvs-write-behind\n"
+    "       Apply server storage writes on a background thread instead of the event loop. Queued writes are\n"
+    "       flushed when commissioning completes and on shutdown.\n"
     "\n"
-    "  --interface-id <interface>\n"
-    "       A interface id to advertise on.\n"
-#if CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
+    "  --lazy-cluster-init\n"
+    "       Defer the init callbacks of the network diagnostics, Diagnostic Logs, Software Diagnostics, Switch\n"
+    "       and OTA Requestor clusters until the first read, write or invoke that targets them.\n"
     "\n"
-    "  --trace_file <file>\n"
-    "       Output trace data to the provided file.\n"
-    "  --trace_log <1/0>\n"
-    "       A value of 1 enables traces to go to the log, 0 disables this (default 0).\n"
-    "  --trace_decode <1/0>\n"
-    "       A value of 1 enables traces decoding, 0 disables this (default 0).\n"
-#endif // CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
-    "  --cert_error_csr_incorrect_type\n"
-    "       Configure the CSRResponse to be built with an invalid CSR type.\n"
-    "  --cert_error_csr_existing_keypair\n"
-    "       Configure the CSRResponse to be built with a CSR where the keypair already exists.\n"
-    "  --cert_error_csr_nonce_incorrect_type\n"
-    "       Configure the CSRResponse to be built with an invalid CSRNonce type.\n"
-    "  --cert_error_csr_nonce_too_long\n"
-    "       Configure the CSRResponse to be built with a CSRNonce that is longer than expected.\n"
-    "  --cert_error_csr_nonce_invalid\n"
-    "       Configure the CSRResponse to be built with a CSRNonce that does not match the CSRNonce from the CSRRequest.\n"
-    "  --cert_error_nocsrelements_too_long\n"
-    "       Configure the CSRResponse to contains an NOCSRElements larger than the allowed RESP_MAX.\n"
-    "  --cert_error_attestation_signature_incorrect_type\n"
-    "       Configure the CSRResponse to be build with an invalid AttestationSignature type.\n"
-    "  --cert_error_attestation_signature_invalid\n"
-    "       Configure the CSRResponse to be build with an AttestationSignature that does not match what is expected.\n"
-    "  --enable-key <key>\n"
-    "       A 16-byte, hex-encoded key, used to validate TestEventTrigger command of Generial Diagnostics cluster\n"
+    "  --light-driver <file:<path>[:<max>]|shm:<name>|record>\n"
+    "       Drive the light's on/off state and level from a background thread: write the brightness, scaled to\n"
+    "       0..max (default 254), to a file such as a sysfs LED or PWM attribute; publish it in a POSIX shared\n"
+    "       memory object; or record it in memory for tests.\n"
+    "\n"
+    "  --level-step-ms <ms>\n"
+    "       Shortest interval between two steps of a level transition (default 20, rounded up to 10 ms ticks).\n"
+    "\n"
+    "  --level-publish-ms <ms>\n"
+    "       Shortest interval between two CurrentLevel updates during a level transition (default 100).\n"
+    "\n"
+    "  --bridged-lights <count>\n"
+    "       Add <count> dynamic light endpoints with the clusters of endpoint 1 at startup (at most\n"
+    "       CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT).\n"
+    "\n"
+    "  --report-tick-ms <ms>\n"
+    "       Spacing of the shared grid that attribute changes are flushed to subscriptions on (default 100).\n"
     "\n";
 
-bool Base64ArgToVector(const char * arg, size_t maxSize, std::vector<uint8_t> & outVector)
-{
-    size_t maxBase64Size = BASE64_ENCODED_LEN(maxSize);
-    outVector.resize(maxSize);
-
-    size_t argLen = strlen(arg);
-    if (argLen > maxBase64Size)
-    {
-        return false;
-    }
-
-    size_t decodedLen = chip::Base64Decode32(arg, argLen, reinterpret_cast<uint8_t *>(outVector.data()));
-    if (decodedLen == 0)
-    {
-        return false;
-    }
-
-    outVector.resize(decodedLen);
-    return true;
-}
-
 bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier, const char * aName, const char * aValue)
 {
     bool retval = true;
@@ -255,26 +155,6 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
     switch (aIdentifier)
     {
 
-    case kDeviceOption_BleDevice:
-        if (!ParseInt(aValue, LinuxDeviceOptions::GetInstance().mBleDevice))
-        {
-            PrintArgError("%s: invalid value specified for ble device number: %s\n", aProgram, aValue);
-            retval = false;
-        }
-        break;
-
-    case kDeviceOption_WiFi:
-        LinuxDeviceOptions::GetInstance().mWiFi = true;
-        break;
-
-    case kDeviceOption_Thread:
-        LinuxDeviceOptions::GetInstance().mThread = true;
-        break;
-
-    case kDeviceOption_Version:
-        LinuxDeviceOptions::GetInstance().payload.version = static_cast<uint8_t>(atoi(aValue));
-        break;
-
     case kDeviceOption_VendorID:
         LinuxDeviceOptions::GetInstance().payload.vendorID = static_cast<uint16_t>(atoi(aValue));
         break;
@@ -283,14 +163,6 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         LinuxDeviceOptions::GetInstance().payload.productID = static_cast<uint16_t>(atoi(aValue));
         break;
 
-    case kDeviceOption_CustomFlow:
-        LinuxDeviceOptions::GetInstance().payload.commissioningFlow = static_cast<CommissioningFlow>(atoi(aValue));
-        break;
-
-    case kDeviceOption_Capabilities:
-        LinuxDeviceOptions::GetInstance().payload.rendezvousInformation.Emplace().SetRaw(static_cast<uint8_t>(atoi(aValue)));
-        break;
-
     case kDeviceOption_Discriminator: {
         uint16_t value = static_cast<uint16_t>(atoi(aValue));
         if (value >= 4096)
@@ -309,57 +181,6 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         LinuxDeviceOptions::GetInstance().payload.setUpPINCode = static_cast<uint32_t>(atoi(aValue));
         break;
 
-    case kDeviceOption_Spake2pSaltBase64: {
-        constexpr size_t kMaxSize = chip::Crypto::kSpake2p_Max_PBKDF_Salt_Length;
-        std::vector<uint8_t> saltVector;
-
-        bool success = Base64ArgToVector(aValue, kMaxSize, saltVector);
-
-        if (!success)
-        {
-            PrintArgError("%s: ERROR: Base64 format for argument %s was invalid\n", aProgram, aName);
-            retval = false;
-            break;
-        }
-
-        if ((saltVector.size() < chip::Crypto::kSpake2p_Min_PBKDF_Salt_Length) ||
-            (saltVector.size() > chip::Crypto::kSpake2p_Max_PBKDF_Salt_Length))
-        {
-            PrintArgError("%s: ERROR: argument %s not in range [%u, %u]\n", aProgram, aName,
-                          chip::Crypto::kSpake2p_Min_PBKDF_Salt_Length, chip::Crypto::kSpake2p_Max_PBKDF_Salt_Length);
-            retval = false;
-            break;
-        }
-
-        LinuxDeviceOptions::GetInstance().spake2pSalt.SetValue(std::move(saltVector));
-        break;
-    }
-
-    case kDeviceOption_Spake2pVerifierBase64: {
-        constexpr size_t kMaxSize = chip::Crypto::kSpake2p_VerifierSerialized_Length;
-        std::vector<uint8_t> serializedVerifier;
-
-        bool success = Base64ArgToVector(aValue, kMaxSize, serializedVerifier);
-
-        if (!success)
-        {
-            PrintArgError("%s: ERROR: Base64 format for argument %s was invalid\n", aProgram, aName);
-            retval = false;
-            break;
-        }
-
-        if (serializedVerifier.size() != chip::Crypto::kSpake2p_VerifierSerialized_Length)
-        {
-            PrintArgError("%s: ERROR: argument %s should contain base64 for a %u bytes octet string \n", aProgram, aName,
-                          chip::Crypto::kSpake2p_VerifierSerialized_Length);
-            retval = false;
-            break;
-        }
-
-        LinuxDeviceOptions::GetInstance().spake2pVerifier.SetValue(std::move(serializedVerifier));
-        break;
-    }
-
     case kDeviceOption_Spake2pIterations: {
         errno              = 0;
         uint32_t iterCount = static_cast<uint32_t>(strtoul(aValue, nullptr, 0));
@@ -385,91 +206,83 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         LinuxDeviceOptions::GetInstance().securedDevicePort = static_cast<uint16_t>(atoi(aValue));
         break;
 
-    case kDeviceOption_SecuredCommissionerPort:
-        LinuxDeviceOptions::GetInstance().securedCommissionerPort = static_cast<uint16_t>(atoi(aValue));
-        break;
-
     case kDeviceOption_UnsecuredCommissionerPort:
         LinuxDeviceOptions::GetInstance().unsecuredCommissionerPort = static_cast<uint16_t>(atoi(aValue));
         break;
 
-    case kDeviceOption_Command:
-        LinuxDeviceOptions::GetInstance().command = aValue;
-        break;
-
-    case kDeviceOption_PICS:
-        LinuxDeviceOptions::GetInstance().PICS = aValue;
-        break;
-
     case kDeviceOption_KVS:
         LinuxDeviceOptions::GetInstance().KVS = aValue;
         break;
 
-    case kDeviceOption_InterfaceId:
-        LinuxDeviceOptions::GetInstance().interfaceId =
-            Inet::InterfaceId(static_cast<chip::Inet::InterfaceId::PlatformType>(atoi(aValue)));
+    case kDeviceOption_StartupTimeline:
+        LinuxDeviceOptions::GetInstance().startupTimeline = aValue;
         break;
 
-#if CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
-    case kDeviceOption_TraceFile:
-        LinuxDeviceOptions::GetInstance().traceStreamFilename.SetValue(std::string{ aValue });
+    case kDeviceOption_FactoryData:
+        LinuxDeviceOptions::GetInstance().factoryData = aValue;
         break;
-    case kDeviceOption_TraceLog:
-        if (atoi(aValue) != 0)
+
+    case kDeviceOption_KvsBackend:
+        if (strcmp(aValue, "file") == 0)
         {
-            LinuxDeviceOptions::GetInstance().traceStreamToLogEnabled = true;
+            LinuxDeviceOptions::GetInstance().kvsBackend = LinuxDeviceOptions::KvsBackend::kFile;
         }
-        break;
-    case kDeviceOption_TraceDecode:
-        if (atoi(aValue) != 0)
+        else if (strcmp(aValue, "log") == 0)
         {
-            LinuxDeviceOptions::GetInstance().traceStreamDecodeEnabled = true;
+            LinuxDeviceOptions::GetInstance().kvsBackend = LinuxDeviceOptions::KvsBackend::kLog;
+        }
+        else
+        {
+            PrintArgError("%s: ERROR: invalid value specified for %s: %s\n", aProgram, aName, aValue);
+            retval = false;
         }
         break;
-#endif // CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
 
-    case kOptionCSRResponseCSRIncorrectType:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.csrIncorrectType = true;
-        break;
-    case kOptionCSRResponseCSRExistingKeyPair:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.csrExistingKeyPair = true;
-        break;
-    case kOptionCSRResponseCSRNonceIncorrectType:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.csrNonceIncorrectType = true;
-        break;
-    case kOptionCSRResponseCSRNonceTooLong:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.csrNonceTooLong = true;
+    case kDeviceOption_KvsWriteBehind:
+        LinuxDeviceOptions::GetInstance().kvsWriteBehind = true;
         break;
-    case kOptionCSRResponseCSRNonceInvalid:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.csrNonceInvalid = true;
-        break;
-    case kOptionCSRResponseNOCSRElementsTooLong:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.nocsrElementsTooLong = true;
-        break;
-    case kOptionCSRResponseAttestationSignatureIncorrectType:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.attestationSignatureIncorrectType = true;
+
+    case kDeviceOption_LazyClusterInit:
+        LinuxDeviceOptions::GetInstance().lazyClusterInit = true;
         break;
-    case kOptionCSRResponseAttestationSignatureInvalid:
-        LinuxDeviceOptions::GetInstance().mCSRResponseOptions.attestationSignatureInvalid = true;
+
+    case kDeviceOption_LightDriver:
+        LinuxDeviceOptions::GetInstance().lightDriver = aValue;
         break;
-    case kDeviceOption_TestEventTriggerEnableKey: {
-        constexpr size_t kEnableKeyLength = sizeof(LinuxDeviceOptions::GetInstance().testEventTriggerEnableKey);
 
-        if (Encoding::HexToBytes(aValue, strlen(aValue), LinuxDeviceOptions::GetInstance().testEventTriggerEnableKey,
-                                 kEnableKeyLength) != kEnableKeyLength)
+    case kDeviceOption_LevelStepMs:
+        if (!ParseInt(aValue, LinuxDeviceOptions::GetInstance().levelStepMs) || LinuxDeviceOptions::GetInstance().levelStepMs == 0)
         {
+            PrintArgError("%s: ERROR: invalid value specified for %s: %s\n", aProgram, aName, aValue);
+            retval = false;
+        }
+        break;
 
-            PrintArgError("%s: ERROR: invalid value specified for %s\n", aProgram, aName);
+    case kDeviceOption_BridgedLights:
+        if (!ParseInt(aValue, LinuxDeviceOptions::GetInstance().bridgedLights))
+        {
+            PrintArgError("%s: ERROR: invalid value specified for %s: %s\n", aProgram, aName, aValue);
             retval = false;
         }
+        break;
 
+    case kDeviceOption_ReportTickMs:
+        if (!ParseInt(aValue, LinuxDeviceOptions::GetInstance().reportTickMs) ||
+            LinuxDeviceOptions::GetInstance().reportTickMs == 0)
+        {
+            PrintArgError("%s: ERROR: invalid value specified for %s: %s\n", aProgram, aName, aValue);
+            retval = false;
+        }
         break;
-    }
-    case kCommissionerOption_FabricID: {
-        char * eptr;
-        LinuxDeviceOptions::GetInstance().commissionerFabricId = (chip::FabricId) strtoull(aValue, &eptr, 0);
+
+    case kDeviceOption_LevelPublishMs:
+        if (!ParseInt(aValue, LinuxDeviceOptions::GetInstance().levelPublishMs) ||
+            LinuxDeviceOptions::GetInstance().levelPublishMs == 0)
+        {
+            PrintArgError("%s: ERROR: invalid value specified for %s: %s\n", aProgram, aName, aValue);
+            retval = false;
+        }
         break;
-    }
 
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
@@ -510,9 +323,5 @@ CHIP_ERROR ParseArguments(int argc, char * const argv[], OptionSet * customOptio
 
 LinuxDeviceOptions & LinuxDeviceOptions::GetInstance()
 {
-    if (gDeviceOptions.dacProvider == nullptr)
-    {
-        gDeviceOptions.dacProvider = chip::Credentials::Examples::GetExampleDACProvider();
-    }
     return gDeviceOptions;
 }
@@ -25,42 +25,51 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
-#include <vector>
 
-#include <inet/InetInterface.h>
 #include <lib/core/CHIPError.h>
 #include <lib/core/Optional.h>
 #include <lib/support/CHIPArgParser.hpp>
 #include <setup_payload/SetupPayload.h>
 
-#include <credentials/DeviceAttestationCredsProvider.h>
-#include <testing/CustomCSRResponse.h>
+// Default file of the platform key-value store (no --KVS, or --kvs-backend log).
+#ifndef CHIP_DEVICE_KVS_PATH
+#define CHIP_DEVICE_KVS_PATH "/tmp/chip_kvs"
+#endif
+
+// Default location of the log-structured server storage (--kvs-backend log without --KVS).
+#ifndef CHIP_DEVICE_KVS_LOG_PATH
+#define CHIP_DEVICE_KVS_LOG_PATH "/tmp/chip_kvs_log"
+#endif
 
 struct LinuxDeviceOptions
 {
-    chip::PayloadContents payload;
+    chip::PayloadContents payload; // vendorID, productID and setUpPINCode; 0 when not given
     chip::Optional<uint16_t> discriminator;
-    chip::Optional<std::vector<uint8_t>> spake2pVerifier;
-    chip::Optional<std::vector<uint8_t>> spake2pSalt;
-    uint32_t spake2pIterations          = 0; // When not provided (0), will default elsewhere
-    uint32_t mBleDevice                 = 0;
-    bool mWiFi                          = false;
-    bool mThread                        = false;
-    uint32_t securedDevicePort          = CHIP_PORT;
-    uint32_t securedCommissionerPort    = CHIP_PORT + 2;
-    uint32_t unsecuredCommissionerPort  = CHIP_UDC_PORT;
-    const char * command                = nullptr;
-    const char * PICS                   = nullptr;
-    const char * KVS                    = nullptr;
-    chip::Inet::InterfaceId interfaceId = chip::Inet::InterfaceId::Null();
-    bool traceStreamDecodeEnabled       = false;
-    bool traceStreamToLogEnabled        = false;
-    chip::Optional<std::string> traceStreamFilename;
-    chip::Credentials::DeviceAttestationCredentialsProvider * dacProvider = nullptr;
-    chip::CSRResponseOptions mCSRResponseOptions;
-    uint8_t testEventTriggerEnableKey[16] = { 0 };
-    chip::FabricId commissionerFabricId   = chip::kUndefinedFabricId;
+    uint32_t spake2pIterations         = 0; // When not provided (0), will default elsewhere
+    uint32_t securedDevicePort         = CHIP_PORT;
+    uint32_t unsecuredCommissionerPort = CHIP_UDC_PORT;
+    const char * KVS                   = nullptr;
+    const char * startupTimeline       = nullptr;
+    const char * factoryData           = nullptr;
+    const char * lightDriver           = nullptr;
+
+    enum class KvsBackend : uint8_t
+    {
+        kFile, // platform key-value store
+        kLog,  // LogStructuredStorage at --KVS
+    };
+    KvsBackend kvsBackend = KvsBackend::kFile;
+    bool kvsWriteBehind   = false;
+    bool lazyClusterInit  = false;
+
+    // Level transition timing; 0 keeps the LevelTransitionEngine defaults.
+    uint32_t levelStepMs    = 0;
+    uint32_t levelPublishMs = 0;
+
+    uint32_t bridgedLights = 0;
+
+    // Report flush grid; 0 keeps the ReportCoalescer default.
+    uint32_t reportTickMs = 0;
 
     static LinuxDeviceOptions & GetInstance();
 };
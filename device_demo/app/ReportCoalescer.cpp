@@ -0,0 +1,306 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ReportCoalescer.h"
+
+#include <algorithm>
+
+#include <app/AttributePathParams.h>
+#include <app/InteractionModelEngine.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::System::Clock;
+
+namespace {
+
+constexpr size_t kBitsPerWord = 64;
+
+bool TestBit(const std::vector<uint64_t> & bitmap, size_t index)
+{
+    const size_t word = index / kBitsPerWord;
+    return word < bitmap.size() && (bitmap[word] & (uint64_t(1) << (index % kBitsPerWord))) != 0;
+}
+
+void SetBit(std::vector<uint64_t> & bitmap, size_t index)
+{
+    const size_t word = index / kBitsPerWord;
+    if (bitmap.size() <= word)
+    {
+        bitmap.resize(word + 1, 0);
+    }
+    bitmap[word] |= uint64_t(1) << (index % kBitsPerWord);
+}
+
+} // namespace
+
+size_t ReportCoalescer::PathHash::operator()(const ConcreteAttributePath & path) const
+{
+    const uint64_t key = (static_cast<uint64_t>(path.mClusterId) << 32) | path.mAttributeId;
+    return std::hash<uint64_t>()(key ^ (static_cast<uint64_t>(path.mEndpointId) * 0x9E3779B97F4A7C15ull));
+}
+
+bool ReportCoalescer::PathEqual::operator()(const ConcreteAttributePath & a, const ConcreteAttributePath & b) const
+{
+    return a.mEndpointId == b.mEndpointId && a.mClusterId == b.mClusterId && a.mAttributeId == b.mAttributeId;
+}
+
+ReportCoalescer & ReportCoalescer::GetInstance()
+{
+    static ReportCoalescer sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR ReportCoalescer::Init(const Config & config)
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(config.tick.count() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mConfig = config;
+
+    InteractionModelEngine::GetInstance()->RegisterReadHandlerAppCallback(this);
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void ReportCoalescer::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    DeviceLayer::SystemLayer().CancelTimer(OnTimer, this);
+    mTimerDeadline = Timestamp::max();
+    Flush(true);
+    InteractionModelEngine::GetInstance()->UnregisterReadHandlerAppCallback();
+    mSubscriptions.clear();
+    mPathIndex.clear();
+    mPaths.clear();
+    mRegistered = false;
+}
+
+void ReportCoalescer::MarkDirty(const ConcreteAttributePath & path)
+{
+    VerifyOrReturn(!mSubscriptions.empty(), Forward(path));
+
+    const size_t index = PathIndex(path);
+    bool interested    = false;
+    bool newlyPending  = false;
+    for (Subscription & subscription : mSubscriptions)
+    {
+        if (!TestBit(subscription.interested, index))
+        {
+            continue;
+        }
+
+        interested = true;
+        if (TestBit(subscription.dirty, index))
+        {
+            mDropped++;
+            continue;
+        }
+        SetBit(subscription.dirty, index);
+        newlyPending = newlyPending || (subscription.dirtyCount == 0);
+        subscription.dirtyCount++;
+    }
+
+    VerifyOrReturn(interested, Forward(path));
+    if (newlyPending)
+    {
+        ArmTimer();
+    }
+}
+
+CHIP_ERROR ReportCoalescer::OnSubscriptionRequested(ReadHandler & handler, Transport::SecureSession & session)
+{
+    (void) session;
+
+    uint16_t minIntervalSeconds = 0;
+    uint16_t maxIntervalSeconds = 0;
+    handler.GetReportingIntervals(minIntervalSeconds, maxIntervalSeconds);
+
+    // Rounding down keeps the max interval at or below what the subscriber asked for; it only
+    // has to stay at or above the min interval floor.
+    const uint16_t grid = mConfig.maxIntervalGrid.count();
+    VerifyOrReturnError(grid > 0, CHIP_NO_ERROR);
+    const uint16_t aligned = static_cast<uint16_t>(maxIntervalSeconds - maxIntervalSeconds % grid);
+    if (aligned != maxIntervalSeconds && aligned >= minIntervalSeconds && aligned > 0)
+    {
+        ReturnErrorOnFailure(handler.SetReportingIntervals(aligned));
+    }
+    return CHIP_NO_ERROR;
+}
+
+void ReportCoalescer::OnSubscriptionEstablished(ReadHandler & handler)
+{
+    uint16_t minIntervalSeconds = 0;
+    uint16_t maxIntervalSeconds = 0;
+    handler.GetReportingIntervals(minIntervalSeconds, maxIntervalSeconds);
+
+    Subscription subscription;
+    subscription.handler     = &handler;
+    subscription.minInterval = Seconds16(minIntervalSeconds);
+    subscription.maxInterval = Seconds16(maxIntervalSeconds);
+    // The engine has just sent the priming report.
+    subscription.lastFlush = System::SystemClock().GetMonotonicTimestamp();
+    for (size_t i = 0; i < mPaths.size(); i++)
+    {
+        if (IsInterested(handler, mPaths[i]))
+        {
+            SetBit(subscription.interested, i);
+        }
+    }
+    mSubscriptions.push_back(std::move(subscription));
+}
+
+void ReportCoalescer::OnSubscriptionTerminated(ReadHandler & handler)
+{
+    // What was pending for it alone is not reported anywhere, so there is nothing to flush.
+    mSubscriptions.erase(std::remove_if(mSubscriptions.begin(), mSubscriptions.end(),
+                                        [&](const Subscription & subscription) { return subscription.handler == &handler; }),
+                         mSubscriptions.end());
+    ArmTimer();
+}
+
+void ReportCoalescer::OnTimer(System::Layer * layer, void * context)
+{
+    (void) layer;
+    ReportCoalescer * self = static_cast<ReportCoalescer *>(context);
+    self->mTimerDeadline   = Timestamp::max();
+    self->Flush(false);
+    self->ArmTimer();
+}
+
+bool ReportCoalescer::IsInterested(const ReadHandler & handler, const ConcreteAttributePath & path)
+{
+    for (const ObjectList<AttributePathParams> * node = handler.GetAttributePathList(); node != nullptr; node = node->mpNext)
+    {
+        if (node->mValue.IsAttributePathSupersetOf(path))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ReportCoalescer::PathIndex(const ConcreteAttributePath & path)
+{
+    auto it = mPathIndex.find(path);
+    if (it != mPathIndex.end())
+    {
+        return it->second;
+    }
+
+    const size_t index = mPaths.size();
+    mPaths.push_back(path);
+    mPathIndex.emplace(path, index);
+    for (Subscription & subscription : mSubscriptions)
+    {
+        if (IsInterested(*subscription.handler, path))
+        {
+            SetBit(subscription.interested, index);
+        }
+    }
+    return index;
+}
+
+void ReportCoalescer::Forward(const ConcreteAttributePath & path)
+{
+    AttributePathParams params(path.mEndpointId, path.mClusterId, path.mAttributeId);
+    InteractionModelEngine::GetInstance()->GetReportingEngine().SetDirty(params);
+    mForwarded++;
+}
+
+void ReportCoalescer::Flush(bool all)
+{
+    // The union of what the due subscriptions have pending.
+    const Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    Bitmap flush;
+    for (Subscription & subscription : mSubscriptions)
+    {
+        if (subscription.dirtyCount == 0 || (!all && now < subscription.lastFlush + subscription.minInterval))
+        {
+            continue;
+        }
+        if (flush.size() < subscription.dirty.size())
+        {
+            flush.resize(subscription.dirty.size(), 0);
+        }
+        for (size_t word = 0; word < subscription.dirty.size(); word++)
+        {
+            flush[word] |= subscription.dirty[word];
+        }
+        subscription.lastFlush = now;
+    }
+
+    for (size_t word = 0; word < flush.size(); word++)
+    {
+        for (uint64_t bits = flush[word]; bits != 0; bits &= bits - 1)
+        {
+            Forward(mPaths[word * kBitsPerWord + static_cast<size_t>(__builtin_ctzll(bits))]);
+        }
+    }
+
+    // Everyone interested in a flushed path gets its latest value from the engine.
+    for (Subscription & subscription : mSubscriptions)
+    {
+        subscription.dirtyCount = 0;
+        for (size_t word = 0; word < subscription.dirty.size(); word++)
+        {
+            if (word < flush.size())
+            {
+                subscription.dirty[word] &= ~flush[word];
+            }
+            subscription.dirtyCount += static_cast<size_t>(__builtin_popcountll(subscription.dirty[word]));
+        }
+    }
+}
+
+void ReportCoalescer::ArmTimer()
+{
+    const Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    Timestamp next      = Timestamp::max();
+    for (const Subscription & subscription : mSubscriptions)
+    {
+        if (subscription.dirtyCount > 0)
+        {
+            // The first tick the min interval allows, unless that would overrun the max interval.
+            const Timestamp earliest = std::max(now, subscription.lastFlush + subscription.minInterval);
+            const Timestamp latest   = std::max(earliest, subscription.lastFlush + subscription.maxInterval);
+            next                     = std::min(next, std::min(AlignToTick(earliest), latest));
+        }
+    }
+    VerifyOrReturn(next != mTimerDeadline);
+    mTimerDeadline = next;
+    if (next == Timestamp::max())
+    {
+        DeviceLayer::SystemLayer().CancelTimer(OnTimer, this);
+        return;
+    }
+
+    // Even a flush due right now waits for the timer, so that changes made together (a batch, a
+    // group command) go out together. Starting the timer again replaces the pending one.
+    const Timestamp delay = (next > now) ? next - now : Timestamp(0);
+    DeviceLayer::SystemLayer().StartTimer(std::chrono::duration_cast<Milliseconds32>(delay), OnTimer, this);
+}
+
+Timestamp ReportCoalescer::AlignToTick(Timestamp time) const
+{
+    const uint64_t tick = mConfig.tick.count();
+    return Timestamp((time.count() + tick - 1) / tick * tick);
+}
@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <app/ConcreteAttributePath.h>
+#include <app/ReadHandler.h>
+#include <lib/core/CHIPError.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+/**
+ * Holds attribute changes back until a subscriber can be sent them.
+ *
+ * The producers in this app (AttributeUpdateBatch, and through it level transitions and scene
+ * recalls) call MarkDirty() instead of marking paths dirty in the reporting engine. Each
+ * subscription keeps a dirty bitmap over a compact table of the paths seen so far. A change sets
+ * the bit of every subscription interested in the path; a change to a path whose bit is still
+ * set only replaces a value that was never sent, and is counted as dropped.
+ *
+ * Once a subscription's min interval has passed since its last flush, its dirty paths go to the
+ * reporting engine once each, which reads and sends their latest values. A flushed path is
+ * cleared for every subscription, since the engine reports it to all of them. Paths no
+ * subscription is interested in are passed through right away.
+ *
+ * Flushes only happen on a tick grid shared by all subscriptions (Config::tick), so every
+ * subscription that is due by a tick is flushed in the same wake and the engine builds all of
+ * their reports in one run. A flush is never earlier than the min interval allows, and never
+ * later than the max interval. When a subscription is negotiated, its max interval is also
+ * rounded down to a multiple of Config::maxIntervalGrid, within the requested range. Keepalive
+ * reports that went out together then keep coinciding, even though the engine still runs one
+ * max interval timer per subscription.
+ *
+ * Only used from the CHIP stack thread.
+ */
+class ReportCoalescer : public chip::app::ReadHandler::ApplicationCallback
+{
+public:
+    struct Config
+    {
+        // Spacing of the shared flush grid.
+        chip::System::Clock::Milliseconds32 tick{ 100 };
+        // Negotiated max intervals are rounded down to a multiple of this.
+        chip::System::Clock::Seconds16 maxIntervalGrid{ 10 };
+    };
+
+    static ReportCoalescer & GetInstance();
+
+    /**
+     * Starts tracking subscriptions. Call after Server::Init; until then MarkDirty() passes
+     * every change through.
+     */
+    CHIP_ERROR Init(const Config & config);
+    // Flushes whatever is pending and stops tracking.
+    void Shutdown();
+
+    void MarkDirty(const chip::app::ConcreteAttributePath & path);
+
+    // Changes superseded before they were reported, summed over subscriptions.
+    size_t GetDroppedCount() const { return mDropped; }
+    // Paths handed to the reporting engine.
+    size_t GetForwardedCount() const { return mForwarded; }
+
+    // ReadHandler::ApplicationCallback
+    CHIP_ERROR OnSubscriptionRequested(chip::app::ReadHandler & handler, chip::Transport::SecureSession & session) override;
+    void OnSubscriptionEstablished(chip::app::ReadHandler & handler) override;
+    void OnSubscriptionTerminated(chip::app::ReadHandler & handler) override;
+
+private:
+    using Bitmap = std::vector<uint64_t>;
+
+    struct Subscription
+    {
+        chip::app::ReadHandler * handler = nullptr;
+        chip::System::Clock::Timestamp minInterval;
+        chip::System::Clock::Timestamp maxInterval;
+        chip::System::Clock::Timestamp lastFlush;
+        Bitmap interested; // by path index
+        Bitmap dirty;
+        size_t dirtyCount = 0;
+    };
+
+    struct PathHash
+    {
+        size_t operator()(const chip::app::ConcreteAttributePath & path) const;
+    };
+    struct PathEqual
+    {
+        bool operator()(const chip::app::ConcreteAttributePath & a, const chip::app::ConcreteAttributePath & b) const;
+    };
+
+    static void OnTimer(chip::System::Layer * layer, void * context);
+    static bool IsInterested(const chip::app::ReadHandler & handler, const chip::app::ConcreteAttributePath & path);
+
+    size_t PathIndex(const chip::app::ConcreteAttributePath & path);
+    void Forward(const chip::app::ConcreteAttributePath & path);
+    void Flush(bool all);
+    void ArmTimer();
+    // The first grid tick at or after `time`.
+    chip::System::Clock::Timestamp AlignToTick(chip::System::Clock::Timestamp time) const;
+
+    std::unordered_map<chip::app::ConcreteAttributePath, size_t, PathHash, PathEqual> mPathIndex;
+    std::vector<chip::app::ConcreteAttributePath> mPaths;
+    std::vector<Subscription> mSubscriptions;
+    Config mConfig;
+    // When the timer is due, Timestamp::max() if it is not running.
+    chip::System::Clock::Timestamp mTimerDeadline = chip::System::Clock::Timestamp::max();
+    bool mRegistered                              = false;
+    size_t mDropped                               = 0;
+    size_t mForwarded                             = 0;
+};
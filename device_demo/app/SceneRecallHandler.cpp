@@ -0,0 +1,169 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "SceneRecallHandler.h"
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/InteractionModelEngine.h>
+#include <app/clusters/scenes/scenes.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include "LevelControlCommandHandler.h"
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+using chip::Protocols::InteractionModel::Status;
+
+namespace {
+
+// Scenes in this group apply to every endpoint, member of a group or not.
+constexpr GroupId kGlobalSceneGroup = 0;
+
+bool FindScene(EndpointId endpoint, GroupId group, SceneId scene, EmberAfSceneTableEntry & entry)
+{
+    for (uint8_t i = 0; i < MATTER_SCENES_TABLE_SIZE; i++)
+    {
+        emberAfPluginScenesServerRetrieveSceneEntry(entry, i);
+        if (entry.endpoint == endpoint && entry.groupId == group && entry.sceneId == scene)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+SceneRecallHandler & SceneRecallHandler::GetInstance()
+{
+    static SceneRecallHandler sInstance;
+    return sInstance;
+}
+
+SceneRecallHandler::SceneRecallHandler() : CommandHandlerInterface(NullOptional, Scenes::Id) {}
+
+CHIP_ERROR SceneRecallHandler::Init(GroupEndpointIndex & groups)
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+
+    mGroups = &groups;
+    mGroupInvoke.Init(groups);
+    ReturnErrorOnFailure(InteractionModelEngine::GetInstance()->RegisterCommandHandler(this));
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void SceneRecallHandler::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    InteractionModelEngine::GetInstance()->UnregisterCommandHandler(this);
+    mRegistered = false;
+}
+
+void SceneRecallHandler::InvokeCommand(HandlerContext & handlerContext)
+{
+    using Scenes::Commands::RecallScene::DecodableType;
+
+    // Anything else goes on to the scenes server.
+    VerifyOrReturn(handlerContext.mRequestPath.mCommandId == Scenes::Commands::RecallScene::Id);
+
+    HandleCommand<DecodableType>(handlerContext, [this](HandlerContext & ctx, const DecodableType & request) {
+        if (ctx.mCommandHandler.GetSubjectDescriptor().authMode == Access::AuthMode::kGroup)
+        {
+            // Group invokes get no response.
+            RecallOnGroup(ctx.mCommandHandler, ctx.mRequestPath, request.groupId, request.sceneId);
+            return;
+        }
+
+        const Status status = Recall(ctx.mCommandHandler.GetAccessingFabricIndex(), ctx.mRequestPath.mEndpointId,
+                                     request.groupId, request.sceneId);
+        ctx.mCommandHandler.AddStatus(ctx.mRequestPath, status);
+    });
+}
+
+Status SceneRecallHandler::Recall(FabricIndex fabric, EndpointId endpoint, GroupId group, SceneId scene)
+{
+    mBatch.Clear();
+    const Status status = Stage(fabric, endpoint, group, scene);
+    VerifyOrReturnValue(status == Status::Success, status);
+
+    mBatch.Commit();
+    ChipLogDetail(Zcl, "Recalled scene %u of group 0x%04x on endpoint %u", scene, group, endpoint);
+    return Status::Success;
+}
+
+void SceneRecallHandler::RecallOnGroup(const CommandHandler & commandHandler, const ConcreteCommandPath & path, GroupId group,
+                                       SceneId scene)
+{
+    const FabricIndex fabric = commandHandler.GetAccessingFabricIndex();
+    unsigned recalled        = 0;
+
+    mBatch.Clear();
+    const bool ran = mGroupInvoke.Run(commandHandler, path, [&](EndpointId endpoint) {
+        if (Stage(fabric, endpoint, group, scene) == Status::Success)
+        {
+            recalled++;
+        }
+    });
+    VerifyOrReturn(ran);
+
+    mBatch.Commit();
+    ChipLogProgress(Zcl, "Recalled scene %u of group 0x%04x on %u endpoints", scene, group, recalled);
+}
+
+Status SceneRecallHandler::Stage(FabricIndex fabric, EndpointId endpoint, GroupId group, SceneId scene)
+{
+    if (group != kGlobalSceneGroup)
+    {
+        VerifyOrReturnValue(mGroups->HasEndpoint(fabric, group, endpoint), Status::InvalidCommand);
+    }
+
+    EmberAfSceneTableEntry entry;
+    VerifyOrReturnValue(FindScene(endpoint, group, scene, entry), Status::NotFound);
+
+#ifdef ZCL_USING_ON_OFF_CLUSTER_SERVER
+    if (entry.hasOnOffValue)
+    {
+        mBatch.Set(endpoint, OnOff::Id, OnOff::Attributes::OnOff::Id, ZCL_BOOLEAN_ATTRIBUTE_TYPE, entry.onOffValue);
+    }
+#endif
+#ifdef ZCL_USING_LEVEL_CONTROL_CLUSTER_SERVER
+    if (entry.hasCurrentLevelValue)
+    {
+        // The scene's level replaces whatever a running transition would have reached.
+        if (LevelControlCommandHandler::GetInstance().CancelTransition(endpoint))
+        {
+            mBatch.Set(endpoint, LevelControl::Id, LevelControl::Attributes::RemainingTime::Id, ZCL_INT16U_ATTRIBUTE_TYPE,
+                       uint16_t(0));
+        }
+        mBatch.Set(endpoint, LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id, ZCL_INT8U_ATTRIBUTE_TYPE,
+                   entry.currentLevelValue);
+    }
+#endif
+    mBatch.Set(endpoint, Scenes::Id, Scenes::Attributes::CurrentScene::Id, ZCL_INT8U_ATTRIBUTE_TYPE, scene);
+    mBatch.Set(endpoint, Scenes::Id, Scenes::Attributes::CurrentGroup::Id, ZCL_INT16U_ATTRIBUTE_TYPE, group);
+    mBatch.Set(endpoint, Scenes::Id, Scenes::Attributes::SceneValid::Id, ZCL_BOOLEAN_ATTRIBUTE_TYPE, true);
+    return Status::Success;
+}
@@ -0,0 +1,74 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/CommandHandlerInterface.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <protocols/interaction_model/StatusCode.h>
+
+#include "AttributeUpdateBatch.h"
+#include "GroupEndpointIndex.h"
+#include "GroupInvokeFanout.h"
+
+/**
+ * Handles the Scenes RecallScene command on every endpoint, applying the stored extension
+ * fields (OnOff, CurrentLevel) and the CurrentScene/CurrentGroup/SceneValid attributes as one
+ * AttributeUpdateBatch instead of one attribute write each.
+ *
+ * Each touched cluster gets a single data version bump per recall. A group-addressed recall is
+ * fanned out through GroupInvokeFanout: every member endpoint that has the Scenes server and
+ * passes the access check is recalled in one batch, so subscribers see the whole group change in
+ * one report run.
+ *
+ * Like the scenes server, the recall is applied at once; the TransitionTime of the command and
+ * of the scene are not used. The other Scenes commands still go to the scenes server, which
+ * owns the scene table.
+ */
+class SceneRecallHandler : public chip::app::CommandHandlerInterface
+{
+public:
+    static SceneRecallHandler & GetInstance();
+
+    /**
+     * Registers with the interaction model engine. Call after Server::Init; `groups` must be the
+     * server's group data provider.
+     */
+    CHIP_ERROR Init(GroupEndpointIndex & groups);
+    void Shutdown();
+
+    void InvokeCommand(HandlerContext & handlerContext) override;
+
+    chip::Protocols::InteractionModel::Status Recall(chip::FabricIndex fabric, chip::EndpointId endpoint, chip::GroupId group,
+                                                     chip::SceneId scene);
+
+private:
+    SceneRecallHandler();
+
+    void RecallOnGroup(const chip::app::CommandHandler & commandHandler, const chip::app::ConcreteCommandPath & path,
+                       chip::GroupId group, chip::SceneId scene);
+    // Adds the scene's values for `endpoint` to mBatch.
+    chip::Protocols::InteractionModel::Status Stage(chip::FabricIndex fabric, chip::EndpointId endpoint, chip::GroupId group,
+                                                    chip::SceneId scene);
+
+    AttributeUpdateBatch mBatch;
+    GroupInvokeFanout mGroupInvoke;
+    GroupEndpointIndex * mGroups = nullptr;
+    bool mRegistered             = false;
+};
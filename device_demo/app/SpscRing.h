@@ -0,0 +1,78 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Bounded, lock-free single-producer/single-consumer ring.
+ *
+ * Push may only be called from one thread and Pop from one (other) thread. Neither ever
+ * blocks: Push fails when the ring is full, Pop when it is empty. Callers that need to sleep
+ * while waiting pair the ring with their own wakeup mechanism.
+ */
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    static constexpr size_t Capacity() { return N; }
+
+    /**
+     * Producer side. On failure (ring full) `item` is left untouched.
+     */
+    bool Push(T && item)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == N)
+        {
+            return false;
+        }
+        mSlots[tail & (N - 1)] = std::move(item);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side.
+     */
+    bool Pop(T & item)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = std::move(mSlots[head & (N - 1)]);
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+private:
+    T mSlots[N];
+    // Kept on separate cache lines so producer and consumer don't false-share.
+    alignas(64) std::atomic<size_t> mHead{ 0 };
+    alignas(64) std::atomic<size_t> mTail{ 0 };
+};
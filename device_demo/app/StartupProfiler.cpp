@@ -0,0 +1,171 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "StartupProfiler.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+StartupProfiler & StartupProfiler::GetInstance()
+{
+    static StartupProfiler sInstance;
+    return sInstance;
+}
+
+uint32_t StartupProfiler::CurrentThreadIndex()
+{
+    // Small stable per-thread numbers keep the trace readable; the first thread to record is 1.
+    static std::atomic<uint32_t> sNextIndex{ 1 };
+    thread_local uint32_t sIndex = sNextIndex++;
+    return sIndex;
+}
+
+const char * StartupProfiler::CategoryName(Category category)
+{
+    switch (category)
+    {
+    case Category::kPluginInit:
+        return "plugin-init";
+    case Category::kClusterInit:
+        return "cluster-init";
+    case Category::kPhase:
+    default:
+        return "startup";
+    }
+}
+
+void StartupProfiler::Record(const char * name, System::Clock::Microseconds64 start, System::Clock::Microseconds64 end,
+                             Category category, EndpointId endpoint)
+{
+    Phase phase = { name, start.count(), end.count() - start.count(), CurrentThreadIndex(), category, endpoint };
+
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturn(!mStopped);
+    mPhases.push_back(phase);
+}
+
+void StartupProfiler::Stop()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mStopped = true;
+}
+
+void StartupProfiler::LogSummary()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturn(!mPhases.empty());
+
+    std::sort(mPhases.begin(), mPhases.end(), [](const Phase & a, const Phase & b) { return a.startUs < b.startUs; });
+
+    uint64_t origin = mPhases.front().startUs;
+    for (const Phase & phase : mPhases)
+    {
+        if (phase.category != Category::kPhase)
+        {
+            continue;
+        }
+        ChipLogProgress(NotSpecified, "Startup phase %-28s +%8" PRIu64 " us  %8" PRIu64 " us  (thread %u)", phase.name,
+                        phase.startUs - origin, phase.durationUs, static_cast<unsigned>(phase.threadIndex));
+    }
+}
+
+void StartupProfiler::LogInitReport(size_t maxEntries)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    std::vector<const Phase *> inits;
+    uint64_t pluginTotalUs  = 0;
+    uint64_t clusterTotalUs = 0;
+    for (const Phase & phase : mPhases)
+    {
+        if (phase.category == Category::kPluginInit)
+        {
+            pluginTotalUs += phase.durationUs;
+        }
+        else if (phase.category == Category::kClusterInit)
+        {
+            clusterTotalUs += phase.durationUs;
+        }
+        else
+        {
+            continue;
+        }
+        inits.push_back(&phase);
+    }
+    VerifyOrReturn(!inits.empty());
+
+    ChipLogProgress(NotSpecified, "Data model init: plugins %" PRIu64 " us, clusters %" PRIu64 " us, %u callbacks", pluginTotalUs,
+                    clusterTotalUs, static_cast<unsigned>(inits.size()));
+
+    std::sort(inits.begin(), inits.end(), [](const Phase * a, const Phase * b) { return a->durationUs > b->durationUs; });
+    inits.resize(std::min(inits.size(), maxEntries));
+
+    for (const Phase * phase : inits)
+    {
+        if (phase->endpoint != kInvalidEndpointId)
+        {
+            ChipLogProgress(NotSpecified, "  %-12s %-34s ep %-5u %8" PRIu64 " us", CategoryName(phase->category), phase->name,
+                            static_cast<unsigned>(phase->endpoint), phase->durationUs);
+        }
+        else
+        {
+            ChipLogProgress(NotSpecified, "  %-12s %-34s %-8s %8" PRIu64 " us", CategoryName(phase->category), phase->name, "",
+                            phase->durationUs);
+        }
+    }
+}
+
+CHIP_ERROR StartupProfiler::WriteTimeline(const char * path)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    FILE * file = fopen(path, "w");
+    VerifyOrReturnError(file != nullptr, CHIP_ERROR_POSIX(errno));
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (size_t i = 0; i < mPhases.size(); i++)
+    {
+        const Phase & phase = mPhases[i];
+        fprintf(file,
+                "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ",\"dur\":%" PRIu64
+                ",\"pid\":1,\"tid\":%u",
+                (i == 0) ? "" : ",", phase.name, CategoryName(phase.category), phase.startUs, phase.durationUs,
+                static_cast<unsigned>(phase.threadIndex));
+        if (phase.endpoint != kInvalidEndpointId)
+        {
+            fprintf(file, ",\"args\":{\"endpoint\":%u}", static_cast<unsigned>(phase.endpoint));
+        }
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = (ferror(file) == 0);
+    ok      = (fclose(file) == 0) && ok;
+    VerifyOrReturnError(ok, CHIP_ERROR_POSIX(errno));
+
+    ChipLogProgress(NotSpecified, "Startup timeline written to %s", path);
+    return CHIP_NO_ERROR;
+}
@@ -0,0 +1,109 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <system/SystemClock.h>
+
+/**
+ * Records how long each startup phase takes, using the monotonic system clock.
+ *
+ * Phases may be recorded from any thread. The collected timeline can be written out as a
+ * Chrome trace-event JSON file (loadable in chrome://tracing or Perfetto).
+ *
+ * Besides the application's own startup phases, the data model plugin and cluster init
+ * callbacks run during Server::Init are recorded individually (see DataModelInitHooks.cpp).
+ */
+class StartupProfiler
+{
+public:
+    enum class Category : uint8_t
+    {
+        kPhase,       // a step of ChipLinuxAppInit
+        kPluginInit,  // one MATTER_PLUGINS_INIT callback
+        kClusterInit, // one cluster init callback on one endpoint
+    };
+
+    /**
+     * RAII helper recording the lifetime of the object as one phase.
+     * The name must be a string literal (or otherwise outlive the profiler).
+     */
+    class ScopedPhase
+    {
+    public:
+        explicit ScopedPhase(const char * name) : mName(name), mStart(Now()) {}
+        ~ScopedPhase() { StartupProfiler::GetInstance().Record(mName, mStart, Now()); }
+
+    private:
+        const char * mName;
+        chip::System::Clock::Microseconds64 mStart;
+    };
+
+    static StartupProfiler & GetInstance();
+
+    static chip::System::Clock::Microseconds64 Now() { return chip::System::SystemClock().GetMonotonicMicroseconds64(); }
+
+    void Record(const char * name, chip::System::Clock::Microseconds64 start, chip::System::Clock::Microseconds64 end,
+                Category category = Category::kPhase, chip::EndpointId endpoint = chip::kInvalidEndpointId);
+
+    /**
+     * Ends the startup profile: Record() calls made afterwards (e.g. cluster init on a
+     * dynamic endpoint added at runtime) are dropped.
+     */
+    void Stop();
+
+    /**
+     * Logs one line per recorded Category::kPhase phase, in start order.
+     */
+    void LogSummary();
+
+    /**
+     * Logs the total time spent in plugin and cluster init callbacks, followed by the
+     * `maxEntries` slowest individual callbacks.
+     */
+    void LogInitReport(size_t maxEntries);
+
+    /**
+     * Writes the recorded phases to `path` as Chrome trace-event JSON.
+     */
+    CHIP_ERROR WriteTimeline(const char * path);
+
+private:
+    struct Phase
+    {
+        const char * name;
+        uint64_t startUs;
+        uint64_t durationUs;
+        uint32_t threadIndex;
+        Category category;
+        chip::EndpointId endpoint;
+    };
+
+    static const char * CategoryName(Category category);
+
+    static uint32_t CurrentThreadIndex();
+
+    std::mutex mLock;
+    std::vector<Phase> mPhases;
+    bool mStopped = false;
+};
@@ -0,0 +1,167 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "UserLabelServer.h"
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/server/Server.h>
+#include <app/util/af.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters::UserLabel;
+
+namespace {
+
+using UserLabelType = DeviceLayer::DeviceInfoProvider::UserLabelType;
+
+// The LabelStruct constraints; the spec default for both fields is empty, so empty is fine.
+bool IsValidLabelEntry(const Structs::LabelStruct::Type & entry)
+{
+    return entry.label.size() <= DeviceLayer::kMaxLabelNameLength && entry.value.size() <= DeviceLayer::kMaxLabelValueLength;
+}
+
+} // namespace
+
+UserLabelServer & UserLabelServer::GetInstance()
+{
+    static UserLabelServer sInstance;
+    return sInstance;
+}
+
+UserLabelServer::UserLabelServer() : AttributeAccessInterface(NullOptional, Clusters::UserLabel::Id) {}
+
+CHIP_ERROR UserLabelServer::Init(DeviceLayer::LightDeviceInfoProvider & provider)
+{
+    VerifyOrReturnError(!mRegistered, CHIP_ERROR_INCORRECT_STATE);
+
+    mProvider = &provider;
+    VerifyOrReturnError(registerAttributeAccessOverride(this), CHIP_ERROR_INCORRECT_STATE);
+    CHIP_ERROR err = Server::GetInstance().GetFabricTable().AddFabricDelegate(this);
+    if (err != CHIP_NO_ERROR)
+    {
+        unregisterAttributeAccessOverride(this);
+        return err;
+    }
+    mRegistered = true;
+    return CHIP_NO_ERROR;
+}
+
+void UserLabelServer::Shutdown()
+{
+    VerifyOrReturn(mRegistered);
+
+    Server::GetInstance().GetFabricTable().RemoveFabricDelegate(this);
+    unregisterAttributeAccessOverride(this);
+    mProvider   = nullptr;
+    mRegistered = false;
+}
+
+CHIP_ERROR UserLabelServer::Read(const ConcreteReadAttributePath & aPath, AttributeValueEncoder & aEncoder)
+{
+    switch (aPath.mAttributeId)
+    {
+    case Attributes::LabelList::Id:
+        return ReadLabelList(aPath.mEndpointId, aEncoder);
+    default:
+        return CHIP_NO_ERROR;
+    }
+}
+
+CHIP_ERROR UserLabelServer::Write(const ConcreteDataAttributePath & aPath, AttributeValueDecoder & aDecoder)
+{
+    switch (aPath.mAttributeId)
+    {
+    case Attributes::LabelList::Id:
+        return WriteLabelList(aPath, aDecoder);
+    default:
+        return CHIP_NO_ERROR;
+    }
+}
+
+CHIP_ERROR UserLabelServer::ReadLabelList(EndpointId endpoint, AttributeValueEncoder & aEncoder)
+{
+    DeviceLayer::DeviceInfoProvider::UserLabelIterator * it = mProvider->IterateUserLabel(endpoint);
+    VerifyOrReturnError(it != nullptr, aEncoder.EncodeEmptyList());
+
+    CHIP_ERROR err = aEncoder.EncodeList([it](const auto & encoder) -> CHIP_ERROR {
+        UserLabelType label;
+        while (it->Next(label))
+        {
+            ReturnErrorOnFailure(encoder.Encode(label));
+        }
+        return CHIP_NO_ERROR;
+    });
+    it->Release();
+    return err;
+}
+
+CHIP_ERROR UserLabelServer::WriteLabelList(const ConcreteDataAttributePath & aPath, AttributeValueDecoder & aDecoder)
+{
+    if (aPath.mListOp == ConcreteDataAttributePath::ListOperation::AppendItem)
+    {
+        Structs::LabelStruct::DecodableType entry;
+        ReturnErrorOnFailure(aDecoder.Decode(entry));
+        VerifyOrReturnError(IsValidLabelEntry(entry), CHIP_IM_GLOBAL_STATUS(ConstraintError));
+        return mProvider->AppendUserLabel(aPath.mEndpointId, entry);
+    }
+    VerifyOrReturnError(!aPath.IsListItemOperation(), CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE);
+
+    // The decoded labels point into the write request, which outlives this call.
+    UserLabelType labels[DeviceLayer::kMaxUserLabelListLength];
+    size_t count = 0;
+
+    Attributes::LabelList::TypeInfo::DecodableType list;
+    ReturnErrorOnFailure(aDecoder.Decode(list));
+    auto iter = list.begin();
+    while (iter.Next())
+    {
+        VerifyOrReturnError(IsValidLabelEntry(iter.GetValue()), CHIP_IM_GLOBAL_STATUS(ConstraintError));
+        VerifyOrReturnError(count < DeviceLayer::kMaxUserLabelListLength, CHIP_ERROR_INVALID_LIST_LENGTH);
+        labels[count++] = iter.GetValue();
+    }
+    ReturnErrorOnFailure(iter.GetStatus());
+
+    return mProvider->SetUserLabelList(aPath.mEndpointId, Span<const UserLabelType>(labels, count));
+}
+
+void UserLabelServer::OnFabricRemoved(const FabricTable & fabricTable, FabricIndex fabricIndex)
+{
+    // Removing the last fabric deletes everything created since commissioning, user labels
+    // included.
+    VerifyOrReturn(fabricTable.FabricCount() == 0);
+
+    ChipLogProgress(Zcl, "UserLabel: last fabric 0x%x removed, clearing all user labels", static_cast<unsigned>(fabricIndex));
+    for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+    {
+        const EndpointId endpoint = emberAfEndpointFromIndex(index);
+        if (!emberAfEndpointIndexIsEnabled(index) || !emberAfContainsServer(endpoint, Clusters::UserLabel::Id))
+        {
+            continue;
+        }
+        CHIP_ERROR err = mProvider->SetUserLabelList(endpoint, Span<const UserLabelType>());
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Zcl, "UserLabel: failed to clear endpoint %u: %" CHIP_ERROR_FORMAT, endpoint, err.Format());
+        }
+    }
+}
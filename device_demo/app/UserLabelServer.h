@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/AttributeAccessInterface.h>
+#include <credentials/FabricTable.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+#include "LightDeviceInfoProvider.h"
+
+/**
+ * Serves the User Label cluster on every endpoint in place of the SDK's UserLabelServer plugin,
+ * whose init the data model init hooks skip.
+ *
+ * The plugin hands a LabelList write to DeviceInfoProvider::SetUserLabelList, which stores the
+ * length and then every entry one by one, and clears the lists of all endpoints entry by entry
+ * when the last fabric is removed. A crash part way through leaves a mix of the old and the new
+ * labels. Here a list write and a clear each replace the endpoint's list with a single write of
+ * LightDeviceInfoProvider's packed record. Appends go through the provider as before; each of
+ * its calls is already one write.
+ */
+class UserLabelServer : public chip::app::AttributeAccessInterface, public chip::FabricTable::Delegate
+{
+public:
+    static UserLabelServer & GetInstance();
+
+    /**
+     * Registers the attribute access override and the fabric table delegate. Call after
+     * Server::Init.
+     */
+    CHIP_ERROR Init(chip::DeviceLayer::LightDeviceInfoProvider & provider);
+    void Shutdown();
+
+    CHIP_ERROR Read(const chip::app::ConcreteReadAttributePath & aPath, chip::app::AttributeValueEncoder & aEncoder) override;
+    CHIP_ERROR Write(const chip::app::ConcreteDataAttributePath & aPath, chip::app::AttributeValueDecoder & aDecoder) override;
+
+    void OnFabricRemoved(const chip::FabricTable & fabricTable, chip::FabricIndex fabricIndex) override;
+
+private:
+    UserLabelServer();
+
+    CHIP_ERROR ReadLabelList(chip::EndpointId endpoint, chip::app::AttributeValueEncoder & aEncoder);
+    CHIP_ERROR WriteLabelList(const chip::app::ConcreteDataAttributePath & aPath, chip::app::AttributeValueDecoder & aDecoder);
+
+    chip::DeviceLayer::LightDeviceInfoProvider * mProvider = nullptr;
+    bool mRegistered                                       = false;
+};
@@ -0,0 +1,280 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "WriteBehindStorageDelegate.h"
+
+#include <string.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+namespace {
+
+// Fabric table entries ("f/<index>/..." covers NOCs, keys, metadata and ACLs), the fabric
+// index list and the fail-safe markers. Losing any of them to a crash can leave the device
+// with a fabric it cannot authenticate, so they are written through.
+//
+// So are the PersistedCounter epochs: the group data and control message counters and the
+// event number. Rolling one back after a crash reuses values already sent on the wire, which
+// peers reject as replays or take as duplicates.
+constexpr const char * kWriteThroughKeys[] = { "g/fidx", "g/gdc", "g/gcc", "g/im/ec" };
+
+bool IsWriteThroughKey(const char * key)
+{
+    VerifyOrReturnValue(strncmp(key, "f/", 2) != 0 && strncmp(key, "g/fs/", 5) != 0, true);
+    for (const char * writeThroughKey : kWriteThroughKeys)
+    {
+        VerifyOrReturnValue(strcmp(key, writeThroughKey) != 0, true);
+    }
+    return false;
+}
+
+} // namespace
+
+CHIP_ERROR WriteBehindStorageDelegate::Init(PersistentStorageDelegate * backend)
+{
+    VerifyOrReturnError(backend != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mWriter.joinable(), CHIP_ERROR_INCORRECT_STATE);
+
+    mBackend  = backend;
+    mStopping = false;
+    mWriter   = std::thread(&WriteBehindStorageDelegate::WriterLoop, this);
+    return CHIP_NO_ERROR;
+}
+
+void WriteBehindStorageDelegate::Shutdown()
+{
+    VerifyOrReturn(mWriter.joinable());
+
+    CHIP_ERROR err = Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Write-behind flush on shutdown failed: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWriterWake.notify_one();
+    mWriter.join();
+    mPending.clear();
+    mBackend = nullptr;
+}
+
+CHIP_ERROR WriteBehindStorageDelegate::Flush()
+{
+    VerifyOrReturnError(mWriter.joinable(), CHIP_NO_ERROR);
+
+    const uint64_t target = mNextSeq - 1;
+    CHIP_ERROR err        = CHIP_NO_ERROR;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWriterWake.notify_one();
+        mWriterProgress.wait(lock, [this, target] { return mAppliedSeq.load(std::memory_order_acquire) >= target; });
+        err            = mDeferredError;
+        mDeferredError = CHIP_NO_ERROR;
+    }
+
+    PrunePending();
+    return err;
+}
+
+CHIP_ERROR WriteBehindStorageDelegate::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mPending.find(key);
+    if (it != mPending.end() && it->second.seq > mAppliedSeq.load(std::memory_order_acquire))
+    {
+        const PendingValue & pending = it->second;
+        VerifyOrReturnError(!pending.removed, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+        const uint16_t valueSize = static_cast<uint16_t>(pending.value.size());
+        const uint16_t copySize  = (size < valueSize) ? size : valueSize;
+        if (copySize > 0)
+        {
+            VerifyOrReturnError(buffer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+            memcpy(buffer, pending.value.data(), copySize);
+        }
+        size = copySize;
+        return (copySize < valueSize) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+    }
+
+    return mBackend->SyncGetKeyValue(key, buffer, size);
+}
+
+CHIP_ERROR WriteBehindStorageDelegate::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr && (value != nullptr || size == 0), CHIP_ERROR_INVALID_ARGUMENT);
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(value);
+
+    WriteOp op;
+    op.key = key;
+    op.value.assign(bytes, bytes + size);
+    Enqueue(std::move(op));
+    return IsWriteThroughKey(key) ? Flush() : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteBehindStorageDelegate::SyncDeleteKeyValue(const char * key)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Keep the backend's contract of reporting missing keys.
+    uint16_t size  = 0;
+    CHIP_ERROR err = SyncGetKeyValue(key, nullptr, size);
+    VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL, err);
+
+    WriteOp op;
+    op.key    = key;
+    op.remove = true;
+    Enqueue(std::move(op));
+    return IsWriteThroughKey(key) ? Flush() : CHIP_NO_ERROR;
+}
+
+void WriteBehindStorageDelegate::Enqueue(WriteOp && op)
+{
+    op.seq = mNextSeq++;
+
+    PendingValue & pending = mPending[op.key];
+    pending.value          = op.value;
+    pending.removed        = op.remove;
+    pending.seq            = op.seq;
+
+    // Backpressure: if the persistence thread is this far behind, wait for it to make room.
+    // The ring only fills up with the kQueueDepth writes before this one, so there is room
+    // again once the oldest of them has been applied.
+    const uint64_t oldestQueued = op.seq - kQueueDepth;
+    while (!mQueue.Push(std::move(op)))
+    {
+        WakeWriter();
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWriterProgress.wait(lock, [this, oldestQueued] { return mAppliedSeq.load(std::memory_order_acquire) >= oldestQueued; });
+    }
+    WakeWriter();
+
+    if (mPending.size() > 2 * kQueueDepth)
+    {
+        PrunePending();
+    }
+}
+
+void WriteBehindStorageDelegate::WakeWriter()
+{
+    // Pairs with the fence in WriterLoop: either the writer sees the new item before going to
+    // sleep, or we see it idle and take the mutex to wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mWriterIdle.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWriterWake.notify_one();
+    }
+}
+
+void WriteBehindStorageDelegate::PrunePending()
+{
+    const uint64_t applied = mAppliedSeq.load(std::memory_order_acquire);
+    for (auto it = mPending.begin(); it != mPending.end();)
+    {
+        it = (it->second.seq <= applied) ? mPending.erase(it) : std::next(it);
+    }
+}
+
+void WriteBehindStorageDelegate::WriterLoop()
+{
+    std::vector<WriteOp> batch;
+    std::unordered_map<std::string, size_t> latest;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWriterIdle.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            mWriterWake.wait(lock, [this] { return mStopping || !mQueue.Empty(); });
+            mWriterIdle.store(false, std::memory_order_relaxed);
+            if (mStopping && mQueue.Empty())
+            {
+                return;
+            }
+        }
+
+        // Drain everything queued so far. A later write to a key supersedes an earlier one;
+        // the survivor keeps its own (later) position so cross-key ordering is preserved.
+        batch.clear();
+        latest.clear();
+        uint64_t lastSeq = 0;
+        WriteOp op;
+        while (mQueue.Pop(op))
+        {
+            lastSeq = op.seq;
+            auto it = latest.find(op.key);
+            if (it != latest.end())
+            {
+                batch[it->second].key.clear();
+                mCoalescedWrites.fetch_add(1, std::memory_order_relaxed);
+                it->second = batch.size();
+            }
+            else
+            {
+                latest.emplace(op.key, batch.size());
+            }
+            batch.push_back(std::move(op));
+        }
+
+        CHIP_ERROR firstError = CHIP_NO_ERROR;
+        for (const WriteOp & write : batch)
+        {
+            if (write.key.empty())
+            {
+                continue;
+            }
+
+            CHIP_ERROR err = write.remove
+                ? mBackend->SyncDeleteKeyValue(write.key.c_str())
+                : mBackend->SyncSetKeyValue(write.key.c_str(), write.value.data(), static_cast<uint16_t>(write.value.size()));
+            if (write.remove && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+            {
+                err = CHIP_NO_ERROR;
+            }
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(DeviceLayer, "Write-behind of %s failed: %" CHIP_ERROR_FORMAT, write.key.c_str(), err.Format());
+                if (firstError == CHIP_NO_ERROR)
+                {
+                    firstError = err;
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mDeferredError == CHIP_NO_ERROR)
+            {
+                mDeferredError = firstError;
+            }
+            mAppliedSeq.store(lastSeq, std::memory_order_release);
+        }
+        mWriterProgress.notify_all();
+    }
+}
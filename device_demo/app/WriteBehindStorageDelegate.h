@@ -0,0 +1,122 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+
+#include "SpscRing.h"
+
+/**
+ * PersistentStorageDelegate that takes writes off the calling thread.
+ *
+ * Sets and deletes are queued on a lock-free ring and return immediately; a persistence thread
+ * drains the ring, coalesces repeated writes to the same key and applies the result to the
+ * backend. Until a write has landed, reads through this delegate see the queued value.
+ *
+ * Everything except the persistence thread must run on a single thread (the CHIP stack
+ * thread), and the backend must tolerate reads from that thread concurrent with writes from
+ * the persistence thread.
+ *
+ * Queued writes are not durable. Call Flush() wherever durability is required; it returns
+ * once everything queued so far has been applied, along with any error the persistence thread
+ * hit since the previous flush. Writes to fabric table, ACL and fail-safe keys and to the
+ * message and event counters flush before returning, so commissioning state and counter epochs
+ * are never only in the queue.
+ */
+class WriteBehindStorageDelegate : public chip::PersistentStorageDelegate
+{
+public:
+    static constexpr size_t kQueueDepth = 64;
+
+    WriteBehindStorageDelegate() = default;
+    ~WriteBehindStorageDelegate() override { Shutdown(); }
+
+    CHIP_ERROR Init(chip::PersistentStorageDelegate * backend);
+
+    /**
+     * Flushes and stops the persistence thread.
+     */
+    void Shutdown();
+
+    CHIP_ERROR Flush();
+
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+
+    /**
+     * Number of queued writes that were superseded by a later write to the same key before
+     * reaching the backend.
+     */
+    size_t GetCoalescedWriteCount() const { return mCoalescedWrites.load(std::memory_order_relaxed); }
+
+private:
+    struct WriteOp
+    {
+        std::string key;
+        std::vector<uint8_t> value;
+        bool remove  = false;
+        uint64_t seq = 0;
+    };
+
+    struct PendingValue
+    {
+        std::vector<uint8_t> value;
+        bool removed = false;
+        uint64_t seq = 0;
+    };
+
+    void Enqueue(WriteOp && op);
+    void WakeWriter();
+    void WriterLoop();
+    void PrunePending();
+
+    chip::PersistentStorageDelegate * mBackend = nullptr;
+
+    SpscRing<WriteOp, kQueueDepth> mQueue;
+
+    // Latest queued value per key, for reads. Only touched by the CHIP stack thread.
+    std::unordered_map<std::string, PendingValue> mPending;
+    uint64_t mNextSeq = 1;
+
+    // Highest sequence number the persistence thread has applied.
+    std::atomic<uint64_t> mAppliedSeq{ 0 };
+    std::atomic<bool> mWriterIdle{ false };
+    std::atomic<size_t> mCoalescedWrites{ 0 };
+
+    // Only used to sleep and wake; the queue itself is lock-free.
+    std::mutex mMutex;
+    std::condition_variable mWriterWake;
+    std::condition_variable mWriterProgress;
+    bool mStopping            = false;
+    CHIP_ERROR mDeferredError = CHIP_NO_ERROR;
+
+    std::thread mWriter;
+};
@@ -0,0 +1,150 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "WriteSkippingStorageDelegate.h"
+
+#include <string.h>
+
+#include <lib/support/CodeUtils.h>
+
+using namespace chip;
+
+CHIP_ERROR WriteSkippingStorageDelegate::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mCache.find(key);
+    if (it == mCache.end())
+    {
+        CHIP_ERROR err = mBackend->SyncGetKeyValue(key, buffer, size);
+        if (err == CHIP_NO_ERROR)
+        {
+            UpdateCache(key, buffer, size);
+        }
+        else if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            mCache[key] = CacheEntry();
+        }
+        return err;
+    }
+
+    const CacheEntry & entry = it->second;
+    VerifyOrReturnError(entry.present, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    // Same contract as KvsPersistentStorageDelegate: copy what fits and report the copied size.
+    const uint16_t valueSize = static_cast<uint16_t>(entry.value.size());
+    const uint16_t copySize  = (size < valueSize) ? size : valueSize;
+    if (copySize > 0)
+    {
+        VerifyOrReturnError(buffer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        memcpy(buffer, entry.value.data(), copySize);
+    }
+    size = copySize;
+    return (copySize < valueSize) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteSkippingStorageDelegate::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    if (MatchesStoredValue(key, value, size))
+    {
+        mAvoidedWrites++;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR err = mBackend->SyncSetKeyValue(key, value, size);
+    if (err != CHIP_NO_ERROR)
+    {
+        // The backend state is unknown now; fall back to reading it next time.
+        mCache.erase(key);
+        return err;
+    }
+
+    mForwardedWrites++;
+    UpdateCache(key, value, size);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteSkippingStorageDelegate::SyncDeleteKeyValue(const char * key)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mCache.find(key);
+    if (it != mCache.end() && !it->second.present)
+    {
+        // Keep the error the backend would have returned for a missing key.
+        mAvoidedWrites++;
+        return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    }
+
+    CHIP_ERROR err = mBackend->SyncDeleteKeyValue(key);
+    if (err == CHIP_NO_ERROR || err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        mCache[key] = CacheEntry();
+    }
+    else
+    {
+        mCache.erase(key);
+    }
+    if (err == CHIP_NO_ERROR)
+    {
+        mForwardedWrites++;
+    }
+    return err;
+}
+
+bool WriteSkippingStorageDelegate::MatchesStoredValue(const char * key, const void * value, uint16_t size)
+{
+    auto it = mCache.find(key);
+    if (it != mCache.end())
+    {
+        const CacheEntry & entry = it->second;
+        return entry.present && entry.value.size() == size && (size == 0 || memcmp(entry.value.data(), value, size) == 0);
+    }
+
+    // Not cached (never read, or too large to cache): compare against the backing store. A read
+    // is far cheaper than a write on the flash-backed stores this is meant for.
+    std::vector<uint8_t> current(static_cast<size_t>(size) + 1);
+    uint16_t currentSize = static_cast<uint16_t>((size < UINT16_MAX) ? size + 1 : size);
+    CHIP_ERROR err       = mBackend->SyncGetKeyValue(key, current.data(), currentSize);
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        mCache[key] = CacheEntry();
+        return false;
+    }
+    if (err != CHIP_NO_ERROR || currentSize != size)
+    {
+        return false;
+    }
+    return size == 0 || memcmp(current.data(), value, size) == 0;
+}
+
+void WriteSkippingStorageDelegate::UpdateCache(const char * key, const void * value, uint16_t size)
+{
+    if (size > kMaxCachedValueSize)
+    {
+        mCache.erase(key);
+        return;
+    }
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(value);
+    CacheEntry & entry    = mCache[key];
+    entry.present         = true;
+    entry.value.assign(bytes, bytes + size);
+}
@@ -0,0 +1,80 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/support/CodeUtils.h>
+
+/**
+ * PersistentStorageDelegate layer that drops writes which would not change the stored value.
+ *
+ * Values read or written through the layer are cached (including the absence of a key), so
+ * rewriting an unchanged value costs a memcmp instead of a flash write and fsync. Values larger
+ * than kMaxCachedValueSize are not cached; writing one of those compares against the backing
+ * store instead.
+ *
+ * Like the delegates it wraps, this is only meant to be used from the CHIP stack thread.
+ */
+class WriteSkippingStorageDelegate : public chip::PersistentStorageDelegate
+{
+public:
+    static constexpr size_t kMaxCachedValueSize = 1024;
+
+    WriteSkippingStorageDelegate() = default;
+
+    CHIP_ERROR Init(chip::PersistentStorageDelegate * backend)
+    {
+        VerifyOrReturnError(backend != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        mBackend = backend;
+        mCache.clear();
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+
+    /**
+     * Number of set/delete calls that were dropped because they would not change anything.
+     */
+    size_t GetAvoidedWriteCount() const { return mAvoidedWrites; }
+    size_t GetForwardedWriteCount() const { return mForwardedWrites; }
+
+private:
+    struct CacheEntry
+    {
+        bool present = false;
+        std::vector<uint8_t> value;
+    };
+
+    bool MatchesStoredValue(const char * key, const void * value, uint16_t size);
+    void UpdateCache(const char * key, const void * value, uint16_t size);
+
+    chip::PersistentStorageDelegate * mBackend = nullptr;
+    std::map<std::string, CacheEntry> mCache;
+    size_t mAvoidedWrites   = 0;
+    size_t mForwardedWrites = 0;
+};
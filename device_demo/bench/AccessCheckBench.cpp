@@ -0,0 +1,122 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Required-privilege lookups for a wildcard read of every attribute on both fixed endpoints:
+ * the SDK's scan of the parallel arrays in zap-generated/access.h against AccessPrivilegeIndex.
+ * One operation is the whole wildcard read, i.e. one lookup per expanded attribute path.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include <app/util/privilege-storage.h>
+#include <lib/support/CodeUtils.h>
+
+#include <zap-generated/attribute_index.h>
+#include <zap-generated/endpoint_config.h>
+
+#include "AccessPrivilegeIndex.h"
+#include "BenchUtil.h"
+
+using namespace chip;
+
+namespace {
+
+constexpr size_t kWildcardReads = 20000;
+
+struct IndexedCluster
+{
+    ClusterId clusterId;
+    uint8_t indexInEndpointType;
+    uint16_t firstAttribute;
+    uint16_t attributeCount;
+};
+
+struct IndexedEndpointType
+{
+    uint16_t firstCluster;
+    uint16_t clusterCount;
+    uint16_t storageSize;
+};
+
+struct IndexedAttribute
+{
+    AttributeId attributeId;
+    uint16_t storageOffset;
+};
+
+struct AttributePath
+{
+    ClusterId cluster;
+    AttributeId attribute;
+};
+
+constexpr uint8_t kFixedEndpointTypes[]        = FIXED_ENDPOINT_TYPES;
+constexpr IndexedCluster kClusters[]           = GENERATED_ATTRIBUTE_INDEX_CLUSTERS;
+constexpr IndexedEndpointType kEndpointTypes[] = GENERATED_ATTRIBUTE_INDEX_ENDPOINT_TYPES;
+constexpr IndexedAttribute kAttributes[]       = GENERATED_ATTRIBUTE_INDEX_ATTRIBUTES;
+
+// What a read of */*/* expands to on this device.
+std::vector<AttributePath> ExpandWildcardRead()
+{
+    std::vector<AttributePath> paths;
+    for (uint8_t typeIndex : kFixedEndpointTypes)
+    {
+        const IndexedEndpointType & type = kEndpointTypes[typeIndex];
+        for (uint16_t i = 0; i < type.clusterCount; i++)
+        {
+            const IndexedCluster & cluster = kClusters[type.firstCluster + i];
+            for (uint16_t j = 0; j < cluster.attributeCount; j++)
+            {
+                paths.push_back(AttributePath{ cluster.clusterId, kAttributes[cluster.firstAttribute + j].attributeId });
+            }
+        }
+    }
+    return paths;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<AttributePath> paths = ExpandWildcardRead();
+    printf("Wildcard read over %u endpoints: %u attribute paths\n", static_cast<unsigned>(ArraySize(kFixedEndpointTypes)),
+           static_cast<unsigned>(paths.size()));
+
+    bench::PrintResult("read privilege, wildcard read", "generated scan", bench::MeasureNanoseconds(kWildcardReads, [&](size_t) {
+                           size_t sum = 0;
+                           for (const AttributePath & path : paths)
+                           {
+                               sum += static_cast<size_t>(MatterGetAccessPrivilegeForReadAttribute(path.cluster, path.attribute));
+                           }
+                           return sum;
+                       }));
+    bench::PrintResult("read privilege, wildcard read", "AccessPrivilegeIndex",
+                       bench::MeasureNanoseconds(kWildcardReads, [&](size_t) {
+                           size_t sum = 0;
+                           for (const AttributePath & path : paths)
+                           {
+                               sum += static_cast<size_t>(AccessPrivilegeIndex::ForReadAttribute(path.cluster, path.attribute));
+                           }
+                           return sum;
+                       }));
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <chrono>
+
+/**
+ * Timing helpers shared by the microbenchmarks in this directory.
+ *
+ * Each benchmark is a standalone executable that sets up the state it measures in process and
+ * prints one line per case; nothing here needs the CHIP stack to be running.
+ */
+namespace bench {
+
+// Written by every measured loop so the compiler cannot drop the work.
+extern volatile size_t gSink;
+
+/**
+ * Runs `function` `iterations` times and returns the mean wall time of one call in nanoseconds.
+ * `function` returns a value that is folded into gSink.
+ */
+template <typename Function>
+double MeasureNanoseconds(size_t iterations, Function && function)
+{
+    size_t sink      = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sink += function(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    gSink              = sink;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        static_cast<double>(iterations);
+}
+
+inline void PrintResult(const char * name, const char * variant, double nanoseconds)
+{
+    printf("%-40s %-24s %12.1f ns/op\n", name, variant, nanoseconds);
+}
+
+} // namespace bench
@@ -0,0 +1,384 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Per-invoke command resolution: the binary search over kServerCommands that
+ * DispatchSingleClusterCommand does now, against the two-level switch on cluster and command
+ * id that it replaced (reproduced below for the same set of commands). Decoding and the
+ * command callbacks are the same either way and are left out.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app-common/zap-generated/ids/Commands.h>
+#include <app/ConcreteCommandPath.h>
+#include <lib/support/CodeUtils.h>
+
+#include "BenchUtil.h"
+
+namespace chip {
+namespace app {
+
+// Defined in zap-generated/IMClusterCommandHandler.cpp.
+int FindServerCommandIndex(const ConcreteCommandPath & aCommandPath);
+
+} // namespace app
+} // namespace chip
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr size_t kInvokes = 1000000;
+
+// Every server command the application accepts, in kServerCommands order.
+const ConcreteCommandPath kAcceptedCommands[] = {
+    ConcreteCommandPath(1, Clusters::Identify::Id, Clusters::Identify::Commands::Identify::Id),
+    ConcreteCommandPath(1, Clusters::Identify::Id, Clusters::Identify::Commands::TriggerEffect::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::AddGroup::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::ViewGroup::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::GetGroupMembership::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::RemoveGroup::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::RemoveAllGroups::Id),
+    ConcreteCommandPath(1, Clusters::Groups::Id, Clusters::Groups::Commands::AddGroupIfIdentifying::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::AddScene::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::ViewScene::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::RemoveScene::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::RemoveAllScenes::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::StoreScene::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::RecallScene::Id),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, Clusters::Scenes::Commands::GetSceneMembership::Id),
+    ConcreteCommandPath(1, Clusters::OnOff::Id, Clusters::OnOff::Commands::Off::Id),
+    ConcreteCommandPath(1, Clusters::OnOff::Id, Clusters::OnOff::Commands::On::Id),
+    ConcreteCommandPath(1, Clusters::OnOff::Id, Clusters::OnOff::Commands::Toggle::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveToLevel::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Move::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Step::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Stop::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveToLevelWithOnOff::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveWithOnOff::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::StepWithOnOff::Id),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, Clusters::LevelControl::Commands::StopWithOnOff::Id),
+    ConcreteCommandPath(1, Clusters::OtaSoftwareUpdateRequestor::Id,
+                        Clusters::OtaSoftwareUpdateRequestor::Commands::AnnounceOtaProvider::Id),
+    ConcreteCommandPath(1, Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::ArmFailSafe::Id),
+    ConcreteCommandPath(1, Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::SetRegulatoryConfig::Id),
+    ConcreteCommandPath(1, Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::CommissioningComplete::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ScanNetworks::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id,
+                        Clusters::NetworkCommissioning::Commands::AddOrUpdateWiFiNetwork::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id,
+                        Clusters::NetworkCommissioning::Commands::AddOrUpdateThreadNetwork::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::RemoveNetwork::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ConnectNetwork::Id),
+    ConcreteCommandPath(1, Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ReorderNetwork::Id),
+    ConcreteCommandPath(1, Clusters::DiagnosticLogs::Id, Clusters::DiagnosticLogs::Commands::RetrieveLogsRequest::Id),
+    ConcreteCommandPath(1, Clusters::GeneralDiagnostics::Id, Clusters::GeneralDiagnostics::Commands::TestEventTrigger::Id),
+    ConcreteCommandPath(1, Clusters::SoftwareDiagnostics::Id, Clusters::SoftwareDiagnostics::Commands::ResetWatermarks::Id),
+    ConcreteCommandPath(1, Clusters::ThreadNetworkDiagnostics::Id, Clusters::ThreadNetworkDiagnostics::Commands::ResetCounts::Id),
+    ConcreteCommandPath(1, Clusters::WiFiNetworkDiagnostics::Id, Clusters::WiFiNetworkDiagnostics::Commands::ResetCounts::Id),
+    ConcreteCommandPath(1, Clusters::EthernetNetworkDiagnostics::Id,
+                        Clusters::EthernetNetworkDiagnostics::Commands::ResetCounts::Id),
+    ConcreteCommandPath(1, Clusters::AdministratorCommissioning::Id,
+                        Clusters::AdministratorCommissioning::Commands::OpenCommissioningWindow::Id),
+    ConcreteCommandPath(1, Clusters::AdministratorCommissioning::Id,
+                        Clusters::AdministratorCommissioning::Commands::OpenBasicCommissioningWindow::Id),
+    ConcreteCommandPath(1, Clusters::AdministratorCommissioning::Id,
+                        Clusters::AdministratorCommissioning::Commands::RevokeCommissioning::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id,
+                        Clusters::OperationalCredentials::Commands::AttestationRequest::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id,
+                        Clusters::OperationalCredentials::Commands::CertificateChainRequest::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::CSRRequest::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::AddNOC::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::UpdateNOC::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::UpdateFabricLabel::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::RemoveFabric::Id),
+    ConcreteCommandPath(1, Clusters::OperationalCredentials::Id,
+                        Clusters::OperationalCredentials::Commands::AddTrustedRootCertificate::Id),
+    ConcreteCommandPath(1, Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetWrite::Id),
+    ConcreteCommandPath(1, Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetRead::Id),
+    ConcreteCommandPath(1, Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetRemove::Id),
+    ConcreteCommandPath(1, Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetReadAllIndices::Id),
+};
+
+// Unknown commands of known clusters, and commands of a cluster the application does not have.
+const ConcreteCommandPath kRejectedCommands[] = {
+    ConcreteCommandPath(1, Clusters::OnOff::Id, 0xFF),
+    ConcreteCommandPath(1, Clusters::LevelControl::Id, 0xFF),
+    ConcreteCommandPath(1, Clusters::Scenes::Id, 0xFF),
+    ConcreteCommandPath(1, 0xFFF1FC00, 0x00),
+};
+
+// The shape of the dispatch before the table: a switch on the cluster, then one per cluster on
+// the command. Returns the same index as FindServerCommandIndex.
+int SwitchLookup(const ConcreteCommandPath & path)
+{
+    switch (path.mClusterId)
+    {
+    case Clusters::Identify::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::Identify::Commands::Identify::Id:
+            return 0;
+        case Clusters::Identify::Commands::TriggerEffect::Id:
+            return 1;
+        default:
+            return -1;
+        }
+    case Clusters::Groups::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::Groups::Commands::AddGroup::Id:
+            return 2;
+        case Clusters::Groups::Commands::ViewGroup::Id:
+            return 3;
+        case Clusters::Groups::Commands::GetGroupMembership::Id:
+            return 4;
+        case Clusters::Groups::Commands::RemoveGroup::Id:
+            return 5;
+        case Clusters::Groups::Commands::RemoveAllGroups::Id:
+            return 6;
+        case Clusters::Groups::Commands::AddGroupIfIdentifying::Id:
+            return 7;
+        default:
+            return -1;
+        }
+    case Clusters::Scenes::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::Scenes::Commands::AddScene::Id:
+            return 8;
+        case Clusters::Scenes::Commands::ViewScene::Id:
+            return 9;
+        case Clusters::Scenes::Commands::RemoveScene::Id:
+            return 10;
+        case Clusters::Scenes::Commands::RemoveAllScenes::Id:
+            return 11;
+        case Clusters::Scenes::Commands::StoreScene::Id:
+            return 12;
+        case Clusters::Scenes::Commands::RecallScene::Id:
+            return 13;
+        case Clusters::Scenes::Commands::GetSceneMembership::Id:
+            return 14;
+        default:
+            return -1;
+        }
+    case Clusters::OnOff::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::OnOff::Commands::Off::Id:
+            return 15;
+        case Clusters::OnOff::Commands::On::Id:
+            return 16;
+        case Clusters::OnOff::Commands::Toggle::Id:
+            return 17;
+        default:
+            return -1;
+        }
+    case Clusters::LevelControl::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::LevelControl::Commands::MoveToLevel::Id:
+            return 18;
+        case Clusters::LevelControl::Commands::Move::Id:
+            return 19;
+        case Clusters::LevelControl::Commands::Step::Id:
+            return 20;
+        case Clusters::LevelControl::Commands::Stop::Id:
+            return 21;
+        case Clusters::LevelControl::Commands::MoveToLevelWithOnOff::Id:
+            return 22;
+        case Clusters::LevelControl::Commands::MoveWithOnOff::Id:
+            return 23;
+        case Clusters::LevelControl::Commands::StepWithOnOff::Id:
+            return 24;
+        case Clusters::LevelControl::Commands::StopWithOnOff::Id:
+            return 25;
+        default:
+            return -1;
+        }
+    case Clusters::OtaSoftwareUpdateRequestor::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::OtaSoftwareUpdateRequestor::Commands::AnnounceOtaProvider::Id:
+            return 26;
+        default:
+            return -1;
+        }
+    case Clusters::GeneralCommissioning::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::GeneralCommissioning::Commands::ArmFailSafe::Id:
+            return 27;
+        case Clusters::GeneralCommissioning::Commands::SetRegulatoryConfig::Id:
+            return 28;
+        case Clusters::GeneralCommissioning::Commands::CommissioningComplete::Id:
+            return 29;
+        default:
+            return -1;
+        }
+    case Clusters::NetworkCommissioning::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::NetworkCommissioning::Commands::ScanNetworks::Id:
+            return 30;
+        case Clusters::NetworkCommissioning::Commands::AddOrUpdateWiFiNetwork::Id:
+            return 31;
+        case Clusters::NetworkCommissioning::Commands::AddOrUpdateThreadNetwork::Id:
+            return 32;
+        case Clusters::NetworkCommissioning::Commands::RemoveNetwork::Id:
+            return 33;
+        case Clusters::NetworkCommissioning::Commands::ConnectNetwork::Id:
+            return 34;
+        case Clusters::NetworkCommissioning::Commands::ReorderNetwork::Id:
+            return 35;
+        default:
+            return -1;
+        }
+    case Clusters::DiagnosticLogs::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::DiagnosticLogs::Commands::RetrieveLogsRequest::Id:
+            return 36;
+        default:
+            return -1;
+        }
+    case Clusters::GeneralDiagnostics::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::GeneralDiagnostics::Commands::TestEventTrigger::Id:
+            return 37;
+        default:
+            return -1;
+        }
+    case Clusters::SoftwareDiagnostics::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::SoftwareDiagnostics::Commands::ResetWatermarks::Id:
+            return 38;
+        default:
+            return -1;
+        }
+    case Clusters::ThreadNetworkDiagnostics::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::ThreadNetworkDiagnostics::Commands::ResetCounts::Id:
+            return 39;
+        default:
+            return -1;
+        }
+    case Clusters::WiFiNetworkDiagnostics::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::WiFiNetworkDiagnostics::Commands::ResetCounts::Id:
+            return 40;
+        default:
+            return -1;
+        }
+    case Clusters::EthernetNetworkDiagnostics::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::EthernetNetworkDiagnostics::Commands::ResetCounts::Id:
+            return 41;
+        default:
+            return -1;
+        }
+    case Clusters::AdministratorCommissioning::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::AdministratorCommissioning::Commands::OpenCommissioningWindow::Id:
+            return 42;
+        case Clusters::AdministratorCommissioning::Commands::OpenBasicCommissioningWindow::Id:
+            return 43;
+        case Clusters::AdministratorCommissioning::Commands::RevokeCommissioning::Id:
+            return 44;
+        default:
+            return -1;
+        }
+    case Clusters::OperationalCredentials::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::OperationalCredentials::Commands::AttestationRequest::Id:
+            return 45;
+        case Clusters::OperationalCredentials::Commands::CertificateChainRequest::Id:
+            return 46;
+        case Clusters::OperationalCredentials::Commands::CSRRequest::Id:
+            return 47;
+        case Clusters::OperationalCredentials::Commands::AddNOC::Id:
+            return 48;
+        case Clusters::OperationalCredentials::Commands::UpdateNOC::Id:
+            return 49;
+        case Clusters::OperationalCredentials::Commands::UpdateFabricLabel::Id:
+            return 50;
+        case Clusters::OperationalCredentials::Commands::RemoveFabric::Id:
+            return 51;
+        case Clusters::OperationalCredentials::Commands::AddTrustedRootCertificate::Id:
+            return 52;
+        default:
+            return -1;
+        }
+    case Clusters::GroupKeyManagement::Id:
+        switch (path.mCommandId)
+        {
+        case Clusters::GroupKeyManagement::Commands::KeySetWrite::Id:
+            return 53;
+        case Clusters::GroupKeyManagement::Commands::KeySetRead::Id:
+            return 54;
+        case Clusters::GroupKeyManagement::Commands::KeySetRemove::Id:
+            return 55;
+        case Clusters::GroupKeyManagement::Commands::KeySetReadAllIndices::Id:
+            return 56;
+        default:
+            return -1;
+        }
+    default:
+        return -1;
+    }
+}
+
+template <size_t N, typename Lookup>
+double Measure(const ConcreteCommandPath (&paths)[N], Lookup lookup)
+{
+    return bench::MeasureNanoseconds(kInvokes, [&](size_t i) { return static_cast<size_t>(lookup(paths[i % N]) + 1); });
+}
+
+} // namespace
+
+int main()
+{
+    // Both must agree before their timings mean anything.
+    for (size_t i = 0; i < ArraySize(kAcceptedCommands); i++)
+    {
+        if (FindServerCommandIndex(kAcceptedCommands[i]) != static_cast<int>(i) ||
+            SwitchLookup(kAcceptedCommands[i]) != static_cast<int>(i))
+        {
+            fprintf(stderr, "Command %u is not where kServerCommands has it\n", static_cast<unsigned>(i));
+            return 1;
+        }
+    }
+
+    bench::PrintResult("resolve accepted command", "nested switch", Measure(kAcceptedCommands, SwitchLookup));
+    bench::PrintResult("resolve accepted command", "kServerCommands", Measure(kAcceptedCommands, FindServerCommandIndex));
+    bench::PrintResult("resolve rejected command", "nested switch", Measure(kRejectedCommands, SwitchLookup));
+    bench::PrintResult("resolve rejected command", "kServerCommands", Measure(kRejectedCommands, FindServerCommandIndex));
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Encode cost of one report as the number of subscribers to it grows. Every subscriber to the
+ * OnOff and LevelControl clusters of the light endpoint gets their attributes encoded through
+ * ReadSingleClusterData, the interaction model's per-attribute read, once with the ember read
+ * path only and once with EncodedAttributeCache registered for both clusters, as AppMain does.
+ * Each report follows a change to both clusters, so the cache misses once per attribute per
+ * report and serves every other subscriber from the encoded element.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <access/SubjectDescriptor.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/InteractionModelEngine.h>
+#include <app/MessageDef/AttributeReportIBs.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+
+#include "BenchUtil.h"
+#include "EncodedAttributeCache.h"
+#include "LightDriver.h"
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr size_t kReports              = 2000;
+constexpr unsigned kSubscriberCounts[] = { 1, 2, 4, 8, 16 };
+
+// The clusters AppMain caches, with the attributes a subscription to each of them reports.
+constexpr ClusterId kClusters[] = { Clusters::OnOff::Id, Clusters::LevelControl::Id };
+
+// Large enough for one subscriber's share of the report.
+constexpr size_t kReportBufferSize = 1024;
+
+std::vector<ConcreteReadAttributePath> ReportedPaths()
+{
+    std::vector<ConcreteReadAttributePath> paths;
+    const EmberAfEndpointType * endpointType = emberAfFindEndpointType(LightDriver::kEndpoint);
+    for (uint8_t i = 0; endpointType != nullptr && i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        if ((cluster.mask & CLUSTER_MASK_SERVER) == 0 ||
+            std::find(std::begin(kClusters), std::end(kClusters), cluster.clusterId) == std::end(kClusters))
+        {
+            continue;
+        }
+        for (uint16_t j = 0; j < cluster.attributeCount; j++)
+        {
+            paths.emplace_back(LightDriver::kEndpoint, cluster.clusterId, cluster.attributes[j].attributeId);
+        }
+    }
+    return paths;
+}
+
+// What a cluster change does to the cache: the next read of each attribute misses.
+void BumpDataVersions()
+{
+    for (ClusterId cluster : kClusters)
+    {
+        DataVersion * version = emberAfDataVersionStorage(ConcreteClusterPath(LightDriver::kEndpoint, cluster));
+        if (version != nullptr)
+        {
+            (*version)++;
+        }
+    }
+}
+
+// Encodes every path into one subscriber's AttributeReportIBs and returns the bytes written.
+size_t EncodeForSubscriber(const std::vector<ConcreteReadAttributePath> & paths, uint8_t * buffer)
+{
+    TLV::TLVWriter writer;
+    TLV::TLVType outer;
+    AttributeReportIBs::Builder reports;
+    Access::SubjectDescriptor subject;
+
+    writer.Init(buffer, kReportBufferSize);
+    VerifyOrReturnValue(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer) == CHIP_NO_ERROR, 0);
+    VerifyOrReturnValue(reports.Init(&writer, 1) == CHIP_NO_ERROR, 0);
+    for (const ConcreteReadAttributePath & path : paths)
+    {
+        VerifyOrReturnValue(ReadSingleClusterData(subject, false, path, reports, nullptr) == CHIP_NO_ERROR, 0);
+    }
+    reports.EndOfAttributeReportIBs();
+    VerifyOrReturnValue(reports.GetError() == CHIP_NO_ERROR, 0);
+    VerifyOrReturnValue(writer.EndContainer(outer) == CHIP_NO_ERROR, 0);
+    return writer.GetLengthWritten();
+}
+
+double MeasureReports(const std::vector<ConcreteReadAttributePath> & paths, unsigned subscribers)
+{
+    uint8_t buffer[kReportBufferSize];
+    return bench::MeasureNanoseconds(kReports, [&](size_t) {
+        size_t written = 0;
+        BumpDataVersions();
+        for (unsigned i = 0; i < subscribers; i++)
+        {
+            written += EncodeForSubscriber(paths, buffer);
+        }
+        return written;
+    });
+}
+
+template <size_t N>
+CHIP_ERROR RegisterCaches(EncodedAttributeCache (&caches)[N])
+{
+    for (EncodedAttributeCache & cache : caches)
+    {
+        ReturnErrorOnFailure(cache.Init());
+    }
+    return CHIP_NO_ERROR;
+}
+
+template <size_t N>
+void UnregisterCaches(EncodedAttributeCache (&caches)[N])
+{
+    for (EncodedAttributeCache & cache : caches)
+    {
+        cache.Shutdown();
+    }
+}
+
+} // namespace
+
+int main()
+{
+    if (Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Platform::MemoryInit failed\n");
+        return 1;
+    }
+    emberAfEndpointConfigure();
+
+    const std::vector<ConcreteReadAttributePath> paths = ReportedPaths();
+
+    EncodedAttributeCache caches[] = { { LightDriver::kEndpoint, Clusters::OnOff::Id },
+                                       { LightDriver::kEndpoint, Clusters::LevelControl::Id } };
+
+    // Both paths must produce the same report before their timings mean anything.
+    uint8_t emberReport[kReportBufferSize];
+    uint8_t cachedReport[kReportBufferSize];
+    const size_t emberLength = EncodeForSubscriber(paths, emberReport);
+    CHIP_ERROR err           = RegisterCaches(caches);
+    if (emberLength == 0 || err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Setting up %u attribute paths on endpoint %u failed: %" CHIP_ERROR_FORMAT "\n",
+                static_cast<unsigned>(paths.size()), static_cast<unsigned>(LightDriver::kEndpoint), err.Format());
+        return 1;
+    }
+    const size_t cachedLength = EncodeForSubscriber(paths, cachedReport);
+    UnregisterCaches(caches);
+    if (cachedLength != emberLength || memcmp(cachedReport, emberReport, emberLength) != 0)
+    {
+        fprintf(stderr, "The cached report differs from the ember one\n");
+        return 1;
+    }
+
+    for (unsigned subscribers : kSubscriberCounts)
+    {
+        char name[48];
+        snprintf(name, sizeof(name), "report to %u subscribers", subscribers);
+
+        bench::PrintResult(name, "ember read path", MeasureReports(paths, subscribers));
+        if (RegisterCaches(caches) == CHIP_NO_ERROR)
+        {
+            bench::PrintResult(name, "EncodedAttributeCache", MeasureReports(paths, subscribers));
+        }
+        UnregisterCaches(caches);
+    }
+
+    Platform::MemoryShutdown();
+    return 0;
+}
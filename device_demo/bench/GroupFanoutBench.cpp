@@ -0,0 +1,132 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Fan-out cost of a group-addressed invoke as groups and member endpoints grow: the stored
+ * provider's membership scan (what the interaction model did before the index), the indexed
+ * membership list it iterates now, and GroupEndpointIndex::ForEachEndpoint, which the scene
+ * recall handler uses.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+
+#include "BenchUtil.h"
+#include "GroupEndpointIndex.h"
+
+using namespace chip;
+
+namespace {
+
+constexpr FabricIndex kFabric = 1;
+constexpr size_t kLookups     = 20000;
+
+struct Shape
+{
+    uint16_t groups;
+    uint16_t endpointsPerGroup;
+};
+
+// Every group spans endpoints 1..endpointsPerGroup, like overlapping room and whole-house groups.
+constexpr Shape kShapes[] = { { 4, 4 }, { 8, 32 }, { 32, 8 }, { 32, 32 } };
+
+size_t CountMatches(GroupEndpointIndex::EndpointIterator * iterator, GroupId group)
+{
+    size_t count = 0;
+    GroupEndpointIndex::GroupEndpoint mapping;
+    while (iterator->Next(mapping))
+    {
+        count += (mapping.group_id == group) ? 1 : 0;
+    }
+    iterator->Release();
+    return count;
+}
+
+CHIP_ERROR Populate(GroupEndpointIndex & index, const Shape & shape)
+{
+    for (uint16_t group = 1; group <= shape.groups; group++)
+    {
+        ReturnErrorOnFailure(index.SetGroupInfo(kFabric, Credentials::GroupDataProvider::GroupInfo(group, "bench")));
+        for (uint16_t endpoint = 1; endpoint <= shape.endpointsPerGroup; endpoint++)
+        {
+            ReturnErrorOnFailure(index.AddEndpoint(kFabric, group, endpoint));
+        }
+    }
+    return CHIP_NO_ERROR;
+}
+
+void RunShape(const Shape & shape)
+{
+    TestPersistentStorageDelegate storage;
+    GroupEndpointIndex index(shape.groups, 1);
+    index.SetStorageDelegate(&storage);
+
+    CHIP_ERROR err = index.Init();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = Populate(index, shape);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Setting up %u groups x %u endpoints failed: %" CHIP_ERROR_FORMAT "\n", shape.groups,
+                shape.endpointsPerGroup, err.Format());
+        index.Finish();
+        return;
+    }
+
+    auto target = [&shape](size_t i) { return static_cast<GroupId>(i % shape.groups + 1); };
+
+    char name[48];
+    snprintf(name, sizeof(name), "group fan-out %ux%u", shape.groups, shape.endpointsPerGroup);
+
+    bench::PrintResult(name, "stored scan", bench::MeasureNanoseconds(kLookups, [&](size_t i) {
+                           return CountMatches(index.Credentials::GroupDataProviderImpl::IterateEndpoints(kFabric), target(i));
+                       }));
+    bench::PrintResult(name, "indexed memberships", bench::MeasureNanoseconds(kLookups, [&](size_t i) {
+                           return CountMatches(index.IterateEndpoints(kFabric), target(i));
+                       }));
+    bench::PrintResult(name, "ForEachEndpoint", bench::MeasureNanoseconds(kLookups, [&](size_t i) {
+                           size_t sum = 0;
+                           index.ForEachEndpoint(kFabric, target(i), [&sum](EndpointId endpoint) { sum += endpoint; });
+                           return sum;
+                       }));
+
+    index.Finish();
+}
+
+} // namespace
+
+int main()
+{
+    if (Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Platform::MemoryInit failed\n");
+        return 1;
+    }
+
+    for (const Shape & shape : kShapes)
+    {
+        RunShape(shape);
+    }
+
+    Platform::MemoryShutdown();
+    return 0;
+}
@@ -1,4 +1,7 @@
 #include <AppMain.h>
+#include <LevelControlCommandHandler.h>
+#include <LightDriver.h>
+#include <LightStatePersistence.h>
 
 #include <app-common/zap-generated/ids/Attributes.h>
 #include <app/ConcreteAttributePath.h>
@@ -9,6 +12,14 @@ using namespace chip;
 
 void ApplicationInit() {}
 
+void MatterPostAttributeChangeCallback(const chip::app::ConcreteAttributePath & attributePath, uint8_t type, uint16_t size,
+                                       uint8_t * value)
+{
+    LevelControlCommandHandler::GetInstance().OnAttributeChanged(attributePath);
+    LightStatePersistence::GetInstance().OnAttributeChanged(attributePath, type, size, value);
+    LightDriver::GetInstance().OnAttributeChanged(attributePath, type, size, value);
+}
+
 int main(int argc, char * argv[])
 {
     if (ChipLinuxAppInit(argc, argv) != 0)
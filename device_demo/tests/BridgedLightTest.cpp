@@ -0,0 +1,117 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Adds a bridged light the way --bridged-lights does and checks that it got the defaults of the
+ * template endpoint. The global FeatureMap and ClusterRevision attributes of every light cluster
+ * are compared with what emAfLoadAttributeDefaults loads for endpoint 1; no init callback writes
+ * them, so any difference comes from DynamicEndpointManager. FeatureMap is a 4-byte default
+ * stored inline in the metadata, ClusterRevision a 2-byte one.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app/util/af.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CHIPMem.h>
+
+#include "DynamicEndpointManager.h"
+
+using namespace chip;
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr AttributeId kCheckedAttributes[] = { Globals::Attributes::FeatureMap::Id, Globals::Attributes::ClusterRevision::Id };
+
+// Compares `attribute` of every light cluster on `light` with the template endpoint.
+size_t CountMismatches(EndpointId light, AttributeId attribute)
+{
+    const EndpointId templateEndpoint        = DynamicEndpointManager::kTemplateEndpoint;
+    const EmberAfEndpointType * endpointType = emberAfFindEndpointType(templateEndpoint);
+    size_t mismatches                        = 0;
+    for (uint8_t i = 0; endpointType != nullptr && i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        uint16_t stride;
+        if ((cluster.mask & CLUSTER_MASK_SERVER) == 0 ||
+            DynamicEndpointManager::GetInstance().GetColumn(cluster.clusterId, attribute, stride) == nullptr)
+        {
+            continue;
+        }
+
+        uint8_t expected[sizeof(uint32_t)] = {};
+        uint8_t actual[sizeof(uint32_t)]   = {};
+        const ClusterId id           = cluster.clusterId;
+        EmberAfStatus expectedStatus = emberAfReadAttribute(templateEndpoint, id, attribute, expected, sizeof(expected));
+        EmberAfStatus actualStatus   = emberAfReadAttribute(light, id, attribute, actual, sizeof(actual));
+        if (expectedStatus != EMBER_ZCL_STATUS_SUCCESS || actualStatus != EMBER_ZCL_STATUS_SUCCESS ||
+            memcmp(expected, actual, stride) != 0)
+        {
+            fprintf(stderr, "Endpoint %u cluster 0x%08x attribute 0x%08x does not match the template\n",
+                    static_cast<unsigned>(light), static_cast<unsigned>(id), static_cast<unsigned>(attribute));
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main()
+{
+    if (Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Platform::MemoryInit failed\n");
+        return 1;
+    }
+    emberAfEndpointConfigure();
+    emAfLoadAttributeDefaults(DynamicEndpointManager::kTemplateEndpoint, true);
+
+    DynamicEndpointManager & endpoints = DynamicEndpointManager::GetInstance();
+    EndpointId light                   = kInvalidEndpointId;
+    CHIP_ERROR err                     = endpoints.Init();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = endpoints.AddLight(light);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Adding a bridged light failed: %" CHIP_ERROR_FORMAT "\n", err.Format());
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    for (AttributeId attribute : kCheckedAttributes)
+    {
+        mismatches += CountMismatches(light, attribute);
+    }
+
+    endpoints.Shutdown();
+    Platform::MemoryShutdown();
+
+    if (mismatches != 0)
+    {
+        return 1;
+    }
+    printf("Bridged light %u has the template defaults\n", static_cast<unsigned>(light));
+    return 0;
+}
@@ -17,6 +17,7 @@
 
 // THIS FILE IS GENERATED BY ZAP
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdint>
 
@@ -29,6 +30,7 @@
 #include <app/InteractionModelEngine.h>
 #include <app/util/util.h>
 #include <lib/core/CHIPSafeCasts.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/TypeTraits.h>
 
 // Currently we need some work to keep compatible with ember lib.
@@ -37,1063 +39,279 @@
 namespace chip {
 namespace app {
 
-// Cluster specific command parsing
-
-namespace Clusters {
-
-namespace AdministratorCommissioning {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::OpenCommissioningWindow::Id: {
-            Commands::OpenCommissioningWindow::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfAdministratorCommissioningClusterOpenCommissioningWindowCallback(apCommandObj, aCommandPath,
-                                                                                                     commandData);
-            }
-            break;
-        }
-        case Commands::OpenBasicCommissioningWindow::Id: {
-            Commands::OpenBasicCommissioningWindow::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfAdministratorCommissioningClusterOpenBasicCommissioningWindowCallback(
-                    apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RevokeCommissioning::Id: {
-            Commands::RevokeCommissioning::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfAdministratorCommissioningClusterRevokeCommissioningCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace AdministratorCommissioning
-
-namespace DiagnosticLogs {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::RetrieveLogsRequest::Id: {
-            Commands::RetrieveLogsRequest::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfDiagnosticLogsClusterRetrieveLogsRequestCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace DiagnosticLogs
-
-namespace EthernetNetworkDiagnostics {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::ResetCounts::Id: {
-            Commands::ResetCounts::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfEthernetNetworkDiagnosticsClusterResetCountsCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace EthernetNetworkDiagnostics
-
-namespace GeneralCommissioning {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::ArmFailSafe::Id: {
-            Commands::ArmFailSafe::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGeneralCommissioningClusterArmFailSafeCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::SetRegulatoryConfig::Id: {
-            Commands::SetRegulatoryConfig::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGeneralCommissioningClusterSetRegulatoryConfigCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::CommissioningComplete::Id: {
-            Commands::CommissioningComplete::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfGeneralCommissioningClusterCommissioningCompleteCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace GeneralCommissioning
-
-namespace GeneralDiagnostics {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::TestEventTrigger::Id: {
-            Commands::TestEventTrigger::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGeneralDiagnosticsClusterTestEventTriggerCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace GeneralDiagnostics
-
-namespace GroupKeyManagement {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::KeySetWrite::Id: {
-            Commands::KeySetWrite::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupKeyManagementClusterKeySetWriteCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::KeySetRead::Id: {
-            Commands::KeySetRead::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupKeyManagementClusterKeySetReadCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::KeySetRemove::Id: {
-            Commands::KeySetRemove::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupKeyManagementClusterKeySetRemoveCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::KeySetReadAllIndices::Id: {
-            Commands::KeySetReadAllIndices::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupKeyManagementClusterKeySetReadAllIndicesCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace GroupKeyManagement
-
-namespace Groups {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::AddGroup::Id: {
-            Commands::AddGroup::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterAddGroupCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::ViewGroup::Id: {
-            Commands::ViewGroup::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterViewGroupCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::GetGroupMembership::Id: {
-            Commands::GetGroupMembership::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterGetGroupMembershipCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveGroup::Id: {
-            Commands::RemoveGroup::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterRemoveGroupCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveAllGroups::Id: {
-            Commands::RemoveAllGroups::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterRemoveAllGroupsCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::AddGroupIfIdentifying::Id: {
-            Commands::AddGroupIfIdentifying::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfGroupsClusterAddGroupIfIdentifyingCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace Groups
-
-namespace Identify {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::Identify::Id: {
-            Commands::Identify::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfIdentifyClusterIdentifyCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
+// Position of aCommandPath in this application's server command table, or -1 if it does not
+// accept that command. Exposed for bench/DispatchBench.cpp.
+int FindServerCommandIndex(const ConcreteCommandPath & aCommandPath);
 
-} // namespace Identify
-
-namespace LevelControl {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::MoveToLevel::Id: {
-            Commands::MoveToLevel::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterMoveToLevelCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::Move::Id: {
-            Commands::Move::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterMoveCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::Step::Id: {
-            Commands::Step::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterStepCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::Stop::Id: {
-            Commands::Stop::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterStopCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::MoveToLevelWithOnOff::Id: {
-            Commands::MoveToLevelWithOnOff::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterMoveToLevelWithOnOffCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::MoveWithOnOff::Id: {
-            Commands::MoveWithOnOff::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterMoveWithOnOffCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::StepWithOnOff::Id: {
-            Commands::StepWithOnOff::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterStepWithOnOffCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::StopWithOnOff::Id: {
-            Commands::StopWithOnOff::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfLevelControlClusterStopWithOnOffCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
+// Cluster specific command parsing
 
-} // namespace LevelControl
+namespace {
 
-namespace NetworkCommissioning {
+using CommandDispatchThunk = bool (*)(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath,
+                                      TLV::TLVReader & aDataTlv, CHIP_ERROR & aTLVError);
 
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+template <typename DecodableType, bool (*Callback)(CommandHandler *, const ConcreteCommandPath &, const DecodableType &)>
+bool DecodeAndHandle(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv,
+                     CHIP_ERROR & aTLVError)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::ScanNetworks::Id: {
-            Commands::ScanNetworks::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfNetworkCommissioningClusterScanNetworksCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::AddOrUpdateWiFiNetwork::Id: {
-            Commands::AddOrUpdateWiFiNetwork::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfNetworkCommissioningClusterAddOrUpdateWiFiNetworkCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::AddOrUpdateThreadNetwork::Id: {
-            Commands::AddOrUpdateThreadNetwork::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfNetworkCommissioningClusterAddOrUpdateThreadNetworkCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveNetwork::Id: {
-            Commands::RemoveNetwork::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfNetworkCommissioningClusterRemoveNetworkCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::ConnectNetwork::Id: {
-            Commands::ConnectNetwork::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfNetworkCommissioningClusterConnectNetworkCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::ReorderNetwork::Id: {
-            Commands::ReorderNetwork::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfNetworkCommissioningClusterReorderNetworkCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
+    DecodableType commandData;
+    aTLVError = DataModel::Decode(aDataTlv, commandData);
+    return aTLVError == CHIP_NO_ERROR && Callback(apCommandObj, aCommandPath, commandData);
 }
 
-} // namespace NetworkCommissioning
-
-namespace OtaSoftwareUpdateRequestor {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+struct ServerCommandEntry
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::AnnounceOtaProvider::Id: {
-            Commands::AnnounceOtaProvider::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfOtaSoftwareUpdateRequestorClusterAnnounceOtaProviderCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace OtaSoftwareUpdateRequestor
+    ClusterId clusterId;
+    CommandId commandId;
+    CommandDispatchThunk dispatch;
+};
 
-namespace OnOff {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+constexpr bool operator<(const ServerCommandEntry & entry, const ConcreteCommandPath & path)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::Off::Id: {
-            Commands::Off::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOnOffClusterOffCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::On::Id: {
-            Commands::On::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOnOffClusterOnCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::Toggle::Id: {
-            Commands::Toggle::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOnOffClusterToggleCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
+    return entry.clusterId < path.mClusterId || (entry.clusterId == path.mClusterId && entry.commandId < path.mCommandId);
 }
 
-} // namespace OnOff
-
-namespace OperationalCredentials {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+// Every server command accepted by this application, sorted by (cluster id, command id) so that
+// DispatchSingleClusterCommand can binary search it.
+constexpr ServerCommandEntry kServerCommands[] = {
+    { Clusters::Identify::Id, Clusters::Identify::Commands::Identify::Id,
+      DecodeAndHandle<Clusters::Identify::Commands::Identify::DecodableType,
+                      emberAfIdentifyClusterIdentifyCallback> },
+    { Clusters::Identify::Id, Clusters::Identify::Commands::TriggerEffect::Id,
+      DecodeAndHandle<Clusters::Identify::Commands::TriggerEffect::DecodableType,
+                      emberAfIdentifyClusterTriggerEffectCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::AddGroup::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::AddGroup::DecodableType,
+                      emberAfGroupsClusterAddGroupCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::ViewGroup::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::ViewGroup::DecodableType,
+                      emberAfGroupsClusterViewGroupCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::GetGroupMembership::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::GetGroupMembership::DecodableType,
+                      emberAfGroupsClusterGetGroupMembershipCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::RemoveGroup::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::RemoveGroup::DecodableType,
+                      emberAfGroupsClusterRemoveGroupCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::RemoveAllGroups::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::RemoveAllGroups::DecodableType,
+                      emberAfGroupsClusterRemoveAllGroupsCallback> },
+    { Clusters::Groups::Id, Clusters::Groups::Commands::AddGroupIfIdentifying::Id,
+      DecodeAndHandle<Clusters::Groups::Commands::AddGroupIfIdentifying::DecodableType,
+                      emberAfGroupsClusterAddGroupIfIdentifyingCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::AddScene::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::AddScene::DecodableType,
+                      emberAfScenesClusterAddSceneCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::ViewScene::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::ViewScene::DecodableType,
+                      emberAfScenesClusterViewSceneCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::RemoveScene::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::RemoveScene::DecodableType,
+                      emberAfScenesClusterRemoveSceneCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::RemoveAllScenes::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::RemoveAllScenes::DecodableType,
+                      emberAfScenesClusterRemoveAllScenesCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::StoreScene::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::StoreScene::DecodableType,
+                      emberAfScenesClusterStoreSceneCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::RecallScene::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::RecallScene::DecodableType,
+                      emberAfScenesClusterRecallSceneCallback> },
+    { Clusters::Scenes::Id, Clusters::Scenes::Commands::GetSceneMembership::Id,
+      DecodeAndHandle<Clusters::Scenes::Commands::GetSceneMembership::DecodableType,
+                      emberAfScenesClusterGetSceneMembershipCallback> },
+    { Clusters::OnOff::Id, Clusters::OnOff::Commands::Off::Id,
+      DecodeAndHandle<Clusters::OnOff::Commands::Off::DecodableType,
+                      emberAfOnOffClusterOffCallback> },
+    { Clusters::OnOff::Id, Clusters::OnOff::Commands::On::Id,
+      DecodeAndHandle<Clusters::OnOff::Commands::On::DecodableType,
+                      emberAfOnOffClusterOnCallback> },
+    { Clusters::OnOff::Id, Clusters::OnOff::Commands::Toggle::Id,
+      DecodeAndHandle<Clusters::OnOff::Commands::Toggle::DecodableType,
+                      emberAfOnOffClusterToggleCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveToLevel::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::MoveToLevel::DecodableType,
+                      emberAfLevelControlClusterMoveToLevelCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Move::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::Move::DecodableType,
+                      emberAfLevelControlClusterMoveCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Step::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::Step::DecodableType,
+                      emberAfLevelControlClusterStepCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::Stop::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::Stop::DecodableType,
+                      emberAfLevelControlClusterStopCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveToLevelWithOnOff::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::MoveToLevelWithOnOff::DecodableType,
+                      emberAfLevelControlClusterMoveToLevelWithOnOffCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::MoveWithOnOff::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::MoveWithOnOff::DecodableType,
+                      emberAfLevelControlClusterMoveWithOnOffCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::StepWithOnOff::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::StepWithOnOff::DecodableType,
+                      emberAfLevelControlClusterStepWithOnOffCallback> },
+    { Clusters::LevelControl::Id, Clusters::LevelControl::Commands::StopWithOnOff::Id,
+      DecodeAndHandle<Clusters::LevelControl::Commands::StopWithOnOff::DecodableType,
+                      emberAfLevelControlClusterStopWithOnOffCallback> },
+    { Clusters::OtaSoftwareUpdateRequestor::Id, Clusters::OtaSoftwareUpdateRequestor::Commands::AnnounceOtaProvider::Id,
+      DecodeAndHandle<Clusters::OtaSoftwareUpdateRequestor::Commands::AnnounceOtaProvider::DecodableType,
+                      emberAfOtaSoftwareUpdateRequestorClusterAnnounceOtaProviderCallback> },
+    { Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::ArmFailSafe::Id,
+      DecodeAndHandle<Clusters::GeneralCommissioning::Commands::ArmFailSafe::DecodableType,
+                      emberAfGeneralCommissioningClusterArmFailSafeCallback> },
+    { Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::SetRegulatoryConfig::Id,
+      DecodeAndHandle<Clusters::GeneralCommissioning::Commands::SetRegulatoryConfig::DecodableType,
+                      emberAfGeneralCommissioningClusterSetRegulatoryConfigCallback> },
+    { Clusters::GeneralCommissioning::Id, Clusters::GeneralCommissioning::Commands::CommissioningComplete::Id,
+      DecodeAndHandle<Clusters::GeneralCommissioning::Commands::CommissioningComplete::DecodableType,
+                      emberAfGeneralCommissioningClusterCommissioningCompleteCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ScanNetworks::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::ScanNetworks::DecodableType,
+                      emberAfNetworkCommissioningClusterScanNetworksCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::AddOrUpdateWiFiNetwork::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::AddOrUpdateWiFiNetwork::DecodableType,
+                      emberAfNetworkCommissioningClusterAddOrUpdateWiFiNetworkCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::AddOrUpdateThreadNetwork::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::AddOrUpdateThreadNetwork::DecodableType,
+                      emberAfNetworkCommissioningClusterAddOrUpdateThreadNetworkCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::RemoveNetwork::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::RemoveNetwork::DecodableType,
+                      emberAfNetworkCommissioningClusterRemoveNetworkCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ConnectNetwork::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::ConnectNetwork::DecodableType,
+                      emberAfNetworkCommissioningClusterConnectNetworkCallback> },
+    { Clusters::NetworkCommissioning::Id, Clusters::NetworkCommissioning::Commands::ReorderNetwork::Id,
+      DecodeAndHandle<Clusters::NetworkCommissioning::Commands::ReorderNetwork::DecodableType,
+                      emberAfNetworkCommissioningClusterReorderNetworkCallback> },
+    { Clusters::DiagnosticLogs::Id, Clusters::DiagnosticLogs::Commands::RetrieveLogsRequest::Id,
+      DecodeAndHandle<Clusters::DiagnosticLogs::Commands::RetrieveLogsRequest::DecodableType,
+                      emberAfDiagnosticLogsClusterRetrieveLogsRequestCallback> },
+    { Clusters::GeneralDiagnostics::Id, Clusters::GeneralDiagnostics::Commands::TestEventTrigger::Id,
+      DecodeAndHandle<Clusters::GeneralDiagnostics::Commands::TestEventTrigger::DecodableType,
+                      emberAfGeneralDiagnosticsClusterTestEventTriggerCallback> },
+    { Clusters::SoftwareDiagnostics::Id, Clusters::SoftwareDiagnostics::Commands::ResetWatermarks::Id,
+      DecodeAndHandle<Clusters::SoftwareDiagnostics::Commands::ResetWatermarks::DecodableType,
+                      emberAfSoftwareDiagnosticsClusterResetWatermarksCallback> },
+    { Clusters::ThreadNetworkDiagnostics::Id, Clusters::ThreadNetworkDiagnostics::Commands::ResetCounts::Id,
+      DecodeAndHandle<Clusters::ThreadNetworkDiagnostics::Commands::ResetCounts::DecodableType,
+                      emberAfThreadNetworkDiagnosticsClusterResetCountsCallback> },
+    { Clusters::WiFiNetworkDiagnostics::Id, Clusters::WiFiNetworkDiagnostics::Commands::ResetCounts::Id,
+      DecodeAndHandle<Clusters::WiFiNetworkDiagnostics::Commands::ResetCounts::DecodableType,
+                      emberAfWiFiNetworkDiagnosticsClusterResetCountsCallback> },
+    { Clusters::EthernetNetworkDiagnostics::Id, Clusters::EthernetNetworkDiagnostics::Commands::ResetCounts::Id,
+      DecodeAndHandle<Clusters::EthernetNetworkDiagnostics::Commands::ResetCounts::DecodableType,
+                      emberAfEthernetNetworkDiagnosticsClusterResetCountsCallback> },
+    { Clusters::AdministratorCommissioning::Id, Clusters::AdministratorCommissioning::Commands::OpenCommissioningWindow::Id,
+      DecodeAndHandle<Clusters::AdministratorCommissioning::Commands::OpenCommissioningWindow::DecodableType,
+                      emberAfAdministratorCommissioningClusterOpenCommissioningWindowCallback> },
+    { Clusters::AdministratorCommissioning::Id, Clusters::AdministratorCommissioning::Commands::OpenBasicCommissioningWindow::Id,
+      DecodeAndHandle<Clusters::AdministratorCommissioning::Commands::OpenBasicCommissioningWindow::DecodableType,
+                      emberAfAdministratorCommissioningClusterOpenBasicCommissioningWindowCallback> },
+    { Clusters::AdministratorCommissioning::Id, Clusters::AdministratorCommissioning::Commands::RevokeCommissioning::Id,
+      DecodeAndHandle<Clusters::AdministratorCommissioning::Commands::RevokeCommissioning::DecodableType,
+                      emberAfAdministratorCommissioningClusterRevokeCommissioningCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::AttestationRequest::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::AttestationRequest::DecodableType,
+                      emberAfOperationalCredentialsClusterAttestationRequestCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::CertificateChainRequest::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::CertificateChainRequest::DecodableType,
+                      emberAfOperationalCredentialsClusterCertificateChainRequestCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::CSRRequest::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::CSRRequest::DecodableType,
+                      emberAfOperationalCredentialsClusterCSRRequestCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::AddNOC::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::AddNOC::DecodableType,
+                      emberAfOperationalCredentialsClusterAddNOCCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::UpdateNOC::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::UpdateNOC::DecodableType,
+                      emberAfOperationalCredentialsClusterUpdateNOCCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::UpdateFabricLabel::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::UpdateFabricLabel::DecodableType,
+                      emberAfOperationalCredentialsClusterUpdateFabricLabelCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::RemoveFabric::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::RemoveFabric::DecodableType,
+                      emberAfOperationalCredentialsClusterRemoveFabricCallback> },
+    { Clusters::OperationalCredentials::Id, Clusters::OperationalCredentials::Commands::AddTrustedRootCertificate::Id,
+      DecodeAndHandle<Clusters::OperationalCredentials::Commands::AddTrustedRootCertificate::DecodableType,
+                      emberAfOperationalCredentialsClusterAddTrustedRootCertificateCallback> },
+    { Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetWrite::Id,
+      DecodeAndHandle<Clusters::GroupKeyManagement::Commands::KeySetWrite::DecodableType,
+                      emberAfGroupKeyManagementClusterKeySetWriteCallback> },
+    { Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetRead::Id,
+      DecodeAndHandle<Clusters::GroupKeyManagement::Commands::KeySetRead::DecodableType,
+                      emberAfGroupKeyManagementClusterKeySetReadCallback> },
+    { Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetRemove::Id,
+      DecodeAndHandle<Clusters::GroupKeyManagement::Commands::KeySetRemove::DecodableType,
+                      emberAfGroupKeyManagementClusterKeySetRemoveCallback> },
+    { Clusters::GroupKeyManagement::Id, Clusters::GroupKeyManagement::Commands::KeySetReadAllIndices::Id,
+      DecodeAndHandle<Clusters::GroupKeyManagement::Commands::KeySetReadAllIndices::DecodableType,
+                      emberAfGroupKeyManagementClusterKeySetReadAllIndicesCallback> },
+};
+
+constexpr bool IsSortedByPath(const ServerCommandEntry * entries, size_t count)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
+    for (size_t i = 1; i < count; i++)
     {
-        switch (aCommandPath.mCommandId)
+        const ServerCommandEntry & prev = entries[i - 1];
+        const ServerCommandEntry & next = entries[i];
+        if (prev.clusterId > next.clusterId || (prev.clusterId == next.clusterId && prev.commandId >= next.commandId))
         {
-        case Commands::AttestationRequest::Id: {
-            Commands::AttestationRequest::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfOperationalCredentialsClusterAttestationRequestCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::CertificateChainRequest::Id: {
-            Commands::CertificateChainRequest::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfOperationalCredentialsClusterCertificateChainRequestCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::CSRRequest::Id: {
-            Commands::CSRRequest::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOperationalCredentialsClusterCSRRequestCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::AddNOC::Id: {
-            Commands::AddNOC::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOperationalCredentialsClusterAddNOCCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::UpdateNOC::Id: {
-            Commands::UpdateNOC::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOperationalCredentialsClusterUpdateNOCCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::UpdateFabricLabel::Id: {
-            Commands::UpdateFabricLabel::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOperationalCredentialsClusterUpdateFabricLabelCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveFabric::Id: {
-            Commands::RemoveFabric::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfOperationalCredentialsClusterRemoveFabricCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::AddTrustedRootCertificate::Id: {
-            Commands::AddTrustedRootCertificate::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled =
-                    emberAfOperationalCredentialsClusterAddTrustedRootCertificateCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
+            return false;
         }
     }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
+    return true;
 }
 
-} // namespace OperationalCredentials
-
-namespace Scenes {
+static_assert(IsSortedByPath(kServerCommands, ArraySize(kServerCommands)),
+              "kServerCommands must be sorted by (cluster id, command id) with no duplicates");
 
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+const ServerCommandEntry * LowerBound(const ConcreteCommandPath & aCommandPath)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::AddScene::Id: {
-            Commands::AddScene::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterAddSceneCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::ViewScene::Id: {
-            Commands::ViewScene::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterViewSceneCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveScene::Id: {
-            Commands::RemoveScene::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterRemoveSceneCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RemoveAllScenes::Id: {
-            Commands::RemoveAllScenes::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterRemoveAllScenesCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::StoreScene::Id: {
-            Commands::StoreScene::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterStoreSceneCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::RecallScene::Id: {
-            Commands::RecallScene::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterRecallSceneCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        case Commands::GetSceneMembership::Id: {
-            Commands::GetSceneMembership::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfScenesClusterGetSceneMembershipCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
+    return std::lower_bound(kServerCommands, kServerCommands + ArraySize(kServerCommands), aCommandPath);
 }
 
-} // namespace Scenes
-
-namespace SoftwareDiagnostics {
+} // namespace
 
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+int FindServerCommandIndex(const ConcreteCommandPath & aCommandPath)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::ResetWatermarks::Id: {
-            Commands::ResetWatermarks::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfSoftwareDiagnosticsClusterResetWatermarksCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
+    const ServerCommandEntry * entry = LowerBound(aCommandPath);
+    if (entry != kServerCommands + ArraySize(kServerCommands) && entry->clusterId == aCommandPath.mClusterId &&
+        entry->commandId == aCommandPath.mCommandId)
     {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
+        return static_cast<int>(entry - kServerCommands);
     }
+    return -1;
 }
 
-} // namespace SoftwareDiagnostics
-
-namespace ThreadNetworkDiagnostics {
-
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
+void DispatchSingleClusterCommand(const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aReader, CommandHandler * apCommandObj)
 {
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
-    {
-        switch (aCommandPath.mCommandId)
-        {
-        case Commands::ResetCounts::Id: {
-            Commands::ResetCounts::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfThreadNetworkDiagnosticsClusterResetCountsCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
-        }
-    }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
-    {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
-    }
-}
-
-} // namespace ThreadNetworkDiagnostics
+    Compatibility::SetupEmberAfCommandHandler(apCommandObj, aCommandPath);
 
-namespace WiFiNetworkDiagnostics {
+    const ServerCommandEntry * begin = kServerCommands;
+    const ServerCommandEntry * end   = kServerCommands + ArraySize(kServerCommands);
+    const ServerCommandEntry * entry = LowerBound(aCommandPath);
 
-void DispatchServerCommand(CommandHandler * apCommandObj, const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aDataTlv)
-{
-    CHIP_ERROR TLVError = CHIP_NO_ERROR;
-    bool wasHandled     = false;
+    if (entry != end && entry->clusterId == aCommandPath.mClusterId && entry->commandId == aCommandPath.mCommandId)
     {
-        switch (aCommandPath.mCommandId)
+        CHIP_ERROR TLVError = CHIP_NO_ERROR;
+        bool wasHandled     = entry->dispatch(apCommandObj, aCommandPath, aReader, TLVError);
+        if (CHIP_NO_ERROR != TLVError || !wasHandled)
         {
-        case Commands::ResetCounts::Id: {
-            Commands::ResetCounts::DecodableType commandData;
-            TLVError = DataModel::Decode(aDataTlv, commandData);
-            if (TLVError == CHIP_NO_ERROR)
-            {
-                wasHandled = emberAfWiFiNetworkDiagnosticsClusterResetCountsCallback(apCommandObj, aCommandPath, commandData);
-            }
-            break;
-        }
-        default: {
-            // Unrecognized command ID, error status will apply.
-            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
-            ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
-                         ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
-            return;
-        }
+            apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
+            ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
         }
     }
-
-    if (CHIP_NO_ERROR != TLVError || !wasHandled)
+    else if ((entry != end && entry->clusterId == aCommandPath.mClusterId) ||
+             (entry != begin && (entry - 1)->clusterId == aCommandPath.mClusterId))
     {
-        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::InvalidCommand);
-        ChipLogProgress(Zcl, "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT, TLVError.Format());
+        // Known cluster, unrecognized command ID.
+        apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCommand);
+        ChipLogError(Zcl, "Unknown command " ChipLogFormatMEI " for cluster " ChipLogFormatMEI,
+                     ChipLogValueMEI(aCommandPath.mCommandId), ChipLogValueMEI(aCommandPath.mClusterId));
     }
-}
-
-} // namespace WiFiNetworkDiagnostics
-
-} // namespace Clusters
-
-void DispatchSingleClusterCommand(const ConcreteCommandPath & aCommandPath, TLV::TLVReader & aReader, CommandHandler * apCommandObj)
-{
-    Compatibility::SetupEmberAfCommandHandler(apCommandObj, aCommandPath);
-
-    switch (aCommandPath.mClusterId)
+    else
     {
-    case Clusters::AdministratorCommissioning::Id:
-        Clusters::AdministratorCommissioning::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::DiagnosticLogs::Id:
-        Clusters::DiagnosticLogs::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::EthernetNetworkDiagnostics::Id:
-        Clusters::EthernetNetworkDiagnostics::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::GeneralCommissioning::Id:
-        Clusters::GeneralCommissioning::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::GeneralDiagnostics::Id:
-        Clusters::GeneralDiagnostics::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::GroupKeyManagement::Id:
-        Clusters::GroupKeyManagement::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::Groups::Id:
-        Clusters::Groups::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::Identify::Id:
-        Clusters::Identify::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::LevelControl::Id:
-        Clusters::LevelControl::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::NetworkCommissioning::Id:
-        Clusters::NetworkCommissioning::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::OtaSoftwareUpdateRequestor::Id:
-        Clusters::OtaSoftwareUpdateRequestor::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::OnOff::Id:
-        Clusters::OnOff::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::OperationalCredentials::Id:
-        Clusters::OperationalCredentials::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::Scenes::Id:
-        Clusters::Scenes::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::SoftwareDiagnostics::Id:
-        Clusters::SoftwareDiagnostics::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::ThreadNetworkDiagnostics::Id:
-        Clusters::ThreadNetworkDiagnostics::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    case Clusters::WiFiNetworkDiagnostics::Id:
-        Clusters::WiFiNetworkDiagnostics::DispatchServerCommand(apCommandObj, aCommandPath, aReader);
-        break;
-    default:
         ChipLogError(Zcl, "Unknown cluster " ChipLogFormatMEI, ChipLogValueMEI(aCommandPath.mClusterId));
         apCommandObj->AddStatus(aCommandPath, Protocols::InteractionModel::Status::UnsupportedCluster);
-        break;
     }
 
     Compatibility::ResetEmberAfObjects();
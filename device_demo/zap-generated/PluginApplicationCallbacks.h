@@ -20,32 +20,69 @@
 #pragma once
 
 #include <app-common/zap-generated/callbacks/PluginCallbacks.h>
+#include <app-common/zap-generated/cluster-id.h>
+#include <lib/core/DataModelTypes.h>
+
+struct MatterPluginInitEntry
+{
+    chip::ClusterId clusterId;
+    const char * name;
+    void (*init)();
+};
+
+// Plugin init callbacks, in the order MATTER_PLUGINS_INIT runs them.
+constexpr MatterPluginInitEntry kMatterPluginInitCallbacks[] = {
+    { ZCL_IDENTIFY_CLUSTER_ID, "IdentifyServer", MatterIdentifyPluginServerInitCallback },
+    { ZCL_GROUPS_CLUSTER_ID, "GroupsServer", MatterGroupsPluginServerInitCallback },
+    { ZCL_SCENES_CLUSTER_ID, "ScenesServer", MatterScenesPluginServerInitCallback },
+    { ZCL_ON_OFF_CLUSTER_ID, "OnOffServer", MatterOnOffPluginServerInitCallback },
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, "LevelControlServer", MatterLevelControlPluginServerInitCallback },
+    { ZCL_DESCRIPTOR_CLUSTER_ID, "DescriptorServer", MatterDescriptorPluginServerInitCallback },
+    { ZCL_BINDING_CLUSTER_ID, "BindingClient", MatterBindingPluginClientInitCallback },
+    { ZCL_ACCESS_CONTROL_CLUSTER_ID, "AccessControlServer", MatterAccessControlPluginServerInitCallback },
+    { ZCL_BASIC_CLUSTER_ID, "BasicServer", MatterBasicPluginServerInitCallback },
+    { ZCL_OTA_PROVIDER_CLUSTER_ID, "OtaSoftwareUpdateProviderClient", MatterOtaSoftwareUpdateProviderPluginClientInitCallback },
+    { ZCL_OTA_REQUESTOR_CLUSTER_ID, "OtaSoftwareUpdateRequestorServer", MatterOtaSoftwareUpdateRequestorPluginServerInitCallback },
+    { ZCL_LOCALIZATION_CONFIGURATION_CLUSTER_ID, "LocalizationConfigurationServer",
+      MatterLocalizationConfigurationPluginServerInitCallback },
+    { ZCL_TIME_FORMAT_LOCALIZATION_CLUSTER_ID, "TimeFormatLocalizationServer",
+      MatterTimeFormatLocalizationPluginServerInitCallback },
+    { ZCL_GENERAL_COMMISSIONING_CLUSTER_ID, "GeneralCommissioningServer", MatterGeneralCommissioningPluginServerInitCallback },
+    { ZCL_NETWORK_COMMISSIONING_CLUSTER_ID, "NetworkCommissioningServer", MatterNetworkCommissioningPluginServerInitCallback },
+    { ZCL_DIAGNOSTIC_LOGS_CLUSTER_ID, "DiagnosticLogsServer", MatterDiagnosticLogsPluginServerInitCallback },
+    { ZCL_GENERAL_DIAGNOSTICS_CLUSTER_ID, "GeneralDiagnosticsServer", MatterGeneralDiagnosticsPluginServerInitCallback },
+    { ZCL_SOFTWARE_DIAGNOSTICS_CLUSTER_ID, "SoftwareDiagnosticsServer", MatterSoftwareDiagnosticsPluginServerInitCallback },
+    { ZCL_THREAD_NETWORK_DIAGNOSTICS_CLUSTER_ID, "ThreadNetworkDiagnosticsServer",
+      MatterThreadNetworkDiagnosticsPluginServerInitCallback },
+    { ZCL_WIFI_NETWORK_DIAGNOSTICS_CLUSTER_ID, "WiFiNetworkDiagnosticsServer",
+      MatterWiFiNetworkDiagnosticsPluginServerInitCallback },
+    { ZCL_ETHERNET_NETWORK_DIAGNOSTICS_CLUSTER_ID, "EthernetNetworkDiagnosticsServer",
+      MatterEthernetNetworkDiagnosticsPluginServerInitCallback },
+    { ZCL_SWITCH_CLUSTER_ID, "SwitchServer", MatterSwitchPluginServerInitCallback },
+    { ZCL_ADMINISTRATOR_COMMISSIONING_CLUSTER_ID, "AdministratorCommissioningServer",
+      MatterAdministratorCommissioningPluginServerInitCallback },
+    { ZCL_OPERATIONAL_CREDENTIALS_CLUSTER_ID, "OperationalCredentialsServer",
+      MatterOperationalCredentialsPluginServerInitCallback },
+    { ZCL_GROUP_KEY_MANAGEMENT_CLUSTER_ID, "GroupKeyManagementServer", MatterGroupKeyManagementPluginServerInitCallback },
+    { ZCL_FIXED_LABEL_CLUSTER_ID, "FixedLabelServer", MatterFixedLabelPluginServerInitCallback },
+    { ZCL_USER_LABEL_CLUSTER_ID, "UserLabelServer", MatterUserLabelPluginServerInitCallback },
+};
+
+// Called around every plugin and cluster init callback. The weak defaults in
+// callback-stub.cpp do nothing; an application can override them to time startup.
+// When a Pre hook returns false, the init callback and its Post hook are skipped;
+// the application then owns running that init callback later.
+bool MatterPrePluginInitCallback(chip::ClusterId clusterId, const char * pluginName);
+void MatterPostPluginInitCallback(chip::ClusterId clusterId, const char * pluginName);
+bool MatterPreClusterInitCallback(chip::EndpointId endpoint, chip::ClusterId clusterId, const char * clusterName);
+void MatterPostClusterInitCallback(chip::EndpointId endpoint, chip::ClusterId clusterId, const char * clusterName);
 
 #define MATTER_PLUGINS_INIT                                                                                                        \
-    MatterIdentifyPluginServerInitCallback();                                                                                      \
-    MatterGroupsPluginServerInitCallback();                                                                                        \
-    MatterScenesPluginServerInitCallback();                                                                                        \
-    MatterOnOffPluginServerInitCallback();                                                                                         \
-    MatterLevelControlPluginServerInitCallback();                                                                                  \
-    MatterDescriptorPluginServerInitCallback();                                                                                    \
-    MatterBindingPluginClientInitCallback();                                                                                       \
-    MatterAccessControlPluginServerInitCallback();                                                                                 \
-    MatterBasicPluginServerInitCallback();                                                                                         \
-    MatterOtaSoftwareUpdateProviderPluginClientInitCallback();                                                                     \
-    MatterOtaSoftwareUpdateRequestorPluginServerInitCallback();                                                                    \
-    MatterLocalizationConfigurationPluginServerInitCallback();                                                                     \
-    MatterTimeFormatLocalizationPluginServerInitCallback();                                                                        \
-    MatterGeneralCommissioningPluginServerInitCallback();                                                                          \
-    MatterNetworkCommissioningPluginServerInitCallback();                                                                          \
-    MatterDiagnosticLogsPluginServerInitCallback();                                                                                \
-    MatterGeneralDiagnosticsPluginServerInitCallback();                                                                            \
-    MatterSoftwareDiagnosticsPluginServerInitCallback();                                                                           \
-    MatterThreadNetworkDiagnosticsPluginServerInitCallback();                                                                      \
-    MatterWiFiNetworkDiagnosticsPluginServerInitCallback();                                                                        \
-    MatterEthernetNetworkDiagnosticsPluginServerInitCallback();                                                                    \
-    MatterSwitchPluginServerInitCallback();                                                                                        \
-    MatterAdministratorCommissioningPluginServerInitCallback();                                                                    \
-    MatterOperationalCredentialsPluginServerInitCallback();                                                                        \
-    MatterGroupKeyManagementPluginServerInitCallback();                                                                            \
-    MatterFixedLabelPluginServerInitCallback();                                                                                    \
-    MatterUserLabelPluginServerInitCallback();
+    for (const MatterPluginInitEntry & pluginInit : kMatterPluginInitCallbacks)                                                    \
+    {                                                                                                                              \
+        if (MatterPrePluginInitCallback(pluginInit.clusterId, pluginInit.name))                                                    \
+        {                                                                                                                          \
+            pluginInit.init();                                                                                                     \
+            MatterPostPluginInitCallback(pluginInit.clusterId, pluginInit.name);                                                   \
+        }                                                                                                                          \
+    }
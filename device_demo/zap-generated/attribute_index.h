@@ -0,0 +1,345 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+// THIS FILE IS GENERATED FROM endpoint_config.h AND MUST BE REGENERATED WITH IT
+
+// Prevent multiple inclusion
+#pragma once
+
+// Prevent changing generated format
+// clang-format off
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Lookup index over GENERATED_CLUSTERS and GENERATED_ATTRIBUTES, so that a
+// concrete attribute path resolves by binary search rather than a linear walk.
+
+// Server clusters of each endpoint type, sorted by cluster id.
+// { clusterId, index within the endpoint type, first attribute index, attribute count }
+#define GENERATED_ATTRIBUTE_INDEX_CLUSTER_COUNT 27
+#define GENERATED_ATTRIBUTE_INDEX_CLUSTERS { \
+  /* Endpoint type: 0 */ \
+  { 0x00000004, 0, 0, 3 }, /* Groups */ \
+  { 0x0000001D, 1, 3, 6 }, /* Descriptor */ \
+  { 0x0000001F, 2, 9, 4 }, /* Access Control */ \
+  { 0x00000028, 3, 13, 21 }, /* Basic */ \
+  { 0x0000002A, 5, 34, 6 }, /* OTA Software Update Requestor */ \
+  { 0x0000002B, 6, 40, 3 }, /* Localization Configuration */ \
+  { 0x0000002C, 7, 43, 5 }, /* Time Format Localization */ \
+  { 0x00000030, 8, 48, 6 }, /* General Commissioning */ \
+  { 0x00000031, 9, 54, 10 }, /* Network Commissioning */ \
+  { 0x00000032, 10, 64, 2 }, /* Diagnostic Logs */ \
+  { 0x00000033, 11, 66, 11 }, /* General Diagnostics */ \
+  { 0x00000034, 12, 77, 6 }, /* Software Diagnostics */ \
+  { 0x00000035, 13, 83, 65 }, /* Thread Network Diagnostics */ \
+  { 0x00000036, 14, 148, 15 }, /* WiFi Network Diagnostics */ \
+  { 0x00000037, 15, 163, 11 }, /* Ethernet Network Diagnostics */ \
+  { 0x0000003B, 16, 174, 2 }, /* Switch */ \
+  { 0x0000003C, 17, 176, 5 }, /* AdministratorCommissioning */ \
+  { 0x0000003E, 18, 181, 8 }, /* Operational Credentials */ \
+  { 0x0000003F, 19, 189, 6 }, /* Group Key Management */ \
+  { 0x00000040, 20, 195, 3 }, /* Fixed Label */ \
+  { 0x00000041, 21, 198, 3 }, /* User Label */ \
+  /* Endpoint type: 1 */ \
+  { 0x00000003, 0, 201, 4 }, /* Identify */ \
+  { 0x00000004, 1, 205, 3 }, /* Groups */ \
+  { 0x00000005, 2, 208, 7 }, /* Scenes */ \
+  { 0x00000006, 3, 215, 7 }, /* On/Off */ \
+  { 0x00000008, 4, 222, 9 }, /* Level Control */ \
+  { 0x0000001D, 5, 231, 6 }, /* Descriptor */ \
+}
+
+// { first cluster, cluster count } in GENERATED_ATTRIBUTE_INDEX_CLUSTERS and
+// size of the attribute storage (as in GENERATED_ENDPOINT_TYPES) for each endpoint type
+#define GENERATED_ATTRIBUTE_INDEX_ENDPOINT_TYPES { \
+  { 0, 21, 215 }, /* Endpoint type: 0 */ \
+  { 21, 6, 61 }, /* Endpoint type: 1 */ \
+}
+
+// Attribute id and offset within the endpoint's attribute storage for each
+// entry of GENERATED_ATTRIBUTES, in the same order. The offset is 0xFFFF for
+// attributes with external or singleton storage.
+#define GENERATED_ATTRIBUTE_INDEX_ATTRIBUTES { \
+  /* Endpoint: 0, Cluster: Groups (server) */ \
+  { 0x00000000, 0 }, /* name support */ \
+  { 0x0000FFFC, 1 }, /* FeatureMap */ \
+  { 0x0000FFFD, 5 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Descriptor (server) */ \
+  { 0x00000000, 0xFFFF }, /* DeviceTypeList */ \
+  { 0x00000001, 0xFFFF }, /* ServerList */ \
+  { 0x00000002, 0xFFFF }, /* ClientList */ \
+  { 0x00000003, 0xFFFF }, /* PartsList */ \
+  { 0x0000FFFC, 7 }, /* FeatureMap */ \
+  { 0x0000FFFD, 0xFFFF }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Access Control (server) */ \
+  { 0x00000000, 0xFFFF }, /* ACL */ \
+  { 0x00000001, 0xFFFF }, /* Extension */ \
+  { 0x0000FFFC, 11 }, /* FeatureMap */ \
+  { 0x0000FFFD, 15 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Basic (server) */ \
+  { 0x00000000, 0xFFFF }, /* DataModelRevision */ \
+  { 0x00000001, 0xFFFF }, /* VendorName */ \
+  { 0x00000002, 0xFFFF }, /* VendorID */ \
+  { 0x00000003, 0xFFFF }, /* ProductName */ \
+  { 0x00000004, 0xFFFF }, /* ProductID */ \
+  { 0x00000005, 0xFFFF }, /* NodeLabel */ \
+  { 0x00000006, 0xFFFF }, /* Location */ \
+  { 0x00000007, 0xFFFF }, /* HardwareVersion */ \
+  { 0x00000008, 0xFFFF }, /* HardwareVersionString */ \
+  { 0x00000009, 0xFFFF }, /* SoftwareVersion */ \
+  { 0x0000000A, 0xFFFF }, /* SoftwareVersionString */ \
+  { 0x0000000B, 0xFFFF }, /* ManufacturingDate */ \
+  { 0x0000000C, 0xFFFF }, /* PartNumber */ \
+  { 0x0000000D, 0xFFFF }, /* ProductURL */ \
+  { 0x0000000E, 0xFFFF }, /* ProductLabel */ \
+  { 0x0000000F, 0xFFFF }, /* SerialNumber */ \
+  { 0x00000010, 0xFFFF }, /* LocalConfigDisabled */ \
+  { 0x00000011, 0xFFFF }, /* Reachable */ \
+  { 0x00000012, 0xFFFF }, /* UniqueID */ \
+  { 0x0000FFFC, 52 }, /* FeatureMap */ \
+  { 0x0000FFFD, 0xFFFF }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: OTA Software Update Requestor (server) */ \
+  { 0x00000000, 0xFFFF }, /* DefaultOtaProviders */ \
+  { 0x00000001, 58 }, /* UpdatePossible */ \
+  { 0x00000002, 59 }, /* UpdateState */ \
+  { 0x00000003, 60 }, /* UpdateStateProgress */ \
+  { 0x0000FFFC, 61 }, /* FeatureMap */ \
+  { 0x0000FFFD, 65 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Localization Configuration (server) */ \
+  { 0x00000001, 0xFFFF }, /* SupportedLocales */ \
+  { 0x0000FFFC, 67 }, /* FeatureMap */ \
+  { 0x0000FFFD, 71 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Time Format Localization (server) */ \
+  { 0x00000000, 73 }, /* HourFormat */ \
+  { 0x00000001, 74 }, /* ActiveCalendarType */ \
+  { 0x00000002, 0xFFFF }, /* SupportedCalendarTypes */ \
+  { 0x0000FFFC, 75 }, /* FeatureMap */ \
+  { 0x0000FFFD, 79 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: General Commissioning (server) */ \
+  { 0x00000000, 81 }, /* Breadcrumb */ \
+  { 0x00000001, 0xFFFF }, /* BasicCommissioningInfo */ \
+  { 0x00000002, 0xFFFF }, /* RegulatoryConfig */ \
+  { 0x00000003, 0xFFFF }, /* LocationCapability */ \
+  { 0x0000FFFC, 89 }, /* FeatureMap */ \
+  { 0x0000FFFD, 93 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Network Commissioning (server) */ \
+  { 0x00000000, 95 }, /* MaxNetworks */ \
+  { 0x00000001, 0xFFFF }, /* Networks */ \
+  { 0x00000002, 96 }, /* ScanMaxTimeSeconds */ \
+  { 0x00000003, 97 }, /* ConnectMaxTimeSeconds */ \
+  { 0x00000004, 98 }, /* InterfaceEnabled */ \
+  { 0x00000005, 99 }, /* LastNetworkingStatus */ \
+  { 0x00000006, 100 }, /* LastNetworkID */ \
+  { 0x00000007, 133 }, /* LastConnectErrorValue */ \
+  { 0x0000FFFC, 137 }, /* FeatureMap */ \
+  { 0x0000FFFD, 141 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Diagnostic Logs (server) */ \
+  { 0x0000FFFC, 143 }, /* FeatureMap */ \
+  { 0x0000FFFD, 147 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: General Diagnostics (server) */ \
+  { 0x00000000, 0xFFFF }, /* NetworkInterfaces */ \
+  { 0x00000001, 0xFFFF }, /* RebootCount */ \
+  { 0x00000002, 0xFFFF }, /* UpTime */ \
+  { 0x00000003, 0xFFFF }, /* TotalOperationalHours */ \
+  { 0x00000004, 0xFFFF }, /* BootReasons */ \
+  { 0x00000005, 0xFFFF }, /* ActiveHardwareFaults */ \
+  { 0x00000006, 0xFFFF }, /* ActiveRadioFaults */ \
+  { 0x00000007, 0xFFFF }, /* ActiveNetworkFaults */ \
+  { 0x00000008, 0xFFFF }, /* TestEventTriggersEnabled */ \
+  { 0x0000FFFC, 149 }, /* FeatureMap */ \
+  { 0x0000FFFD, 153 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Software Diagnostics (server) */ \
+  { 0x00000000, 0xFFFF }, /* ThreadMetrics */ \
+  { 0x00000001, 0xFFFF }, /* CurrentHeapFree */ \
+  { 0x00000002, 0xFFFF }, /* CurrentHeapUsed */ \
+  { 0x00000003, 0xFFFF }, /* CurrentHeapHighWatermark */ \
+  { 0x0000FFFC, 155 }, /* FeatureMap */ \
+  { 0x0000FFFD, 159 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Thread Network Diagnostics (server) */ \
+  { 0x00000000, 0xFFFF }, /* channel */ \
+  { 0x00000001, 0xFFFF }, /* RoutingRole */ \
+  { 0x00000002, 0xFFFF }, /* NetworkName */ \
+  { 0x00000003, 0xFFFF }, /* PanId */ \
+  { 0x00000004, 0xFFFF }, /* ExtendedPanId */ \
+  { 0x00000005, 0xFFFF }, /* MeshLocalPrefix */ \
+  { 0x00000006, 0xFFFF }, /* OverrunCount */ \
+  { 0x00000007, 0xFFFF }, /* NeighborTableList */ \
+  { 0x00000008, 0xFFFF }, /* RouteTableList */ \
+  { 0x00000009, 0xFFFF }, /* PartitionId */ \
+  { 0x0000000A, 0xFFFF }, /* weighting */ \
+  { 0x0000000B, 0xFFFF }, /* DataVersion */ \
+  { 0x0000000C, 0xFFFF }, /* StableDataVersion */ \
+  { 0x0000000D, 0xFFFF }, /* LeaderRouterId */ \
+  { 0x0000000E, 0xFFFF }, /* DetachedRoleCount */ \
+  { 0x0000000F, 0xFFFF }, /* ChildRoleCount */ \
+  { 0x00000010, 0xFFFF }, /* RouterRoleCount */ \
+  { 0x00000011, 0xFFFF }, /* LeaderRoleCount */ \
+  { 0x00000012, 0xFFFF }, /* AttachAttemptCount */ \
+  { 0x00000013, 0xFFFF }, /* PartitionIdChangeCount */ \
+  { 0x00000014, 0xFFFF }, /* BetterPartitionAttachAttemptCount */ \
+  { 0x00000015, 0xFFFF }, /* ParentChangeCount */ \
+  { 0x00000016, 0xFFFF }, /* TxTotalCount */ \
+  { 0x00000017, 0xFFFF }, /* TxUnicastCount */ \
+  { 0x00000018, 0xFFFF }, /* TxBroadcastCount */ \
+  { 0x00000019, 0xFFFF }, /* TxAckRequestedCount */ \
+  { 0x0000001A, 0xFFFF }, /* TxAckedCount */ \
+  { 0x0000001B, 0xFFFF }, /* TxNoAckRequestedCount */ \
+  { 0x0000001C, 0xFFFF }, /* TxDataCount */ \
+  { 0x0000001D, 0xFFFF }, /* TxDataPollCount */ \
+  { 0x0000001E, 0xFFFF }, /* TxBeaconCount */ \
+  { 0x0000001F, 0xFFFF }, /* TxBeaconRequestCount */ \
+  { 0x00000020, 0xFFFF }, /* TxOtherCount */ \
+  { 0x00000021, 0xFFFF }, /* TxRetryCount */ \
+  { 0x00000022, 0xFFFF }, /* TxDirectMaxRetryExpiryCount */ \
+  { 0x00000023, 0xFFFF }, /* TxIndirectMaxRetryExpiryCount */ \
+  { 0x00000024, 0xFFFF }, /* TxErrCcaCount */ \
+  { 0x00000025, 0xFFFF }, /* TxErrAbortCount */ \
+  { 0x00000026, 0xFFFF }, /* TxErrBusyChannelCount */ \
+  { 0x00000027, 0xFFFF }, /* RxTotalCount */ \
+  { 0x00000028, 0xFFFF }, /* RxUnicastCount */ \
+  { 0x00000029, 0xFFFF }, /* RxBroadcastCount */ \
+  { 0x0000002A, 0xFFFF }, /* RxDataCount */ \
+  { 0x0000002B, 0xFFFF }, /* RxDataPollCount */ \
+  { 0x0000002C, 0xFFFF }, /* RxBeaconCount */ \
+  { 0x0000002D, 0xFFFF }, /* RxBeaconRequestCount */ \
+  { 0x0000002E, 0xFFFF }, /* RxOtherCount */ \
+  { 0x0000002F, 0xFFFF }, /* RxAddressFilteredCount */ \
+  { 0x00000030, 0xFFFF }, /* RxDestAddrFilteredCount */ \
+  { 0x00000031, 0xFFFF }, /* RxDuplicatedCount */ \
+  { 0x00000032, 0xFFFF }, /* RxErrNoFrameCount */ \
+  { 0x00000033, 0xFFFF }, /* RxErrUnknownNeighborCount */ \
+  { 0x00000034, 0xFFFF }, /* RxErrInvalidSrcAddrCount */ \
+  { 0x00000035, 0xFFFF }, /* RxErrSecCount */ \
+  { 0x00000036, 0xFFFF }, /* RxErrFcsCount */ \
+  { 0x00000037, 0xFFFF }, /* RxErrOtherCount */ \
+  { 0x00000038, 0xFFFF }, /* ActiveTimestamp */ \
+  { 0x00000039, 0xFFFF }, /* PendingTimestamp */ \
+  { 0x0000003A, 0xFFFF }, /* Delay */ \
+  { 0x0000003B, 0xFFFF }, /* SecurityPolicy */ \
+  { 0x0000003C, 0xFFFF }, /* ChannelPage0Mask */ \
+  { 0x0000003D, 0xFFFF }, /* OperationalDatasetComponents */ \
+  { 0x0000003E, 0xFFFF }, /* ActiveNetworkFaultsList */ \
+  { 0x0000FFFC, 161 }, /* FeatureMap */ \
+  { 0x0000FFFD, 165 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: WiFi Network Diagnostics (server) */ \
+  { 0x00000000, 0xFFFF }, /* bssid */ \
+  { 0x00000001, 0xFFFF }, /* SecurityType */ \
+  { 0x00000002, 0xFFFF }, /* WiFiVersion */ \
+  { 0x00000003, 0xFFFF }, /* ChannelNumber */ \
+  { 0x00000004, 0xFFFF }, /* Rssi */ \
+  { 0x00000005, 0xFFFF }, /* BeaconLostCount */ \
+  { 0x00000006, 0xFFFF }, /* BeaconRxCount */ \
+  { 0x00000007, 0xFFFF }, /* PacketMulticastRxCount */ \
+  { 0x00000008, 0xFFFF }, /* PacketMulticastTxCount */ \
+  { 0x00000009, 0xFFFF }, /* PacketUnicastRxCount */ \
+  { 0x0000000A, 0xFFFF }, /* PacketUnicastTxCount */ \
+  { 0x0000000B, 0xFFFF }, /* CurrentMaxRate */ \
+  { 0x0000000C, 0xFFFF }, /* OverrunCount */ \
+  { 0x0000FFFC, 167 }, /* FeatureMap */ \
+  { 0x0000FFFD, 171 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Ethernet Network Diagnostics (server) */ \
+  { 0x00000000, 0xFFFF }, /* PHYRate */ \
+  { 0x00000001, 0xFFFF }, /* FullDuplex */ \
+  { 0x00000002, 0xFFFF }, /* PacketRxCount */ \
+  { 0x00000003, 0xFFFF }, /* PacketTxCount */ \
+  { 0x00000004, 0xFFFF }, /* TxErrCount */ \
+  { 0x00000005, 0xFFFF }, /* CollisionCount */ \
+  { 0x00000006, 0xFFFF }, /* OverrunCount */ \
+  { 0x00000007, 0xFFFF }, /* CarrierDetect */ \
+  { 0x00000008, 0xFFFF }, /* TimeSinceReset */ \
+  { 0x0000FFFC, 173 }, /* FeatureMap */ \
+  { 0x0000FFFD, 177 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Switch (server) */ \
+  { 0x0000FFFC, 179 }, /* FeatureMap */ \
+  { 0x0000FFFD, 183 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: AdministratorCommissioning (server) */ \
+  { 0x00000000, 0xFFFF }, /* WindowStatus */ \
+  { 0x00000001, 0xFFFF }, /* AdminFabricIndex */ \
+  { 0x00000002, 0xFFFF }, /* AdminVendorId */ \
+  { 0x0000FFFC, 185 }, /* FeatureMap */ \
+  { 0x0000FFFD, 189 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Operational Credentials (server) */ \
+  { 0x00000000, 0xFFFF }, /* NOCs */ \
+  { 0x00000001, 0xFFFF }, /* Fabrics */ \
+  { 0x00000002, 0xFFFF }, /* SupportedFabrics */ \
+  { 0x00000003, 0xFFFF }, /* CommissionedFabrics */ \
+  { 0x00000004, 0xFFFF }, /* TrustedRootCertificates */ \
+  { 0x00000005, 0xFFFF }, /* CurrentFabricIndex */ \
+  { 0x0000FFFC, 191 }, /* FeatureMap */ \
+  { 0x0000FFFD, 195 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Group Key Management (server) */ \
+  { 0x00000000, 0xFFFF }, /* GroupKeyMap */ \
+  { 0x00000001, 0xFFFF }, /* GroupTable */ \
+  { 0x00000002, 0xFFFF }, /* MaxGroupsPerFabric */ \
+  { 0x00000003, 0xFFFF }, /* MaxGroupKeysPerFabric */ \
+  { 0x0000FFFC, 197 }, /* FeatureMap */ \
+  { 0x0000FFFD, 201 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: Fixed Label (server) */ \
+  { 0x00000000, 0xFFFF }, /* label list */ \
+  { 0x0000FFFC, 203 }, /* FeatureMap */ \
+  { 0x0000FFFD, 207 }, /* ClusterRevision */ \
+  /* Endpoint: 0, Cluster: User Label (server) */ \
+  { 0x00000000, 0xFFFF }, /* label list */ \
+  { 0x0000FFFC, 209 }, /* FeatureMap */ \
+  { 0x0000FFFD, 213 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: Identify (server) */ \
+  { 0x00000000, 0 }, /* identify time */ \
+  { 0x00000001, 2 }, /* identify type */ \
+  { 0x0000FFFC, 3 }, /* FeatureMap */ \
+  { 0x0000FFFD, 7 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: Groups (server) */ \
+  { 0x00000000, 9 }, /* name support */ \
+  { 0x0000FFFC, 10 }, /* FeatureMap */ \
+  { 0x0000FFFD, 14 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: Scenes (server) */ \
+  { 0x00000000, 16 }, /* SceneCount */ \
+  { 0x00000001, 17 }, /* CurrentScene */ \
+  { 0x00000002, 18 }, /* CurrentGroup */ \
+  { 0x00000003, 20 }, /* SceneValid */ \
+  { 0x00000004, 21 }, /* NameSupport */ \
+  { 0x0000FFFC, 22 }, /* FeatureMap */ \
+  { 0x0000FFFD, 26 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: On/Off (server) */ \
+  { 0x00000000, 28 }, /* OnOff */ \
+  { 0x00004000, 29 }, /* GlobalSceneControl */ \
+  { 0x00004001, 30 }, /* OnTime */ \
+  { 0x00004002, 32 }, /* OffWaitTime */ \
+  { 0x00004003, 34 }, /* StartUpOnOff */ \
+  { 0x0000FFFC, 35 }, /* FeatureMap */ \
+  { 0x0000FFFD, 39 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: Level Control (server) */ \
+  { 0x00000000, 41 }, /* CurrentLevel */ \
+  { 0x00000001, 42 }, /* RemainingTime */ \
+  { 0x00000002, 44 }, /* MinLevel */ \
+  { 0x00000003, 45 }, /* MaxLevel */ \
+  { 0x0000000F, 46 }, /* Options */ \
+  { 0x00000011, 47 }, /* OnLevel */ \
+  { 0x00004000, 48 }, /* StartUpCurrentLevel */ \
+  { 0x0000FFFC, 49 }, /* FeatureMap */ \
+  { 0x0000FFFD, 53 }, /* ClusterRevision */ \
+  /* Endpoint: 1, Cluster: Descriptor (server) */ \
+  { 0x00000000, 0xFFFF }, /* DeviceTypeList */ \
+  { 0x00000001, 0xFFFF }, /* ServerList */ \
+  { 0x00000002, 0xFFFF }, /* ClientList */ \
+  { 0x00000003, 0xFFFF }, /* PartsList */ \
+  { 0x0000FFFC, 55 }, /* FeatureMap */ \
+  { 0x0000FFFD, 59 }, /* ClusterRevision */ \
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// clang-format on
@@ -17,103 +17,123 @@
 
 // THIS FILE IS GENERATED BY ZAP
 
+#include <algorithm>
+
 #include <app-common/zap-generated/callback.h>
 #include <app-common/zap-generated/cluster-id.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/Span.h>
 #include <protocols/interaction_model/Constants.h>
+#include <zap-generated/PluginApplicationCallbacks.h>
 
 using namespace chip;
 
+namespace {
+
+struct ClusterInitEntry
+{
+    ClusterId clusterId;
+    void (*init)(EndpointId endpoint);
+    const char * name;
+};
+
+// Sorted by cluster id.
+constexpr ClusterInitEntry kClusterInitCallbacks[] = {
+    { ZCL_IDENTIFY_CLUSTER_ID, emberAfIdentifyClusterInitCallback, "Identify" },
+    { ZCL_GROUPS_CLUSTER_ID, emberAfGroupsClusterInitCallback, "Groups" },
+    { ZCL_SCENES_CLUSTER_ID, emberAfScenesClusterInitCallback, "Scenes" },
+    { ZCL_ON_OFF_CLUSTER_ID, emberAfOnOffClusterInitCallback, "OnOff" },
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, emberAfLevelControlClusterInitCallback, "LevelControl" },
+    { ZCL_DESCRIPTOR_CLUSTER_ID, emberAfDescriptorClusterInitCallback, "Descriptor" },
+    { ZCL_BINDING_CLUSTER_ID, emberAfBindingClusterInitCallback, "Binding" },
+    { ZCL_ACCESS_CONTROL_CLUSTER_ID, emberAfAccessControlClusterInitCallback, "AccessControl" },
+    { ZCL_BASIC_CLUSTER_ID, emberAfBasicClusterInitCallback, "Basic" },
+    { ZCL_OTA_PROVIDER_CLUSTER_ID, emberAfOtaSoftwareUpdateProviderClusterInitCallback, "OtaSoftwareUpdateProvider" },
+    { ZCL_OTA_REQUESTOR_CLUSTER_ID, emberAfOtaSoftwareUpdateRequestorClusterInitCallback, "OtaSoftwareUpdateRequestor" },
+    { ZCL_LOCALIZATION_CONFIGURATION_CLUSTER_ID, emberAfLocalizationConfigurationClusterInitCallback, "LocalizationConfiguration" },
+    { ZCL_TIME_FORMAT_LOCALIZATION_CLUSTER_ID, emberAfTimeFormatLocalizationClusterInitCallback, "TimeFormatLocalization" },
+    { ZCL_GENERAL_COMMISSIONING_CLUSTER_ID, emberAfGeneralCommissioningClusterInitCallback, "GeneralCommissioning" },
+    { ZCL_NETWORK_COMMISSIONING_CLUSTER_ID, emberAfNetworkCommissioningClusterInitCallback, "NetworkCommissioning" },
+    { ZCL_DIAGNOSTIC_LOGS_CLUSTER_ID, emberAfDiagnosticLogsClusterInitCallback, "DiagnosticLogs" },
+    { ZCL_GENERAL_DIAGNOSTICS_CLUSTER_ID, emberAfGeneralDiagnosticsClusterInitCallback, "GeneralDiagnostics" },
+    { ZCL_SOFTWARE_DIAGNOSTICS_CLUSTER_ID, emberAfSoftwareDiagnosticsClusterInitCallback, "SoftwareDiagnostics" },
+    { ZCL_THREAD_NETWORK_DIAGNOSTICS_CLUSTER_ID, emberAfThreadNetworkDiagnosticsClusterInitCallback, "ThreadNetworkDiagnostics" },
+    { ZCL_WIFI_NETWORK_DIAGNOSTICS_CLUSTER_ID, emberAfWiFiNetworkDiagnosticsClusterInitCallback, "WiFiNetworkDiagnostics" },
+    { ZCL_ETHERNET_NETWORK_DIAGNOSTICS_CLUSTER_ID, emberAfEthernetNetworkDiagnosticsClusterInitCallback,
+      "EthernetNetworkDiagnostics" },
+    { ZCL_SWITCH_CLUSTER_ID, emberAfSwitchClusterInitCallback, "Switch" },
+    { ZCL_ADMINISTRATOR_COMMISSIONING_CLUSTER_ID, emberAfAdministratorCommissioningClusterInitCallback,
+      "AdministratorCommissioning" },
+    { ZCL_OPERATIONAL_CREDENTIALS_CLUSTER_ID, emberAfOperationalCredentialsClusterInitCallback, "OperationalCredentials" },
+    { ZCL_GROUP_KEY_MANAGEMENT_CLUSTER_ID, emberAfGroupKeyManagementClusterInitCallback, "GroupKeyManagement" },
+    { ZCL_FIXED_LABEL_CLUSTER_ID, emberAfFixedLabelClusterInitCallback, "FixedLabel" },
+    { ZCL_USER_LABEL_CLUSTER_ID, emberAfUserLabelClusterInitCallback, "UserLabel" },
+};
+
+constexpr bool ClusterInitCallbacksSorted()
+{
+    for (size_t i = 1; i < ArraySize(kClusterInitCallbacks); i++)
+    {
+        if (kClusterInitCallbacks[i - 1].clusterId >= kClusterInitCallbacks[i].clusterId)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(ClusterInitCallbacksSorted(), "kClusterInitCallbacks must be sorted by cluster id");
+
+} // namespace
+
 // Cluster Init Functions
 void emberAfClusterInitCallback(EndpointId endpoint, ClusterId clusterId)
 {
-    switch (clusterId)
+    const ClusterInitEntry * end   = kClusterInitCallbacks + ArraySize(kClusterInitCallbacks);
+    const ClusterInitEntry * entry =
+        std::lower_bound(kClusterInitCallbacks, end, clusterId,
+                         [](const ClusterInitEntry & item, ClusterId id) { return item.clusterId < id; });
+    if (entry == end || entry->clusterId != clusterId)
     {
-    case ZCL_ACCESS_CONTROL_CLUSTER_ID:
-        emberAfAccessControlClusterInitCallback(endpoint);
-        break;
-    case ZCL_ADMINISTRATOR_COMMISSIONING_CLUSTER_ID:
-        emberAfAdministratorCommissioningClusterInitCallback(endpoint);
-        break;
-    case ZCL_BASIC_CLUSTER_ID:
-        emberAfBasicClusterInitCallback(endpoint);
-        break;
-    case ZCL_BINDING_CLUSTER_ID:
-        emberAfBindingClusterInitCallback(endpoint);
-        break;
-    case ZCL_DESCRIPTOR_CLUSTER_ID:
-        emberAfDescriptorClusterInitCallback(endpoint);
-        break;
-    case ZCL_DIAGNOSTIC_LOGS_CLUSTER_ID:
-        emberAfDiagnosticLogsClusterInitCallback(endpoint);
-        break;
-    case ZCL_ETHERNET_NETWORK_DIAGNOSTICS_CLUSTER_ID:
-        emberAfEthernetNetworkDiagnosticsClusterInitCallback(endpoint);
-        break;
-    case ZCL_FIXED_LABEL_CLUSTER_ID:
-        emberAfFixedLabelClusterInitCallback(endpoint);
-        break;
-    case ZCL_GENERAL_COMMISSIONING_CLUSTER_ID:
-        emberAfGeneralCommissioningClusterInitCallback(endpoint);
-        break;
-    case ZCL_GENERAL_DIAGNOSTICS_CLUSTER_ID:
-        emberAfGeneralDiagnosticsClusterInitCallback(endpoint);
-        break;
-    case ZCL_GROUP_KEY_MANAGEMENT_CLUSTER_ID:
-        emberAfGroupKeyManagementClusterInitCallback(endpoint);
-        break;
-    case ZCL_GROUPS_CLUSTER_ID:
-        emberAfGroupsClusterInitCallback(endpoint);
-        break;
-    case ZCL_IDENTIFY_CLUSTER_ID:
-        emberAfIdentifyClusterInitCallback(endpoint);
-        break;
-    case ZCL_LEVEL_CONTROL_CLUSTER_ID:
-        emberAfLevelControlClusterInitCallback(endpoint);
-        break;
-    case ZCL_LOCALIZATION_CONFIGURATION_CLUSTER_ID:
-        emberAfLocalizationConfigurationClusterInitCallback(endpoint);
-        break;
-    case ZCL_NETWORK_COMMISSIONING_CLUSTER_ID:
-        emberAfNetworkCommissioningClusterInitCallback(endpoint);
-        break;
-    case ZCL_OTA_PROVIDER_CLUSTER_ID:
-        emberAfOtaSoftwareUpdateProviderClusterInitCallback(endpoint);
-        break;
-    case ZCL_OTA_REQUESTOR_CLUSTER_ID:
-        emberAfOtaSoftwareUpdateRequestorClusterInitCallback(endpoint);
-        break;
-    case ZCL_ON_OFF_CLUSTER_ID:
-        emberAfOnOffClusterInitCallback(endpoint);
-        break;
-    case ZCL_OPERATIONAL_CREDENTIALS_CLUSTER_ID:
-        emberAfOperationalCredentialsClusterInitCallback(endpoint);
-        break;
-    case ZCL_SCENES_CLUSTER_ID:
-        emberAfScenesClusterInitCallback(endpoint);
-        break;
-    case ZCL_SOFTWARE_DIAGNOSTICS_CLUSTER_ID:
-        emberAfSoftwareDiagnosticsClusterInitCallback(endpoint);
-        break;
-    case ZCL_SWITCH_CLUSTER_ID:
-        emberAfSwitchClusterInitCallback(endpoint);
-        break;
-    case ZCL_THREAD_NETWORK_DIAGNOSTICS_CLUSTER_ID:
-        emberAfThreadNetworkDiagnosticsClusterInitCallback(endpoint);
-        break;
-    case ZCL_TIME_FORMAT_LOCALIZATION_CLUSTER_ID:
-        emberAfTimeFormatLocalizationClusterInitCallback(endpoint);
-        break;
-    case ZCL_USER_LABEL_CLUSTER_ID:
-        emberAfUserLabelClusterInitCallback(endpoint);
-        break;
-    case ZCL_WIFI_NETWORK_DIAGNOSTICS_CLUSTER_ID:
-        emberAfWiFiNetworkDiagnosticsClusterInitCallback(endpoint);
-        break;
-    default:
         // Unrecognized cluster ID
-        break;
+        return;
     }
+
+    if (!MatterPreClusterInitCallback(endpoint, clusterId, entry->name))
+    {
+        return;
+    }
+    entry->init(endpoint);
+    MatterPostClusterInitCallback(endpoint, clusterId, entry->name);
+}
+
+bool __attribute__((weak)) MatterPreClusterInitCallback(EndpointId endpoint, ClusterId clusterId, const char * clusterName)
+{
+    // To prevent warning
+    (void) endpoint;
+    (void) clusterId;
+    (void) clusterName;
+    return true;
+}
+void __attribute__((weak)) MatterPostClusterInitCallback(EndpointId endpoint, ClusterId clusterId, const char * clusterName)
+{
+    // To prevent warning
+    (void) endpoint;
+    (void) clusterId;
+    (void) clusterName;
+}
+bool __attribute__((weak)) MatterPrePluginInitCallback(ClusterId clusterId, const char * pluginName)
+{
+    // To prevent warning
+    (void) clusterId;
+    (void) pluginName;
+    return true;
+}
+void __attribute__((weak)) MatterPostPluginInitCallback(ClusterId clusterId, const char * pluginName)
+{
+    // To prevent warning
+    (void) clusterId;
+    (void) pluginName;
 }
 
 void __attribute__((weak)) emberAfAccessControlClusterInitCallback(EndpointId endpoint)